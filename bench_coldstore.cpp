@@ -0,0 +1,83 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include "linestore.h"
+
+using namespace std;
+
+// Benchmark cold storage: log 2 juta baris (~150 MB) dimuat ke LineStore,
+// lalu blok dingin dikompres LZ. Dibandingkan memori sebelum/sesudah
+// (seluruh store dan isi blok saja) dan latensi satu "frame" (baca 40 baris
+// viewport + trimHot) saat scroll berurutan per halaman dan saat lompat acak
+// ke mana saja di file.
+
+const size_t LINES = 2000000;
+const size_t VIEWPORT = 40;
+
+using Clock = chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Satu frame: baca baris [first, first + VIEWPORT) lalu titik aman trimHot
+double frame(LineStore& lines, size_t first, size_t& sink) {
+    auto start = Clock::now();
+    for (size_t i = first; i < min(first + VIEWPORT, lines.size()); ++i)
+        sink += lines[i].size();
+    lines.trimHot();
+    return msSince(start);
+}
+
+void report(const char* name, vector<double>& ms) {
+    sort(ms.begin(), ms.end());
+    double sum = 0;
+    for (double v : ms) sum += v;
+    cout << "  " << name << ": rata-rata " << sum / ms.size() * 1000 << " us, p99 "
+         << ms[ms.size() * 99 / 100] * 1000 << " us, maks " << ms.back() * 1000 << " us\n";
+}
+
+int main() {
+    static const char* levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    PagePool pool;
+    LineStore lines(&pool);
+    lines.internLines = false; // baris unik: sama seperti dokumen besar setelah enableColdStorage()
+    for (size_t i = 0; i < LINES; ++i)
+        lines.push_back("2024-05-01 12:" + to_string(i / 60 % 60) + ":" + to_string(i % 60) + " [" +
+                        levels[i % 4] + "] worker " + to_string(i % 37) + " request " + to_string(i * 7919) +
+                        " done in " + to_string(i % 500) + "ms");
+    size_t content = lines.contentBytes();
+    size_t before = lines.memoryBytes();
+
+    lines.enableColdStorage();
+    auto start = Clock::now();
+    size_t batches = 0;
+    while (lines.trimHot()) batches++;
+    lines.trimHot();
+    double packMs = msSince(start);
+    size_t after = lines.memoryBytes();
+
+    size_t sink = 0;
+    vector<double> scroll, jump;
+    for (size_t first = 0; first < lines.size(); first += VIEWPORT * 50)
+        for (size_t page = 0; page < 50 && first + page * VIEWPORT < lines.size(); page += 10)
+            scroll.push_back(frame(lines, first + page * VIEWPORT, sink));
+    mt19937 rng(1);
+    for (size_t k = 0; k < 5000; ++k)
+        jump.push_back(frame(lines, rng() % lines.size(), sink));
+
+    cout << "log " << LINES << " baris, isi " << content / (1 << 20) << " MB\n";
+    cout << "  tanpa kompresi: " << before / (1 << 20) << " MB\n";
+    cout << "  cold storage  : " << after / (1 << 20) << " MB (" << (double)before / after << "x lebih kecil), "
+         << lines.coldBlocks() << " blok dingin, kompres " << packMs << " ms dalam " << batches + 1
+         << " batch (" << packMs / (batches + 1) << " ms/batch)\n";
+    cout << "  isi blok      : " << lines.packableBytes() / (1 << 20) << " MB -> " << lines.packedBytes() / (1 << 20)
+         << " MB (" << (double)lines.packableBytes() / lines.packedBytes() << "x)\n";
+    report("scroll per halaman", scroll);
+    report("lompat acak      ", jump);
+    if (sink == 42) cout << "";
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include "collab.h"
+
+using namespace std;
+
+// Benchmark edit kolaboratif: satu server dan dua klien dalam satu proses,
+// satu EventLoop, tersambung lewat Unix socket sungguhan. Ketiganya mengetik
+// bersamaan di posisi acak (sisip, Enter, Backspace, pindah baris) selama
+// beberapa ribu frame. Yang diukur: berapa pesan dan byte yang dikirim
+// dibanding jumlah tombol (edit digabung per frame), lama satu frame, dan
+// apakah ketiga dokumen akhirnya sama persis.
+
+const size_t LINES = 20000;
+const int FRAMES = 3000;
+const int KEYS_PER_FRAME = 4; // per editor, ~240 tombol/detik pada 60 fps
+const char* PATH = "/tmp/bench_collab.txt";
+const char* SOCKET = "/tmp/bench_collab.sock";
+
+using Clock = chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+void typeRandomly(Document& doc, mt19937& rng) {
+    for (int k = 0; k < KEYS_PER_FRAME; ++k) {
+        unsigned r = rng() % 100;
+        if (r < 3)
+            doc.moveTo(rng() % doc.lines.size());
+        else if (r < 6)
+            doc.applyOp(J_NEWLINE, "");
+        else if (r < 14)
+            doc.applyOp(J_BACKSPACE, "");
+        else
+            doc.applyOp(J_INSERT, string(1, "etaoin shrdlu"[rng() % 13]));
+    }
+}
+
+int main() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    {
+        string text;
+        for (size_t i = 0; i < LINES; ++i)
+            text += "baris " + to_string(i) + " berisi teks contoh untuk diedit bersama\n";
+        Document seed(PATH, &pool, &swap, &log);
+        seed.insertText(text);
+        seed.save();
+    }
+
+    EventLoop loop;
+    Document host(PATH, &pool, &swap, &log);
+    host.start(true);
+    CollabServer server(host, loop);
+    if (!server.listen(SOCKET)) {
+        cerr << "Tidak bisa listen di " << SOCKET << endl;
+        return 1;
+    }
+
+    vector<unique_ptr<Document>> docs;
+    vector<unique_ptr<CollabClient>> clients;
+    loop.afterEvents = [&] {
+        server.flush();
+        for (auto& client : clients)
+            client->flush();
+    };
+    for (int i = 0; i < 2; ++i) {
+        clients.emplace_back(new CollabClient(loop));
+        if (!clients.back()->connect(SOCKET)) {
+            cerr << "Tidak bisa connect" << endl;
+            return 1;
+        }
+        // Server di loop yang sama harus terus jalan selama HELLO (teks
+        // lengkap) dikirim sedikit demi sedikit
+        while (!clients.back()->handshake(false) && clients.back()->connected())
+            loop.poll(10);
+        if (!clients.back()->connected()) {
+            cerr << "Handshake gagal" << endl;
+            return 1;
+        }
+        docs.emplace_back(new Document(clients.back()->documentName(), &pool, &swap, &log));
+        docs.back()->shared = true;
+        clients.back()->attach(*docs.back());
+    }
+
+    vector<Document*> editors = {&host, docs[0].get(), docs[1].get()};
+    mt19937 rng(42);
+    size_t keys = 0;
+    double worstFrame = 0;
+    auto start = Clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        auto frameStart = Clock::now();
+        for (Document* doc : editors) {
+            typeRandomly(*doc, rng);
+            keys += KEYS_PER_FRAME;
+        }
+        loop.afterEvents(); // akhir frame: kirim edit
+        while (loop.poll(0) > 0) {}
+        worstFrame = max(worstFrame, msSince(frameStart));
+    }
+    double totalMs = msSince(start);
+
+    // Tunggu semua ack dan siaran terakhir
+    for (int i = 0; i < 1000; ++i) {
+        loop.afterEvents();
+        bool idle = loop.poll(5) == 0;
+        for (auto& client : clients)
+            idle = idle && client->idle();
+        if (idle) break;
+    }
+
+    host.commitCurrentLine();
+    string expected = collabDocumentText(host);
+    bool converged = true;
+    for (auto& doc : docs) {
+        doc->commitCurrentLine();
+        converged = converged && collabDocumentText(*doc) == expected;
+    }
+
+    uint64_t messages = server.messagesSent(), bytes = server.bytesSent();
+    for (auto& client : clients) {
+        messages += client->messagesSent();
+        bytes += client->bytesSent();
+    }
+    cout << "Frame: " << FRAMES << ", tombol: " << keys << " (3 editor)" << endl;
+    cout << "Revisi server: " << server.revision() << endl;
+    cout << "Pesan terkirim: " << messages << " (" << bytes / 1024 << " KiB), "
+         << (double)messages / keys << " pesan per tombol" << endl;
+    cout << "Rata-rata frame: " << totalMs / FRAMES << " ms, terlama: " << worstFrame << " ms" << endl;
+    cout << "Dokumen: " << host.lines.size() << " baris, " << (converged ? "sama di semua editor" : "BERBEDA") << endl;
+
+    host.finish();
+    remove(PATH);
+    return converged ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include "crdt.h"
+
+using namespace std;
+
+// Benchmark buffer CRDT dibanding vector<string> lines biasa.
+//
+// 1. Sesi mengetik: ratusan ribu tombol di satu replika (sebagian besar
+//    berurutan, kadang lompat ke posisi acak atau Backspace). Diukur memori
+//    per byte teks dan jumlah Item (run-length: satu run per ketikan
+//    berurutan, bukan per karakter).
+// 2. Replika lain menerima seluruh riwayat itu (merge dari kosong).
+// 3. Dua replika mengedit bersamaan di posisi acak lalu bertukar op. Waktu
+//    merge dibandingkan dengan menerapkan perubahan teks yang sama ke
+//    vector<string> lines, dan kedua replika harus sama persis.
+
+const size_t SESSION_KEYS = 300000;
+const size_t CONCURRENT_KEYS = 20000;
+
+using Clock = chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Penyimpanan lama: satu string per baris
+struct LineBuffer {
+    vector<string> lines{""};
+    size_t cachedLine = 0;   // baris terakhir yang dicari dan offset awalnya,
+    uint64_t cachedStart = 0; // supaya edit berdekatan tidak memindai dari awal
+
+    explicit LineBuffer(const string& text) {
+        lines.clear();
+        size_t start = 0, nl;
+        while ((nl = text.find('\n', start)) != string::npos) {
+            lines.push_back(text.substr(start, nl - start));
+            start = nl + 1;
+        }
+        lines.push_back(text.substr(start));
+    }
+
+    size_t locate(uint64_t& pos) {
+        while (cachedLine > 0 && cachedStart > pos)
+            cachedStart -= lines[--cachedLine].size() + 1;
+        while (cachedLine + 1 < lines.size() && pos > cachedStart + lines[cachedLine].size())
+            cachedStart += lines[cachedLine++].size() + 1;
+        pos -= cachedStart;
+        return cachedLine;
+    }
+
+    void apply(const TextEdit& e) {
+        uint64_t col = e.pos;
+        size_t line = locate(col);
+        if (e.insert) {
+            string tail = lines[line].substr(col);
+            lines[line].resize(col);
+            size_t start = 0, nl;
+            size_t at = line;
+            while ((nl = e.text.find('\n', start)) != string::npos) {
+                lines[at] += e.text.substr(start, nl - start);
+                lines.insert(lines.begin() + ++at, string());
+                start = nl + 1;
+            }
+            lines[at] += e.text.substr(start);
+            lines[at] += tail;
+        } else {
+            uint64_t endCol = e.pos + e.len;
+            size_t last = locate(endCol);
+            locate(col = e.pos); // cache kembali ke baris awal
+            lines[line] = lines[line].substr(0, col) + lines[last].substr(endCol);
+            lines.erase(lines.begin() + line + 1, lines.begin() + last + 1);
+        }
+    }
+
+    string text() const {
+        string out;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            if (i) out += '\n';
+            out += lines[i];
+        }
+        return out;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = lines.capacity() * sizeof(string);
+        for (const string& line : lines)
+            bytes += line.capacity() > 15 ? line.capacity() + 1 + 16 : 0; // di bawah itu masuk SSO
+        return bytes;
+    }
+};
+
+// Satu penyunting: mengetik kata per karakter di kursor, kadang lompat
+// atau menghapus
+struct Typist {
+    mt19937 rng;
+    size_t cursor = 0;
+    size_t wordsOnLine = 0;
+
+    explicit Typist(unsigned seed) : rng(seed) {}
+
+    void key(CrdtText& doc, vector<CrdtOp>& out, unsigned jumpPercent) {
+        static const char* words[] = {"data", "struktur", "editor", "baris", "teks", "node", "kursor", "simpan"};
+        unsigned r = rng() % 100;
+        if (r < jumpPercent || cursor > doc.size()) {
+            cursor = doc.size() ? rng() % (doc.size() + 1) : 0;
+        } else if (r < jumpPercent + 6 && cursor > 0) {
+            doc.remove(--cursor, 1, out); // Backspace
+        } else {
+            const char* word = words[rng() % 8];
+            string piece = rng() % 6 ? string(1, word[rng() % 4]) : string(++wordsOnLine % 8 ? " " : "\n");
+            doc.insert(cursor, piece, out);
+            cursor += piece.size();
+        }
+    }
+};
+
+int main() {
+    CrdtText a(1), b(2);
+    vector<CrdtOp> history;
+    Typist writer(1);
+    auto start = Clock::now();
+    for (size_t k = 0; k < SESSION_KEYS; ++k)
+        writer.key(a, history, 2);
+    double typeMs = msSince(start);
+    string wire;
+    encodeCrdtOps(wire, history);
+
+    LineBuffer plain(a.text());
+    cout << "Sesi mengetik: " << SESSION_KEYS << " tombol dalam " << typeMs << " ms, teks "
+         << a.size() << " byte, " << plain.lines.size() << " baris" << endl;
+    cout << "  CRDT: " << a.itemCount() << " item (" << (double)a.size() / a.itemCount() << " byte/item), "
+         << (double)a.memoryBytes() / a.size() << " byte memori per byte teks" << endl;
+    a.compact();
+    cout << "  CRDT setelah compact: " << a.itemCount() << " item, "
+         << (double)a.memoryBytes() / a.size() << " byte memori per byte teks" << endl;
+    cout << "  vector<string> lines: " << (double)plain.memoryBytes() / a.size() << " byte memori per byte teks" << endl;
+    cout << "  Riwayat: " << history.size() << " op, " << wire.size() << " byte ter-encode" << endl;
+
+    start = Clock::now();
+    b.merge(history);
+    double replayMs = msSince(start);
+    cout << "Merge seluruh riwayat ke replika kosong: " << replayMs << " ms ("
+         << history.size() / replayMs * 1000 << " op/detik)" << endl;
+
+    // Edit bersamaan, lalu tukar op
+    vector<CrdtOp> fromA, fromB;
+    Typist alice(2), bob(3);
+    for (size_t k = 0; k < CONCURRENT_KEYS; ++k) {
+        alice.key(a, fromA, 20);
+        bob.key(b, fromB, 20);
+    }
+    LineBuffer plainA(a.text());
+    EditOp editsA, editsB;
+    start = Clock::now();
+    a.merge(fromB, &editsA);
+    double mergeA = msSince(start);
+    start = Clock::now();
+    b.merge(fromA, &editsB);
+    double mergeB = msSince(start);
+    start = Clock::now();
+    for (const TextEdit& e : editsA)
+        plainA.apply(e);
+    double plainMs = msSince(start);
+
+    bool converged = a.text() == b.text() && plainA.text() == a.text();
+    size_t ops = fromA.size() + fromB.size();
+    cout << "Edit bersamaan: " << CONCURRENT_KEYS << " tombol per replika, " << ops << " op" << endl;
+    cout << "  Merge CRDT: " << mergeA + mergeB << " ms (" << ops / (mergeA + mergeB) * 1000 << " op/detik)" << endl;
+    cout << "  Perubahan yang sama ke vector<string> lines: " << plainMs << " ms untuk " << editsA.size()
+         << " edit (tanpa resolusi konflik)" << endl;
+    cout << "  Tombstone GC: " << a.itemCount() << " item, compact -> ";
+    a.compact();
+    cout << a.itemCount() << " item" << endl;
+    cout << "Replika " << (converged ? "sama" : "BERBEDA") << ", op tertunda: " << a.pendingOps() + b.pendingOps() << endl;
+    return converged ? 0 : 1;
+}
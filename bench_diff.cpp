@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "document.h"
+
+using namespace std;
+
+// Benchmark diff buffer terhadap file tersimpan: dokumen 1 juta baris,
+// ribuan suntingan tersebar (ubah, sisip, hapus baris). Diff pertama harus
+// membaca dan meng-hash file serta semua baris buffer; diff berikutnya
+// memakai hash yang di-cache, jadi yang tersisa hanya Myers-nya.
+
+const size_t LINES = 1000000;
+const size_t EDITS = 3000;
+const char* PATH = "/tmp/bench_diff.log";
+
+using Clock = chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+double timedDiff(Document& doc, size_t& hunks) {
+    auto start = Clock::now();
+    hunks = doc.diffWithSaved().size();
+    return msSince(start);
+}
+
+int main() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    {
+        string text;
+        for (size_t i = 0; i < LINES; ++i)
+            text += "2024-05-01 12:00:00 [INFO] worker " + to_string(i % 37) + " request " + to_string(i) + " ok\n";
+        Document seed(PATH, &pool, &swap, &log);
+        seed.insertText(text);
+        seed.save();
+    }
+
+    Document doc(PATH, &pool, &swap, &log);
+    doc.start(true);
+    auto start = Clock::now();
+    for (size_t k = 0; k < EDITS; ++k) {
+        doc.moveTo((k * 7919 * 131) % (LINES - 1));
+        switch (k % 3) {
+        case 0: doc.applyOp(J_INSERT, "x"); break;
+        case 1: doc.applyOp(J_NEWLINE, ""); break;
+        case 2: doc.applyOp(J_DELETE_LINE, ""); break;
+        }
+    }
+    double editMs = msSince(start);
+
+    size_t hunks = 0;
+    double first = timedDiff(doc, hunks);
+    double again = timedDiff(doc, hunks);
+    doc.moveTo(LINES / 2);
+    doc.applyOp(J_INSERT, "y");
+    double afterEdit = timedDiff(doc, hunks);
+    doc.finish();
+
+    cout << "dokumen " << LINES << " baris, " << EDITS << " suntingan tersebar (" << editMs << " ms)\n";
+    cout << "  diff pertama (baca file + hash semua baris): " << first << " ms\n";
+    cout << "  diff ulang (hash dari cache)               : " << again << " ms\n";
+    cout << "  diff setelah 1 tombol lagi                 : " << afterEdit << " ms, " << hunks << " hunk\n";
+    return 0;
+}
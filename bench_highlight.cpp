@@ -0,0 +1,121 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "document.h"
+
+using namespace std;
+
+// Benchmark highlight: biaya per tombol dengan SyntaxCache (hanya baris
+// kotor yang di-tokenize ulang) dibanding tokenize ulang semua baris sampai
+// viewport, di log 1 juta baris dan di file C dengan komentar blok.
+// Terakhir: biaya SyntaxCache::linesChanged untuk Enter / gabung baris di
+// cache 10 juta baris (state tidak digeser untuk seluruh file).
+
+const size_t LINES = 1000000;
+const size_t KEYS = 200;
+const size_t BIG_LINES = 10000000;
+
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+string makeLog() {
+    static const char* levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    string text;
+    for (size_t i = 0; i < LINES; ++i) {
+        text += "2024-05-01 12:00:" + to_string(i % 60) + " [" + levels[i % 4] + "] worker " +
+                to_string(i % 37) + " request " + to_string(i) + " done in 12ms\n";
+        if (i % 4 == 3)
+            text += "    at handler.cpp:" + to_string(i % 900) + "\n";
+    }
+    return text;
+}
+
+string makeSource() {
+    string text;
+    for (size_t i = 0; i < LINES / 4; ++i) {
+        if (i % 50 == 0) text += "/* fungsi " + to_string(i) + "\n * keterangan\n */\n";
+        text += "    int value" + to_string(i % 100) + " = compute(\"x\", 0x" + to_string(i % 9) + "); // ok\n";
+    }
+    return text;
+}
+
+void run(const char* name, const char* path, const string& text) {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    Document doc(path, &pool, &swap, &log);
+    doc.insertText(text);
+    size_t viewport = doc.lines.size(); // kasus terburuk: viewport di akhir file
+    double firstMs = timeMs([&] { doc.refreshHighlight(viewport); });
+
+    doc.moveTo(doc.lines.size() / 2);
+    size_t work = 0;
+    double incrementalMs = timeMs([&] {
+        for (size_t k = 0; k < KEYS; ++k) {
+            doc.applyOp(J_INSERT, k % 8 == 7 ? " " : "x");
+            work += doc.refreshHighlight(viewport);
+        }
+    });
+
+    // Tanpa cache: semua baris sampai viewport di-tokenize ulang tiap tombol
+    uint8_t sink = 0;
+    double fullMs = timeMs([&] {
+        for (size_t k = 0; k < 3; ++k) {
+            uint8_t state = 0;
+            for (size_t i = 0; i < viewport; ++i)
+                state = doc.syntax.highlighter->tokenize(doc.lineAt(i), state, nullptr);
+            sink ^= state;
+        }
+    }) / 3;
+
+    // Membuka komentar blok: baris sampai penutup berikutnya ikut berubah
+    doc.moveTo(doc.currentLineIndex + 10);
+    doc.moveHome();
+    doc.applyOp(J_PASTE, "/* ");
+    size_t opened = doc.refreshHighlight(viewport);
+    doc.applyOp(J_UNDO, "");
+    size_t closed = doc.refreshHighlight(viewport);
+
+    cout << name << " (" << doc.lines.size() << " baris, highlighter " << doc.syntax.highlighter->name << ")\n";
+    cout << "  tokenize awal     : " << firstMs << " ms\n";
+    cout << "  per tombol, cache : " << incrementalMs * 1000 / KEYS << " us, "
+         << (double)work / KEYS << " baris di-tokenize\n";
+    cout << "  per tombol, penuh : " << fullMs << " ms, " << viewport << " baris\n";
+    cout << "  buka/tutup \"/*\"   : " << opened << " / " << closed << " baris di-tokenize\n";
+    if (sink == 42) cout << "";
+}
+
+// Enter lalu gabung lagi di sekitar satu posisi, dan Enter di posisi acak
+void runLineChanges() {
+    SyntaxCache cache(&LOG_HIGHLIGHTER);
+    cache.install(vector<uint8_t>(BIG_LINES, LOG_INFO), BIG_LINES);
+    size_t line = BIG_LINES / 2;
+    double localMs = timeMs([&] {
+        for (size_t k = 0; k < KEYS; ++k) {
+            cache.linesChanged(line + k % 16, 1, 2); // Enter
+            cache.linesChanged(line + k % 16, 2, 1); // Backspace di awal baris
+        }
+    });
+    uint64_t seed = 1;
+    double randomMs = timeMs([&] {
+        for (size_t k = 0; k < KEYS; ++k) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            cache.linesChanged((seed >> 33) % BIG_LINES, 1, 2);
+        }
+    });
+    cout << "linesChanged di cache " << BIG_LINES << " baris\n";
+    cout << "  Enter/gabung berurutan: " << localMs * 1000 / (2 * KEYS) << " us per edit\n";
+    cout << "  Enter di baris acak   : " << randomMs * 1000 / KEYS << " us per edit\n";
+}
+
+int main() {
+    run("log", "/tmp/bench_highlight.log", makeLog());
+    run("sumber C", "/tmp/bench_highlight.cpp", makeSource());
+    runLineChanges();
+    return 0;
+}
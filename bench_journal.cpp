@@ -0,0 +1,103 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include "journal.h"
+
+using namespace std;
+
+// Benchmark overhead journal terhadap latensi satu keystroke.
+// Satu keystroke = edit currentLine + render satu frame seperti displayText().
+// Blok BLOCK keystroke tanpa dan dengan journal dijalankan bergantian
+// ROUNDS kali; overhead = median rasio tiap pasangan, jadi gangguan
+// scheduler/frekuensi CPU yang mengenai keduanya saling menghapus.
+
+const int BLOCK = 10000;
+const int ROUNDS = 100;
+const int KEYSTROKES = BLOCK * ROUNDS;
+const string benchJournal = "/tmp/bench_journal.journal";
+
+vector<string> lines;
+string currentLine;
+string frame;
+
+void editKey(char ch) {
+    if (ch == '\n') {
+        lines.push_back(currentLine);
+        currentLine.clear();
+    } else {
+        currentLine += ch;
+    }
+}
+
+void renderFrame() {
+    // Viewport 24 baris terakhir, dirender ke buffer (tanpa terminal)
+    frame.clear();
+    frame += "\033[2J\033[H\033[0m=== Simple Text Editor ===\n";
+    size_t start = lines.size() > 24 ? lines.size() - 24 : 0;
+    for (size_t i = start; i < lines.size(); ++i)
+        frame += "[" + to_string(i + 1) + "] > " + lines[i] + "\033[0m\n";
+    frame += "\r[" + to_string(lines.size() + 1) + "] > " + currentLine + "\033[K";
+}
+
+char keyAt(int i) {
+    return (i % 61 == 60) ? '\n' : (char)('a' + i % 26);
+}
+
+double runKeystrokes(Journal* journal) {
+    lines.clear();
+    currentLine.clear();
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < BLOCK; ++i) {
+        char ch = keyAt(i);
+        if (journal) {
+            journal->append(ch == '\n' ? J_NEWLINE : J_INSERT, ch == '\n' ? "" : string(1, ch));
+            journal->maybeCommit();
+        }
+        editKey(ch);
+        renderFrame();
+    }
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / BLOCK;
+}
+
+int main() {
+    remove(benchJournal.c_str());
+    Journal journal;
+    journal.open(benchJournal);
+    journal.checkpointRecords = KEYSTROKES + 1;
+    vector<double> plain, journaled, ratio;
+    for (int round = 0; round < ROUNDS; ++round) {
+        plain.push_back(runKeystrokes(nullptr));
+        journaled.push_back(runKeystrokes(&journal));
+        ratio.push_back(journaled.back() / plain.back());
+    }
+    journal.commit();
+    size_t commits = journal.commits;
+    journal.close();
+    auto median = [](vector<double> v) {
+        sort(v.begin(), v.end());
+        return v[v.size() / 2];
+    };
+
+    // Replay: waktu recovery untuk satu interval checkpoint penuh
+    lines.clear();
+    currentLine.clear();
+    auto start = chrono::steady_clock::now();
+    size_t records = Journal::replay(benchJournal, [](JournalOp op, const string& payload) {
+        editKey(op == J_NEWLINE ? '\n' : payload[0]);
+    });
+    double replayMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    double perRecordNs = replayMs * 1e6 / (records ? records : 1);
+    remove(benchJournal.c_str());
+
+    cout << "keystrokes          : " << KEYSTROKES << "\n";
+    cout << "latency tanpa journal: " << median(plain) << " ns/key (median blok)\n";
+    cout << "latency dengan journal: " << median(journaled) << " ns/key (" << commits << " fdatasync)\n";
+    cout << "overhead            : " << (median(ratio) - 1) * 100.0 << " %\n";
+    cout << "replay              : " << records << " record dalam " << replayMs << " ms\n";
+    cout << "recovery per checkpoint (4096 record): "
+         << perRecordNs * 4096 / 1e6 << " ms\n";
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <malloc.h>
+#include "linestore.h"
+
+using namespace std;
+
+// Benchmark memori dan iterasi: vector<string> vs LineStore untuk baris
+// log pendek yang banyak berulang, dan untuk baris yang semuanya unik.
+
+const size_t LINES = 2000000;
+
+size_t heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+string makeLine(size_t i, bool repeated) {
+    static const char* levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    if (repeated)
+        return string("[") + levels[i % 4] + "] worker " + to_string(i % 37) + " heartbeat ok";
+    return "2024-05-01 12:00:" + to_string(i) + " request id=" + to_string(i * 7919);
+}
+
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void run(bool repeated) {
+    size_t content = 0;
+    for (size_t i = 0; i < LINES; ++i)
+        content += makeLine(i, repeated).size();
+
+    size_t before = heapInUse();
+    vector<string> lines;
+    for (size_t i = 0; i < LINES; ++i)
+        lines.push_back(makeLine(i, repeated));
+    lines.shrink_to_fit();
+    size_t vectorBytes = heapInUse() - before;
+    size_t sum = 0;
+    double vectorIter = timeMs([&] {
+        for (const string& line : lines) sum += line.size() + (unsigned char)line[0];
+    });
+    vector<string>().swap(lines);
+
+    LineStore store;
+    for (size_t i = 0; i < LINES; ++i)
+        store.push_back(makeLine(i, repeated));
+    store.shrink_to_fit();
+    size_t storeBytes = store.memoryBytes();
+    double storeIter = timeMs([&] {
+        for (string_view line : store) sum += line.size() + (unsigned char)line[0];
+    });
+
+    cout << (repeated ? "baris log berulang" : "baris unik") << " (" << LINES << " baris, isi "
+         << content / (1 << 20) << " MB)\n";
+    cout << "  vector<string>: " << vectorBytes / (1 << 20) << " MB, overhead "
+         << (double)(vectorBytes - content) / LINES << " B/baris, iterasi " << vectorIter << " ms\n";
+    cout << "  LineStore     : " << storeBytes / (1 << 20) << " MB, overhead "
+         << ((double)storeBytes - (double)content) / LINES << " B/baris, iterasi " << storeIter
+         << " ms, " << store.internedLines() << " baris di-intern\n";
+    if (sum == 42) cout << "";
+}
+
+int main() {
+    run(true);
+    run(false);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "document.h"
+
+using namespace std;
+
+// Benchmark multi-kursor: satu kursor per baris log, lalu mengetik beberapa
+// karakter dan backspace. Waktu per kursor harus tetap kira-kira sama saat
+// jumlah kursor naik (linear), termasuk satu grup undo per kata.
+
+const char TYPED[] = " [checked]";
+
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void run(size_t cursors, PagePool* pool, SwapFile* swap, ActionLog* log) {
+    Document doc("/tmp/bench_multicursor.txt", pool, swap, log);
+    string text;
+    for (size_t i = 0; i < cursors; ++i)
+        text += "2024-05-01 12:00:00 worker " + to_string(i % 37) + " ERROR timeout\n";
+    doc.insertText(text);
+    doc.moveTo(0);
+    doc.moveHome();
+    for (int i = 0; i < 5; ++i)
+        doc.moveWordRight(); // di akhir "ERROR"
+
+    double addMs = timeMs([&] { doc.applyOp(J_ADD_CURSORS_AT_WORD, ""); });
+    size_t keys = 0;
+    double typeMs = timeMs([&] {
+        for (const char* p = TYPED; *p; ++p, ++keys)
+            doc.applyOp(J_INSERT, string(1, *p));
+        for (int i = 0; i < 3; ++i, ++keys)
+            doc.applyOp(J_BACKSPACE, "");
+    });
+    size_t total = doc.extraCursors.size() + 1;
+    double undoMs = timeMs([&] { doc.applyOp(J_UNDO, ""); });
+
+    cout << "  " << total << " kursor: tambah " << addMs << " ms, "
+         << typeMs / keys << " ms/tombol (" << typeMs * 1e6 / keys / cursors << " ns/kursor), undo "
+         << undoMs << " ms\n";
+}
+
+int main() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    cout << "mengetik \"" << TYPED << "\" + 3 backspace di semua kursor\n";
+    for (size_t cursors : {1000, 10000, 100000, 1000000})
+        run(cursors, &pool, &swap, &log);
+    return 0;
+}
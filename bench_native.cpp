@@ -0,0 +1,140 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include "native.h"
+
+using namespace std;
+
+// Benchmark format native: dokumen DOC_MB MB (atau argv[1] MB) disimpan
+// sebagai teks biasa dan sebagai .pkd, cache halaman kedua file dibuang
+// (posix_fadvise), lalu keduanya dibuka ke LineStore. Selain waktu, dicatat
+// waktu CPU dan page fault: membuka teks biasa membaca dan menyalin setiap
+// byte, membuka .pkd hanya menyentuh index baris. Terakhir semua baris .pkd
+// dibaca sekali untuk menunjukkan biaya teks yang dimuat belakangan.
+
+const size_t DOC_MB = 1024;
+const char* TEXT_PATH = "/tmp/bench_native.txt";
+const char* NATIVE_PATH = "/tmp/bench_native.pkd";
+
+using Clock = chrono::steady_clock;
+
+struct Usage {
+    Clock::time_point wall;
+    rusage ru;
+
+    static Usage now() {
+        Usage u;
+        u.wall = Clock::now();
+        getrusage(RUSAGE_SELF, &u.ru);
+        return u;
+    }
+};
+
+double cpuMs(const timeval& t) {
+    return t.tv_sec * 1000.0 + t.tv_usec / 1000.0;
+}
+
+void report(const char* name, const Usage& a, const Usage& b) {
+    double wall = chrono::duration<double, milli>(b.wall - a.wall).count();
+    double cpu = cpuMs(b.ru.ru_utime) - cpuMs(a.ru.ru_utime) + cpuMs(b.ru.ru_stime) - cpuMs(a.ru.ru_stime);
+    cout << name << ": " << wall << " ms (CPU user " << cpuMs(b.ru.ru_utime) - cpuMs(a.ru.ru_utime)
+         << " ms, total " << cpu << " ms), page fault " << b.ru.ru_minflt - a.ru.ru_minflt << " minor / "
+         << b.ru.ru_majflt - a.ru.ru_majflt << " major" << endl;
+}
+
+void dropCache(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+int main(int argc, char* argv[]) {
+    size_t targetBytes = (argc > 1 ? strtoull(argv[1], nullptr, 10) : DOC_MB) << 20;
+    {
+        static const char* words[] = {"struktur", "data", "editor", "baris", "teks", "node", "kursor", "simpan"};
+        string text;
+        text.reserve(targetBytes + 256);
+        vector<size_t> ends;
+        for (uint32_t i = 0; text.size() < targetBytes; ++i) {
+            for (uint32_t w = 0; w < 4 + i % 12; ++w) {
+                if (w) text += ' ';
+                text += words[(i * 7 + w * 3) % 8];
+            }
+            ends.push_back(text.size());
+        }
+        vector<string_view> lines;
+        lines.reserve(ends.size());
+        for (size_t i = 0, start = 0; i < ends.size(); start = ends[i++])
+            lines.push_back(string_view(text).substr(start, ends[i] - start));
+        ofstream file(TEXT_PATH);
+        for (string_view line : lines) {
+            file.write(line.data(), line.size());
+            file.put('\n');
+        }
+        file.close();
+        LineAttrs attrs;
+        attrsAppend(attrs, 4, ATTR_BOLD);
+        vector<FormattedLine> spans;
+        for (uint32_t i = 0; i < lines.size(); i += 64)
+            spans.push_back({i, attrs});
+        string encoded;
+        journalPutU32(encoded, (uint32_t)spans.size());
+        for (const FormattedLine& f : spans) {
+            journalPutU32(encoded, f.line);
+            journalPutU32(encoded, 1);
+            journalPutU32(encoded, f.attrs[0].length);
+            encoded += (char)f.attrs[0].attr;
+        }
+        auto start = Clock::now();
+        bool ok = writeNative(NATIVE_PATH, lines, encoded, "");
+        cout << "Dokumen: " << (text.size() >> 20) << " MB, " << lines.size() << " baris; tulis .pkd "
+             << chrono::duration<double, milli>(Clock::now() - start).count() << " ms" << (ok ? "" : " GAGAL")
+             << endl;
+    }
+    dropCache(TEXT_PATH);
+    dropCache(NATIVE_PATH);
+
+    {
+        Usage a = Usage::now();
+        LineStore store;
+        ifstream file(TEXT_PATH);
+        string line;
+        while (getline(file, line))
+            store.push_back(line);
+        Usage b = Usage::now();
+        report("Buka teks biasa (getline + push_back)", a, b);
+    }
+
+    LineStore store;
+    NativeFile file;
+    Usage a = Usage::now();
+    bool ok = file.open(NATIVE_PATH);
+    if (ok) file.loadInto(store);
+    Usage b = Usage::now();
+    report("Buka .pkd (mmap + fixup)", a, b);
+    if (!ok) {
+        cout << "File .pkd tidak valid" << endl;
+        return 1;
+    }
+    size_t bytes = 0;
+    for (size_t i = 0; i < 50 && i < store.size(); ++i)
+        bytes += store[i].size();
+    Usage c = Usage::now();
+    report("  Layar pertama (50 baris)", b, c);
+    for (string_view line : store)
+        bytes += line.size();
+    Usage d = Usage::now();
+    report("  Semua baris dibaca sekali", c, d);
+    cout << "Baris: " << store.size() << ", byte: " << bytes << ", memori store: "
+         << (store.memoryBytes() >> 20) << " MB di luar mapping" << endl;
+    remove(TEXT_PATH);
+    remove(NATIVE_PATH);
+    return 0;
+}
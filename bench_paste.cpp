@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "document.h"
+#include "input.h"
+
+using namespace std;
+
+// Benchmark paste 10 MB: jalur lama (satu operasi per byte, seperti cabang
+// else di main()) dibanding bracketed paste -> InputDecoder -> insertText().
+
+const size_t PASTE_BYTES = 10 * 1024 * 1024;
+
+string makeText() {
+    string text;
+    for (size_t i = 0; text.size() < PASTE_BYTES; ++i)
+        text += "baris " + to_string(i) + " isi log yang di-paste dari terminal lain\n";
+    return text;
+}
+
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    string text = makeText();
+
+    Document perByte("/tmp/bench_paste.txt", &pool, &swap, &log);
+    double byteMs = timeMs([&] {
+        for (char ch : text)
+            perByte.applyOp(ch == '\n' ? J_NEWLINE : J_INSERT, string(1, ch));
+    });
+
+    Document bulk("/tmp/bench_paste.txt", &pool, &swap, &log);
+    string input = "\033[200~" + text + "\033[201~";
+    double bulkMs = timeMs([&] {
+        InputDecoder decoder;
+        KeyEvent key;
+        for (char ch : input)
+            if (decoder.feed(ch, key) && key.action == KEY_PASTE)
+                bulk.applyOp(J_PASTE, decoder.pasted);
+    });
+
+    // Paste di tengah dokumen 1 juta baris
+    Document middle("/tmp/bench_paste.txt", &pool, &swap, &log);
+    middle.insertText(string(1000000, '\n'));
+    middle.moveTo(500000);
+    double middleMs = timeMs([&] { middle.insertText(text); });
+
+    cout << "paste " << text.size() / (1 << 20) << " MB (" << bulk.lines.size() << " baris)\n";
+    cout << "  per byte          : " << byteMs << " ms, " << perByte.undoStack.size() << " entri undo\n";
+    cout << "  bracketed + bulk  : " << bulkMs << " ms, " << bulk.undoStack.size() << " entri undo\n";
+    cout << "  bulk di baris 500k: " << middleMs << " ms\n";
+    return 0;
+}
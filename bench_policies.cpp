@@ -0,0 +1,92 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include "editorcore.h"
+
+using namespace std;
+
+// Benchmark kombinasi policy EditorCore: {VectorBuffer, StoreBuffer} x
+// {SnapshotUndo di ManualStack, SnapshotUndo di std::stack, DeltaUndo} x
+// {FileLog, NullLog}. Semua menjalankan sesi skrip yang sama (mengetik kata,
+// newline, pindah baris, hapus kata, undo/redo) lalu hasil teksnya
+// dibandingkan antar kombinasi dengan policy undo yang sama.
+
+const int LINES = 20000;
+const int WORDS_PER_LINE = 12;
+const char* LOG_PATH = "/tmp/bench_policies.log";
+
+using Clock = chrono::steady_clock;
+
+template<typename Editor>
+string runSession(const char* name) {
+    static const char* words[] = {"struktur", "data", "editor", "baris", "teks", "node", "kursor", "simpan"};
+    Editor editor;
+    editor.log.open(LOG_PATH);
+    auto start = Clock::now();
+    for (int i = 0; i < LINES; ++i) {
+        for (int w = 0; w < WORDS_PER_LINE; ++w) {
+            for (const char* p = words[(i * 7 + w * 3) % 8]; *p; ++p)
+                editor.insertChar(*p);
+            editor.insertChar(' ');
+        }
+        if (i % 5 == 0) editor.deleteLastWord();
+        if (i % 7 == 0) editor.backspace();
+        if (i % 11 == 0) {
+            editor.undo();
+            editor.undo();
+            editor.redo();
+        }
+        if (i % 13 == 0 && i > 0) {
+            editor.moveUp();
+            for (const char* p = "sisip "; *p; ++p)
+                editor.insertChar(*p);
+            editor.moveDown();
+        }
+        editor.newline();
+    }
+    for (int i = 0; i < LINES / 4; ++i)
+        editor.undo();
+    for (int i = 0; i < LINES / 8; ++i)
+        editor.redo();
+    double ms = chrono::duration<double, milli>(Clock::now() - start).count();
+
+    string text;
+    for (size_t i = 0; i < editor.lineCount(); ++i) {
+        text += editor.lineText(i);
+        text += '\n';
+    }
+    printf("%-40s %9.1f ms  %8zu KB  undo %zu\n", name, ms, editor.memoryBytes() >> 10,
+           editor.history.depth());
+    return text;
+}
+
+template<typename Undo>
+void compareUndo(const char* undoName) {
+    string names[4] = {
+        string("Vector + ") + undoName + " + FileLog",
+        string("Vector + ") + undoName + " + NullLog",
+        string("Store  + ") + undoName + " + FileLog",
+        string("Store  + ") + undoName + " + NullLog",
+    };
+    string results[4] = {
+        runSession<EditorCore<VectorBuffer, Undo, FileLog>>(names[0].c_str()),
+        runSession<EditorCore<VectorBuffer, Undo, NullLog>>(names[1].c_str()),
+        runSession<EditorCore<StoreBuffer, Undo, FileLog>>(names[2].c_str()),
+        runSession<EditorCore<StoreBuffer, Undo, NullLog>>(names[3].c_str()),
+    };
+    for (int i = 1; i < 4; ++i) {
+        if (results[i] != results[0])
+            cout << "  HASIL BERBEDA: " << names[i] << " vs " << names[0] << endl;
+    }
+    cout << "  teks akhir " << (results[0].size() >> 10) << " KB" << endl;
+}
+
+int main() {
+    cout << LINES << " baris x " << WORDS_PER_LINE << " kata per sesi" << endl;
+    compareUndo<ManualSnapshotUndo>("Snapshot/ManualStack");
+    compareUndo<StdStackSnapshotUndo>("Snapshot/std::stack");
+    compareUndo<DeltaUndo>("Delta");
+    remove(LOG_PATH);
+    return 0;
+}
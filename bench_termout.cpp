@@ -0,0 +1,119 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "highlight.h"
+#include "termout.h"
+
+using namespace std;
+
+// Benchmark render satu frame (judul + 40 baris log berwarna): jalur lama
+// (stdout line-buffered seperti cout di terminal, escape SGR ditulis per
+// token) dibanding TermWriter (satu buffer, SGR digabung, satu write()).
+// Jumlah write() jalur lama dihitung lewat fopencookie.
+
+const int FRAMES = 20000;
+const int ROWS = 40;
+
+struct Counter {
+    int fd;
+    uint64_t writes = 0;
+    uint64_t bytes = 0;
+};
+
+ssize_t countingWrite(void* cookie, const char* data, size_t size) {
+    Counter* counter = (Counter*)cookie;
+    counter->writes++;
+    counter->bytes += size;
+    return write(counter->fd, data, size);
+}
+
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    static const char* levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    vector<string> lines;
+    vector<vector<Token>> tokens(ROWS);
+    for (int i = 0; i < ROWS; ++i) {
+        lines.push_back("2024-05-01 12:00:" + to_string(i % 60) + " [" + levels[i % 4] + "] worker " +
+                        to_string(i % 37) + " request " + to_string(i) + " done in 12ms");
+        tokenizeLog(lines[i], 0, &tokens[i]);
+    }
+    int devnull = open("/dev/null", O_WRONLY);
+
+    // Jalur lama
+    Counter counter{devnull};
+    cookie_io_functions_t io{nullptr, countingWrite, nullptr, nullptr};
+    FILE* out = fopencookie(&counter, "w", io);
+    setvbuf(out, nullptr, _IOLBF, BUFSIZ);
+    double oldMs = timeMs([&] {
+        for (int f = 0; f < FRAMES; ++f) {
+            fputs("\033[2J\033[H\033[0m", out);
+            for (int h = 0; h < 21; ++h)
+                fputs("  Ctrl+X : Perintah editor\n", out);
+            for (int i = 0; i < ROWS; ++i) {
+                fprintf(out, "[%d] > ", i + 1);
+                size_t pos = 0;
+                for (const Token& t : tokens[i]) {
+                    fwrite(lines[i].data() + pos, 1, t.start - pos, out);
+                    fprintf(out, "\033[%dm", tokenColor(t.kind));
+                    fwrite(lines[i].data() + t.start, 1, t.length, out);
+                    fputs("\033[39m", out);
+                    pos = t.start + t.length;
+                }
+                fwrite(lines[i].data() + pos, 1, lines[i].size() - pos, out);
+                fputs("\033[0m\n", out);
+            }
+            fputs("\033[1m\r[40] > \033[K\033[0m", out);
+            fflush(out);
+        }
+    });
+    fclose(out);
+
+    TermWriter screen(devnull);
+    double newMs = timeMs([&] {
+        for (int f = 0; f < FRAMES; ++f) {
+            screen.control("\033[2J\033[H");
+            screen.resetTerminal();
+            for (int h = 0; h < 21; ++h)
+                screen << "  Ctrl+X : Perintah editor\n";
+            for (int i = 0; i < ROWS; ++i) {
+                screen << '[' << i + 1 << "] > ";
+                size_t pos = 0;
+                for (const Token& t : tokens[i]) {
+                    screen << string_view(lines[i]).substr(pos, t.start - pos);
+                    screen.color(tokenColor(t.kind));
+                    screen << string_view(lines[i]).substr(t.start, t.length);
+                    screen.color(39);
+                    pos = t.start + t.length;
+                }
+                screen << string_view(lines[i]).substr(pos);
+                screen.resetStyle();
+                screen << '\n';
+            }
+            screen.bold(true);
+            screen << "\r[40] > ";
+            screen.control("\033[K");
+            screen.resetStyle();
+            screen.commitStyle();
+            screen.flush();
+        }
+    });
+    close(devnull);
+
+    cout << FRAMES << " frame, " << ROWS << " baris berwarna per frame\n";
+    cout << "  cout/stdio   : " << oldMs * 1000 / FRAMES << " us/frame, " << (double)counter.writes / FRAMES
+         << " write/frame, " << counter.bytes / FRAMES << " B/frame\n";
+    cout << "  TermWriter   : " << newMs * 1000 / FRAMES << " us/frame, "
+         << (double)screen.writeCount() / screen.frameCount() << " write/frame, "
+         << screen.byteCount() / screen.frameCount() << " B/frame\n";
+    return 0;
+}
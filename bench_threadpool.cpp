@@ -0,0 +1,85 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "document.h"
+
+using namespace std;
+
+// Benchmark latensi input saat pekerjaan berat berjalan: simpan dokumen
+// 1 juta baris (tulis + fsync) dan tokenize highlight seluruh file, sekali
+// di thread utama (seperti sebelumnya) dan sekali lewat ThreadPool sambil
+// thread utama terus memproses tombol.
+
+const size_t LINES = 1000000;
+const char* PATH = "/tmp/bench_threadpool.log";
+
+using Clock = chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Satu "tombol": edit + highlight + hasil background, seperti satu putaran main()
+double keystroke(Document& doc, ThreadPool* workers, size_t k) {
+    auto start = Clock::now();
+    doc.applyOp(J_INSERT, k % 8 == 7 ? " " : "x");
+    doc.refreshHighlight(doc.currentLineIndex + 1);
+    if (workers) workers->runCompletions();
+    return msSince(start);
+}
+
+int main() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    {
+        string text;
+        for (size_t i = 0; i < LINES; ++i)
+            text += "2024-05-01 12:00:00 [INFO] worker " + to_string(i % 37) + " request " + to_string(i) + " ok\n";
+        Document seed(PATH, &pool, &swap, &log);
+        seed.insertText(text);
+        seed.save();
+    }
+
+    // Sinkron: tombol Ctrl+S menahan loop sampai file tersimpan, dan tokenize
+    // awal seluruh file terjadi saat layar digambar di akhir file
+    Document sync(PATH, &pool, &swap, &log);
+    sync.start(true);
+    auto start = Clock::now();
+    sync.save();
+    double syncSave = msSince(start);
+    start = Clock::now();
+    sync.refreshHighlight(sync.lines.size());
+    double syncHighlight = msSince(start);
+    sync.finish();
+
+    // Background: simpan dan highlight di worker, tombol tetap diproses
+    ThreadPool workers;
+    Document doc(PATH, &pool, &swap, &log);
+    doc.start(true);
+    doc.moveTo(LINES / 2);
+    start = Clock::now();
+    doc.saveAsync(workers);
+    double submitMs = msSince(start);
+    doc.warmHighlight(workers);
+    vector<double> latency;
+    size_t k = 0;
+    while (doc.saving || doc.highlightPending() || latency.size() < 1000)
+        latency.push_back(keystroke(doc, &workers, k++));
+    double wallMs = msSince(start);
+    doc.finish();
+
+    sort(latency.begin(), latency.end());
+    double sum = 0;
+    for (double ms : latency) sum += ms;
+    cout << "dokumen " << LINES << " baris, " << workers.threadCount() << " worker\n";
+    cout << "  sinkron   : simpan " << syncSave << " ms, highlight awal " << syncHighlight
+         << " ms (loop input berhenti selama itu)\n";
+    cout << "  background: Ctrl+S " << submitMs << " ms (snapshot teks), selesai dalam " << wallMs << " ms\n";
+    cout << "              highlight terpasang untuk " << doc.syntax.cachedLines() << " baris\n";
+    cout << "              " << latency.size() << " tombol selama itu: rata-rata " << sum / latency.size()
+         << " ms, p99 " << latency[latency.size() * 99 / 100] << " ms, maks " << latency.back() << " ms\n";
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <ctime>
+#include <malloc.h>
+#include "document.h"
+
+using namespace std;
+
+// Benchmark stack undo untuk sesi panjang: PUSHES delta satu baris didorong
+// ke ManualStack<EditDelta> tanpa budget dan dengan budget BUDGET_MB.
+// Dicatat total waktu, push paling lambat dan jumlah push di atas 1 ms
+// (penggandaan ring terlihat di sini, dengan budget sampai ring mencapai
+// budget / STACK_SLOT_BYTES slot), memori stack, dan waktu undo kembali ke
+// awal (dengan budget, sebagian besar dibaca ulang dari file spill).
+//
+// Push paling lambat diukur dua kali: waktu dinding, dan waktu CPU thread
+// pemanggil. Dengan budget, kompresi + tulis spill berjalan di thread writer;
+// di mesin satu core thread itu merebut CPU di tengah push dan hanya
+// terlihat di waktu dinding, sedangkan kerja push sendiri terlihat di waktu CPU.
+
+const size_t PUSHES = 2000000;
+const size_t BUDGET_MB = 16;
+
+using Clock = chrono::steady_clock;
+
+double threadCpuUs() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+EditDelta makeDelta(size_t i) {
+    static const char* words[] = {"struktur", "data", "editor", "baris", "teks", "node", "kursor", "simpan"};
+    EditDelta delta;
+    delta.line = (uint32_t)(i % 5000);
+    string text;
+    for (size_t w = 0; w < 4 + i % 9; ++w) {
+        if (w) text += ' ';
+        text += words[(i * 7 + w * 3) % 8];
+    }
+    delta.text.push_back(std::move(text));
+    return delta;
+}
+
+void run(const char* name, size_t budget) {
+    ManualStack<EditDelta> stack;
+    stack.setBudget(budget);
+    double worst = 0, worstCpu = 0;
+    size_t slow = 0, slowCpu = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < PUSHES; ++i) {
+        EditDelta delta = makeDelta(i);
+        double cpu = threadCpuUs();
+        auto t = Clock::now();
+        stack.push(std::move(delta));
+        double us = chrono::duration<double, micro>(Clock::now() - t).count();
+        cpu = threadCpuUs() - cpu;
+        worst = max(worst, us);
+        worstCpu = max(worstCpu, cpu);
+        slow += us > 1000;
+        slowCpu += cpu > 1000;
+    }
+    double pushMs = chrono::duration<double, milli>(Clock::now() - start).count();
+    size_t memory = stack.memoryBytes();
+    size_t spilled = stack.spilled();
+
+    start = Clock::now();
+    size_t popped = 0, bytes = 0;
+    while (!stack.empty()) {
+        bytes += stack.top().text[0].size();
+        stack.pop();
+        popped++;
+    }
+    double popMs = chrono::duration<double, milli>(Clock::now() - start).count();
+    cout << name << ": push " << pushMs << " ms (terlama " << worst << " us, " << slow << " > 1 ms; CPU terlama "
+         << worstCpu << " us, " << slowCpu << " > 1 ms), memori " << (memory >> 20)
+         << " MB, di-spill " << spilled << "; undo semua " << popMs << " ms (" << popped << " entri, "
+         << (bytes >> 20) << " MB teks)" << endl;
+}
+
+int main() {
+    cout << PUSHES << " delta undo" << endl;
+    run("Tanpa budget", 0);
+    malloc_trim(0); // free list run pertama dirapikan di sini, bukan di push pertama run kedua
+    run(("Budget " + to_string(BUDGET_MB) + " MB").c_str(), BUDGET_MB << 20);
+    return 0;
+}
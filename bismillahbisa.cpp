@@ -6,6 +6,10 @@
 #include <termios.h>
 #include <unistd.h>
 #include <ctime>
+#include "terminal.h"
+#include "linestore.h"
+#include "utf8.h"
+#include "termout.h"
 
 using namespace std;
 
@@ -18,8 +22,9 @@ bool isItalic = false;
 bool isUnderline = false;
 bool underlineActive = false;
 int currentLineIndex = 0;
-vector<string> lines;
+LineStore lines;
 ofstream logFile;
+TermWriter screen; // satu write() per tombol, SGR hanya saat atribut berubah
 
 // Function to log actions with timestamp
 void logAction(const string& action) {
@@ -32,21 +37,6 @@ void logAction(const string& action) {
     }
 }
 
-void enableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag &= ~(ICANON | ECHO);
-    term.c_iflag &= ~(IXON);
-    tcsetattr(0, TCSANOW, &term);
-}
-
-void disableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag |= (ICANON | ECHO);
-    tcsetattr(0, TCSANOW, &term);
-}
-
 void pushToUndo() {
     if (undoStack.empty() || undoStack.top() != currentLine) {
         undoStack.push(currentLine);
@@ -75,7 +65,7 @@ void handleRedo() {
 
 void handleDeleteLastWord() {
     pushToUndo();
-    size_t pos = currentLine.find_last_of(' ');
+    size_t pos = findLastSeparator(currentLine, currentLine.size());
     if (pos != string::npos)
         currentLine = currentLine.substr(0, pos);
     else
@@ -86,8 +76,9 @@ void handleDeleteLastWord() {
 void handleSave() {
     // Clear fullText and rebuild it from lines[]
     fullText.clear();
-    for (const string& line : lines) {
-        fullText += line + "\n";  // Append each line with newline
+    for (string_view line : lines) {
+        fullText += line;  // Append each line with newline
+        fullText += "\n";
     }
 
     // Save to file
@@ -114,43 +105,46 @@ void promptExit() {
     }
 }
 
+// Atribut hanya dicatat; escape dikirim displayText() bersama baris
 void toggleBold() {
     isBold = !isBold;
-    cout << (isBold ? "\033[1m" : "\033[22m");
 }
 
 void toggleItalic() {
     isItalic = !isItalic;
-    cout << (isItalic ? "\033[3m" : "\033[23m");
 }
 
 void toggleUnderline() {
     underlineActive = !underlineActive;
-    if (underlineActive) cout << "\033[4m";
-    else cout << "\033[24m";
 }
 
 void moveUp() {
     if (currentLineIndex > 0) {
-        lines[currentLineIndex] = currentLine;  // Save current line before moving up
+        lines.set(currentLineIndex, currentLine);  // Save current line before moving up
         currentLineIndex--;
-        currentLine = lines[currentLineIndex];  // Update current line with the one from previous line
+        currentLine = string(lines[currentLineIndex]);  // Update current line with the one from previous line
         logAction("Moved up to line: " + currentLine);
     }
 }
 
 void moveDown() {
     if (currentLineIndex < (int)lines.size() - 1) {
-        lines[currentLineIndex] = currentLine;  // Save current line before moving down
+        lines.set(currentLineIndex, currentLine);  // Save current line before moving down
         currentLineIndex++;
-        currentLine = lines[currentLineIndex];  // Update current line with the one from next line
+        currentLine = string(lines[currentLineIndex]);  // Update current line with the one from next line
         logAction("Moved down to line: " + currentLine);
     }
 }
 
 void displayText() {
     // This will clear the current output and print it again
-    cout << "\r[" << currentLineIndex + 1 << "] > " << currentLine << "\033[K" << flush;  // Overwrite the current line
+    screen.bold(isBold);
+    screen.italic(isItalic);
+    screen.underline(underlineActive);
+    screen << "\r[" << currentLineIndex + 1 << "] > " << currentLine;
+    screen.control("\033[K");  // Overwrite the current line
+    screen.commitStyle();
+    screen.flush();
 }
 
 int main() {
@@ -201,7 +195,7 @@ int main() {
         } else if (ch == '\n') {
             pushToUndo();
             if (currentLineIndex < lines.size()) {
-                lines[currentLineIndex] = currentLine; // Update the line
+                lines.set(currentLineIndex, currentLine); // Update the line
             } else {
                 lines.push_back(currentLine);
             }
@@ -210,13 +204,13 @@ int main() {
             currentLine.clear();
             currentLineIndex = lines.size(); // Move to the new line
             lines.push_back(""); // Create a new empty line
-            cout << "\n> " << flush;
+            screen << '\n';
             isStartOfWord = true;
         } else if (ch == 127) {
             if (!currentLine.empty()) {
-                currentLine.pop_back();
+                popGrapheme(currentLine);
                 if (currentLineIndex < lines.size())
-                    lines[currentLineIndex] = currentLine;
+                    lines.set(currentLineIndex, currentLine);
             }
         }  else {
             if (isStartOfWord) {
@@ -225,7 +219,7 @@ int main() {
             }
             currentLine += ch;
             if (currentLineIndex < lines.size())
-                lines[currentLineIndex] = currentLine; // Save changes to the correct line
+                lines.set(currentLineIndex, currentLine); // Save changes to the correct line
             if (ch == ' ') {
                 isStartOfWord = true;
             }
@@ -0,0 +1,240 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+// Pool halaman memori bersama untuk semua dokumen dalam satu sesi.
+//
+// Dokumen yang sedang idle dipadatkan (compact) ke halaman-halaman pool ini:
+// semua baris dan riwayat undo ditulis berurutan sebagai [u32 len][bytes],
+// sehingga ribuan std::string kecil diganti beberapa blok 64 KB. Halaman
+// yang dilepas masuk free list dan dipakai ulang dokumen lain; halaman bisa
+// juga ditulis ke swap file lalu dibebaskan (spill).
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+
+const size_t POOL_PAGE_SIZE = 64 * 1024;
+
+class PagePool {
+private:
+    std::vector<char*> freePages;
+    size_t totalPages = 0;
+
+public:
+    ~PagePool() {
+        trim();
+    }
+
+    char* allocPage() {
+        if (!freePages.empty()) {
+            char* page = freePages.back();
+            freePages.pop_back();
+            return page;
+        }
+        totalPages++;
+        return new char[POOL_PAGE_SIZE];
+    }
+
+    void freePage(char* page) {
+        freePages.push_back(page);
+    }
+
+    // Kembalikan halaman bebas ke sistem, sisakan `keep` halaman untuk dipakai ulang
+    void trim(size_t keep = 0) {
+        while (freePages.size() > keep) {
+            delete[] freePages.back();
+            freePages.pop_back();
+            totalPages--;
+        }
+    }
+
+    size_t pagesInUse() const {
+        return totalPages - freePages.size();
+    }
+
+    size_t pagesFree() const {
+        return freePages.size();
+    }
+
+    size_t bytes() const {
+        return totalPages * POOL_PAGE_SIZE;
+    }
+};
+
+// Deretan byte yang disimpan di halaman-halaman PagePool.
+class PagedText {
+private:
+    PagePool* pool = nullptr;
+    std::vector<char*> pages;
+    size_t used = 0;
+
+public:
+    PagedText() {}
+    explicit PagedText(PagePool* p) : pool(p) {}
+    PagedText(const PagedText&) = delete;
+    PagedText& operator=(const PagedText&) = delete;
+
+    ~PagedText() {
+        release();
+    }
+
+    void setPool(PagePool* p) {
+        pool = p;
+    }
+
+    size_t size() const {
+        return used;
+    }
+
+    size_t pageCount() const {
+        return pages.size();
+    }
+
+    void release() {
+        for (char* page : pages)
+            pool->freePage(page);
+        pages.clear();
+        used = 0;
+    }
+
+    void append(const char* data, size_t n) {
+        while (n > 0) {
+            size_t offset = used % POOL_PAGE_SIZE;
+            if (offset == 0 && used / POOL_PAGE_SIZE == pages.size())
+                pages.push_back(pool->allocPage());
+            size_t chunk = std::min(n, POOL_PAGE_SIZE - offset);
+            memcpy(pages.back() + offset, data, chunk);
+            used += chunk;
+            data += chunk;
+            n -= chunk;
+        }
+    }
+
+    void appendU32(uint32_t v) {
+        append((const char*)&v, 4);
+    }
+
+    void appendString(const std::string& s) {
+        appendU32((uint32_t)s.size());
+        append(s.data(), s.size());
+    }
+
+    void read(size_t pos, char* out, size_t n) const {
+        while (n > 0) {
+            size_t offset = pos % POOL_PAGE_SIZE;
+            size_t chunk = std::min(n, POOL_PAGE_SIZE - offset);
+            memcpy(out, pages[pos / POOL_PAGE_SIZE] + offset, chunk);
+            pos += chunk;
+            out += chunk;
+            n -= chunk;
+        }
+    }
+
+    // Pembaca berurutan untuk data yang ditulis dengan appendU32/appendString
+    class Reader {
+    private:
+        const PagedText& text;
+        size_t pos = 0;
+
+    public:
+        explicit Reader(const PagedText& t) : text(t) {}
+
+        uint32_t readU32() {
+            uint32_t v;
+            text.read(pos, (char*)&v, 4);
+            pos += 4;
+            return v;
+        }
+
+        std::string readString() {
+            std::string s(readU32(), '\0');
+            text.read(pos, &s[0], s.size());
+            pos += s.size();
+            return s;
+        }
+    };
+
+    // Tulis isi ke fd mulai `offset`, lalu lepaskan halaman ke pool
+    bool spill(int fd, off_t offset) {
+        size_t pos = 0;
+        for (char* page : pages) {
+            size_t chunk = std::min(POOL_PAGE_SIZE, used - pos);
+            if (pwrite(fd, page, chunk, offset + (off_t)pos) != (ssize_t)chunk)
+                return false;
+            pos += chunk;
+        }
+        release();
+        return true;
+    }
+
+    // Kebalikan dari spill(): baca `length` byte dari fd ke halaman baru
+    bool unspill(int fd, off_t offset, size_t length) {
+        release();
+        size_t pos = 0;
+        while (pos < length) {
+            char* buf = pool->allocPage();
+            pages.push_back(buf);
+            size_t chunk = std::min(POOL_PAGE_SIZE, length - pos);
+            if (pread(fd, buf, chunk, offset + (off_t)pos) != (ssize_t)chunk)
+                return false;
+            pos += chunk;
+        }
+        used = length;
+        return true;
+    }
+};
+
+// Swap file anonim untuk data yang di-spill: langsung di-unlink sehingga
+// hilang sendiri saat proses selesai. Ruang dialokasikan berurutan; begitu
+// tidak ada lagi data hidup, file dipotong kembali ke nol.
+class SwapFile {
+private:
+    int fd = -1;
+    off_t end = 0;
+    size_t liveBytes = 0;
+
+public:
+    ~SwapFile() {
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    int handle() {
+        if (fd < 0) {
+            char path[] = "/tmp/editor-swap-XXXXXX";
+            fd = mkstemp(path);
+            if (fd >= 0)
+                unlink(path);
+        }
+        return fd;
+    }
+
+    off_t reserve(size_t length) {
+        off_t offset = end;
+        end += (off_t)length;
+        liveBytes += length;
+        return offset;
+    }
+
+    void release(size_t length) {
+        liveBytes -= std::min(liveBytes, length);
+        if (liveBytes == 0 && fd >= 0) {
+            if (ftruncate(fd, 0) == 0)
+                end = 0;
+        }
+    }
+
+    size_t live() const {
+        return liveBytes;
+    }
+
+    size_t fileSize() const {
+        return (size_t)end;
+    }
+};
+
+#endif
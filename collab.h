@@ -0,0 +1,655 @@
+#ifndef COLLAB_H
+#define COLLAB_H
+
+// Edit kolaboratif lokal lewat Unix domain socket.
+//
+// Satu proses editor (server, --serve=SOCKET) memiliki Document beserta
+// journal dan file-nya; editor lain (klien, --connect=SOCKET) menerima
+// salinan teks lalu saling bertukar edit berbasis offset (textedit.h).
+// Sinkronisasinya OT dengan server pusat seperti Jupiter/ot.js: server
+// memberi nomor revisi berurutan ke setiap operasi, operasi klien yang
+// dibuat di revisi lama ditransform terhadap riwayat sejak revisi itu lalu
+// disiarkan ke semua klien. Klien hanya punya satu operasi yang belum
+// di-ack; edit berikutnya ditampung di buffer dan dikirim setelah ack.
+//
+// Edit tidak dikirim per tombol: EditTracker mencatat rentang baris yang
+// berubah, lalu flush() (sekali per frame, dari afterEvents) mengubahnya
+// jadi satu operasi kecil dengan membuang awalan/akhiran yang sama. Pesan
+// keluar juga ditulis sekali per frame untuk setiap koneksi.
+//
+// Frame pesan: [u32 panjang][u8 tipe][payload], panjang = 1 + payload.
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "document.h"
+#include "eventloop.h"
+#include "textedit.h"
+
+enum CollabMessage : uint8_t {
+    MSG_HELLO = 1, // server -> klien: revisi, nama dokumen, teks lengkap
+    MSG_EDIT,      // klien -> server: revisi dasar, operasi
+    MSG_APPLIED,   // server -> klien: revisi baru, milik penerima?, operasi (kalau bukan miliknya)
+    MSG_SAVE       // klien -> server: simpan dokumen ke file
+};
+
+const size_t COLLAB_MAX_MESSAGE = 1u << 30;
+const size_t COLLAB_HISTORY_MAX = 10000; // revisi yang disimpan untuk transform
+
+// Catat perubahan baris Document sebagai edit offset. Perubahan yang
+// bersebelahan atau bertumpuk digabung jadi satu rentang [lo, newEnd) berisi
+// salinan isi lamanya; rentang ditutup (jadi TextEdit) saat ada perubahan di
+// tempat lain atau saat take(). Isi lines selalu sama dengan teks yang sudah
+// dikirim ditambah rentang yang masih terbuka, jadi offset dihitung
+// langsung dari store.
+class EditTracker {
+public:
+    bool muted = false; // edit dari jaringan tidak dicatat ulang
+
+    explicit EditTracker(Document& d) : doc(d) {
+        doc.beforeLinesChange = [this](size_t line, size_t removed) {
+            if (!muted) before(line, removed);
+        };
+        doc.afterLinesChange = [this](size_t, size_t removed, size_t inserted) {
+            if (!muted && open) newEnd = newEnd + inserted - removed;
+        };
+    }
+
+    EditTracker(const EditTracker&) = delete;
+    EditTracker& operator=(const EditTracker&) = delete;
+
+    ~EditTracker() {
+        doc.beforeLinesChange = nullptr;
+        doc.afterLinesChange = nullptr;
+    }
+
+    // Semua edit lokal sejak take() sebelumnya, termasuk ketikan di
+    // currentLine yang belum masuk store
+    EditOp take() {
+        if (!doc.compacted) {
+            doc.commitCurrentLine();
+            if (doc.currentLineIndex >= (int)doc.lines.size())
+                doc.syncCurrentLine();
+        }
+        close();
+        EditOp out;
+        out.swap(pending);
+        return out;
+    }
+
+private:
+    Document& doc;
+    EditOp pending;
+    bool open = false;
+    size_t lo = 0;
+    size_t oldEnd = 0;
+    size_t newEnd = 0;
+    size_t oldTotal = 0; // jumlah baris sebelum rentang dibuka
+    std::vector<std::string> oldLines;
+
+    void before(size_t line, size_t removed) {
+        if (open && (line > newEnd || line + removed < lo))
+            close();
+        if (!open) {
+            open = true;
+            lo = oldEnd = newEnd = line;
+            oldTotal = doc.lines.size();
+            oldLines.clear();
+        }
+        if (line < lo) {
+            std::vector<std::string> front;
+            for (size_t i = line; i < lo; ++i)
+                front.emplace_back(doc.lines[i]);
+            oldLines.insert(oldLines.begin(), front.begin(), front.end());
+            lo = line;
+        }
+        for (; newEnd < line + removed; ++newEnd, ++oldEnd)
+            oldLines.emplace_back(doc.lines[newEnd]);
+    }
+
+    // Teks dokumen T = baris digabung '\n'. Rentang dibandingkan sebagai
+    // "baris + '\n'" (T'), jadi hanya edit yang menyentuh '\n' semu di akhir
+    // T' (menambah/menghapus baris terakhir) yang perlu digeser satu byte.
+    // Dokumen 0 baris sama dengan satu baris kosong.
+    void close() {
+        if (!open) return;
+        open = false;
+        std::string oldText, newText;
+        for (const std::string& line : oldLines) {
+            oldText += line;
+            oldText += '\n';
+        }
+        for (size_t i = lo; i < newEnd; ++i) {
+            newText += doc.lines[i];
+            newText += '\n';
+        }
+        oldLines.clear();
+        uint64_t base = doc.offsetOf(lo);
+        if (oldText.empty() && newText.empty()) return;
+        if (oldText.empty()) {
+            if (lo < oldTotal) {
+                pending.push_back(TextEdit::insertion(base, newText));
+            } else {
+                newText.pop_back();
+                if (oldTotal == 0)
+                    pending.push_back(TextEdit::insertion(0, newText));
+                else
+                    pending.push_back(TextEdit::insertion(base - 1, "\n" + newText));
+            }
+        } else if (newText.empty()) {
+            if (oldEnd < oldTotal)
+                pending.push_back(TextEdit::deletion(base, oldText.size()));
+            else if (lo > 0)
+                pending.push_back(TextEdit::deletion(base - 1, oldText.size()));
+            else
+                pending.push_back(TextEdit::deletion(0, oldText.size() - 1));
+        } else {
+            // Keduanya diakhiri '\n', jadi akhiran yang sama minimal 1 byte
+            size_t shorter = std::min(oldText.size(), newText.size());
+            size_t suffix = 0;
+            while (suffix < shorter && oldText[oldText.size() - 1 - suffix] == newText[newText.size() - 1 - suffix])
+                suffix++;
+            while (suffix > 0 && (continuation(oldText, oldText.size() - suffix) ||
+                                  continuation(newText, newText.size() - suffix)))
+                suffix--;
+            size_t prefix = 0;
+            while (prefix < shorter - suffix && oldText[prefix] == newText[prefix])
+                prefix++;
+            while (prefix > 0 && (continuation(oldText, prefix) || continuation(newText, prefix)))
+                prefix--;
+            size_t removed = oldText.size() - suffix - prefix;
+            if (removed)
+                pending.push_back(TextEdit::deletion(base + prefix, removed));
+            if (newText.size() - suffix > prefix)
+                pending.push_back(TextEdit::insertion(base + prefix, newText.substr(prefix, newText.size() - suffix - prefix)));
+        }
+        if (!pending.empty() && pending.back().empty())
+            pending.pop_back();
+    }
+
+    // Batas potong tidak boleh di tengah karakter UTF-8: edit lain bisa
+    // menyisip di batas itu dan memecah karakternya
+    static bool continuation(const std::string& s, size_t pos) {
+        return pos < s.size() && ((unsigned char)s[pos] & 0xC0) == 0x80;
+    }
+};
+
+// Satu koneksi socket: input dirakit jadi pesan utuh, output diantre dan
+// ditulis sekaligus
+struct CollabPeer {
+    int fd = -1;
+    std::string in;
+    std::string out;
+    size_t sent = 0;
+    bool writing = false; // EPOLLOUT sedang diminta
+    bool closed = false;
+    uint64_t messages = 0; // statistik pesan keluar
+    uint64_t bytes = 0;
+
+    void queue(CollabMessage type, const std::string& payload) {
+        messages++;
+        bytes += payload.size() + 5;
+        journalPutU32(out, (uint32_t)(payload.size() + 1));
+        out += (char)type;
+        out += payload;
+    }
+
+    // false = koneksi tertutup atau error
+    bool receive() {
+        char buf[65536];
+        while (true) {
+            ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                in.append(buf, n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+
+    // Ambil satu pesan utuh dari input; false kalau belum lengkap. Pesan
+    // yang panjangnya mustahil membuat koneksi ditutup.
+    bool next(uint8_t& type, std::string& payload) {
+        if (in.size() < 4) return false;
+        uint32_t length = journalGetU32(in.data());
+        if (length == 0 || length > COLLAB_MAX_MESSAGE) {
+            closed = true;
+            return false;
+        }
+        if (in.size() < 4 + (size_t)length) return false;
+        type = (uint8_t)in[4];
+        payload.assign(in, 5, length - 1);
+        in.erase(0, 4 + (size_t)length);
+        return true;
+    }
+
+    // Tulis antrean sebanyak yang diterima socket; sisanya menunggu EPOLLOUT
+    bool flush(EventLoop& loop) {
+        while (sent < out.size()) {
+            ssize_t n = ::send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            sent += (size_t)n;
+        }
+        if (sent == out.size()) {
+            out.clear();
+            sent = 0;
+        }
+        bool want = !out.empty();
+        if (want != writing) {
+            loop.wantWrite(fd, want);
+            writing = want;
+        }
+        return true;
+    }
+};
+
+inline std::string collabDocumentText(const Document& doc) {
+    std::string text;
+    for (size_t i = 0; i < doc.lines.size(); ++i) {
+        if (i) text += '\n';
+        text += doc.lines[i];
+    }
+    return text;
+}
+
+class CollabServer {
+public:
+    std::function<void()> onRemoteEdit;  // dokumen diubah klien: gambar ulang
+    std::function<void()> onSaveRequest; // klien menekan Ctrl+S
+    std::function<void(size_t)> onClientsChanged;
+
+    CollabServer(Document& d, EventLoop& l) : doc(d), loop(l), tracker(d) {}
+
+    CollabServer(const CollabServer&) = delete;
+    CollabServer& operator=(const CollabServer&) = delete;
+
+    ~CollabServer() {
+        for (auto& client : clients)
+            drop(*client);
+        if (listenFd >= 0) {
+            loop.unwatch(listenFd);
+            ::close(listenFd);
+            unlink(socketPath.c_str());
+        }
+    }
+
+    // Socket sisa server yang crash dihapus; socket server yang masih hidup
+    // tidak disentuh
+    bool listen(const std::string& path) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe >= 0) {
+            bool alive = ::connect(probe, (sockaddr*)&addr, sizeof(addr)) == 0;
+            ::close(probe);
+            if (alive) return false;
+        }
+        unlink(path.c_str());
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) return false;
+        if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(listenFd, 16) < 0) {
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        socketPath = path;
+        loop.watch(listenFd, [this] { acceptClients(); });
+        return true;
+    }
+
+    size_t clientCount() const {
+        return clients.size();
+    }
+
+    uint32_t revision() const {
+        return rev;
+    }
+
+    uint64_t messagesSent() const {
+        return messages;
+    }
+
+    uint64_t bytesSent() const {
+        return bytes;
+    }
+
+    // Sekali per frame: edit lokal jadi satu revisi, lalu semua antrean ditulis
+    void flush() {
+        commitLocal();
+        for (auto& client : clients)
+            if (!client->closed && !client->flush(loop))
+                drop(*client);
+        size_t before = clients.size();
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                     [](const std::unique_ptr<CollabPeer>& c) { return c->closed; }),
+                      clients.end());
+        if (clients.size() != before && onClientsChanged)
+            onClientsChanged(clients.size());
+    }
+
+private:
+    Document& doc;
+    EventLoop& loop;
+    EditTracker tracker;
+    int listenFd = -1;
+    std::string socketPath;
+    std::vector<std::unique_ptr<CollabPeer>> clients;
+    std::deque<EditOp> history; // operasi revisi [historyStart, rev)
+    uint32_t historyStart = 0;
+    uint32_t rev = 0;
+    uint64_t messages = 0; // termasuk klien yang sudah putus
+    uint64_t bytes = 0;
+
+    void acceptClients() {
+        int fd;
+        while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+            doc.expand();
+            commitLocal(); // teks HELLO harus tepat di revisi yang dikirim
+            std::unique_ptr<CollabPeer> client(new CollabPeer);
+            client->fd = fd;
+            std::string hello;
+            journalPutU32(hello, rev);
+            std::string name = doc.name();
+            journalPutU32(hello, (uint32_t)name.size());
+            hello += name;
+            hello += collabDocumentText(doc);
+            client->queue(MSG_HELLO, hello);
+            CollabPeer* peer = client.get();
+            loop.watch(fd, [this, peer] { readClient(*peer); });
+            loop.watchWritable(fd, [this, peer] {
+                if (!peer->flush(loop)) drop(*peer);
+            });
+            clients.push_back(std::move(client));
+            if (onClientsChanged) onClientsChanged(clients.size());
+        }
+    }
+
+    void drop(CollabPeer& client) {
+        if (client.fd >= 0) {
+            loop.unwatch(client.fd);
+            ::close(client.fd);
+            client.fd = -1;
+        }
+        client.closed = true;
+    }
+
+    void readClient(CollabPeer& client) {
+        bool alive = client.receive();
+        uint8_t type;
+        std::string payload;
+        while (!client.closed && client.next(type, payload)) {
+            if (type == MSG_EDIT)
+                receiveEdit(client, payload);
+            else if (type == MSG_SAVE && onSaveRequest)
+                onSaveRequest();
+        }
+        if (!alive || client.closed)
+            drop(client);
+    }
+
+    void receiveEdit(CollabPeer& author, const std::string& payload) {
+        EditOp op;
+        uint32_t base = payload.size() >= 4 ? journalGetU32(payload.data()) : 0;
+        if (payload.size() < 4 || !decodeEdits(payload.data() + 4, payload.size() - 4, op) ||
+            base > rev || base < historyStart) { // terlalu tertinggal: riwayatnya sudah dibuang
+            author.closed = true;
+            return;
+        }
+        doc.expand();
+        doc.touch();
+        commitLocal();
+        for (uint32_t r = base; r < rev; ++r) {
+            EditOp earlier = history[r - historyStart]; // yang lebih dulu menang saat seri
+            transform(earlier, op);
+        }
+        if (!op.empty()) {
+            std::string encoded;
+            encodeEdits(encoded, op);
+            tracker.muted = true;
+            doc.recordOp(J_SPLICE, encoded);
+            tracker.muted = false;
+        }
+        publish(op, &author);
+        if (onRemoteEdit) onRemoteEdit();
+    }
+
+    void commitLocal() {
+        EditOp local = tracker.take();
+        if (!local.empty())
+            publish(local, nullptr);
+    }
+
+    void publish(const EditOp& op, CollabPeer* author) {
+        history.push_back(op);
+        rev++;
+        if (history.size() > COLLAB_HISTORY_MAX) {
+            history.pop_front();
+            historyStart++;
+        }
+        std::string ack, broadcast;
+        journalPutU32(ack, rev);
+        ack += (char)1;
+        journalPutU32(broadcast, rev);
+        broadcast += (char)0;
+        encodeEdits(broadcast, op);
+        for (auto& client : clients) {
+            if (client->closed) continue;
+            const std::string& message = client.get() == author ? ack : broadcast;
+            client->queue(MSG_APPLIED, message);
+            messages++;
+            bytes += message.size() + 5;
+        }
+    }
+};
+
+class CollabClient {
+public:
+    std::function<void()> onRemoteEdit;
+    std::function<void()> onDisconnect;
+
+    explicit CollabClient(EventLoop& l) : loop(l) {}
+
+    CollabClient(const CollabClient&) = delete;
+    CollabClient& operator=(const CollabClient&) = delete;
+
+    ~CollabClient() {
+        disconnect();
+    }
+
+    // Sambung ke server; connect() Unix socket selesai begitu masuk backlog,
+    // jadi server boleh berjalan di event loop yang sama (benchmark)
+    bool connect(const std::string& path) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        peer.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (peer.fd < 0) return false;
+        if (::connect(peer.fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+
+    // Terima HELLO; dokumennya lalu dipasang lewat attach(). Dengan
+    // block = false hanya membaca yang sudah ada dan false berarti belum
+    // lengkap (cek connected() untuk membedakan dari gagal); dipakai kalau
+    // server berjalan di loop yang sama dan teksnya lebih besar dari buffer
+    // socket.
+    bool handshake(bool block = true) {
+        uint8_t type = 0;
+        std::string payload;
+        char buf[65536];
+        while (!peer.next(type, payload)) {
+            ssize_t n = ::recv(peer.fd, buf, sizeof(buf), block ? 0 : MSG_DONTWAIT);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && !block && (errno == EAGAIN || errno == EWOULDBLOCK)) return false;
+            if (n <= 0 || peer.closed) {
+                disconnect();
+                return false;
+            }
+            peer.in.append(buf, n);
+        }
+        if (type != MSG_HELLO || payload.size() < 8 ||
+            payload.size() - 8 < journalGetU32(payload.data() + 4)) {
+            disconnect();
+            return false;
+        }
+        rev = journalGetU32(payload.data());
+        uint32_t nameLength = journalGetU32(payload.data() + 4);
+        name = payload.substr(8, nameLength);
+        initialText = payload.substr(8 + nameLength);
+        fcntl(peer.fd, F_SETFL, fcntl(peer.fd, F_GETFL) | O_NONBLOCK);
+        return true;
+    }
+
+    const std::string& documentName() const {
+        return name;
+    }
+
+    bool connected() const {
+        return peer.fd >= 0;
+    }
+
+    // Tidak ada edit lokal yang belum di-ack server
+    bool idle() const {
+        return !awaiting && buffer.empty();
+    }
+
+    uint64_t messagesSent() const {
+        return peer.messages;
+    }
+
+    uint64_t bytesSent() const {
+        return peer.bytes;
+    }
+
+    // Isi dokumen dengan teks dari server lalu mulai mencatat edit lokal
+    void attach(Document& d) {
+        doc = &d;
+        doc->lines.clear();
+        std::string_view rest(initialText);
+        for (size_t nl; (nl = rest.find('\n')) != std::string_view::npos; rest.remove_prefix(nl + 1))
+            doc->lines.push_back(rest.substr(0, nl));
+        doc->lines.push_back(rest);
+        doc->currentLineIndex = 0;
+        doc->currentLine = std::string(doc->lines[0]);
+        doc->cursor = 0;
+        doc->version++;
+        initialText.clear();
+        initialText.shrink_to_fit();
+        tracker.reset(new EditTracker(d));
+        loop.watch(peer.fd, [this] { readServer(); });
+        loop.watchWritable(peer.fd, [this] {
+            if (!peer.flush(loop)) lost();
+        });
+        readServer(); // pesan yang ikut terbaca bersama HELLO
+    }
+
+    // Sekali per frame: kirim edit lokal (kalau tidak ada yang menunggu ack)
+    void flush() {
+        if (!connected() || !tracker) return;
+        EditOp local = tracker->take();
+        buffer.insert(buffer.end(), local.begin(), local.end());
+        if (!awaiting && !buffer.empty()) {
+            std::string message;
+            journalPutU32(message, rev);
+            encodeEdits(message, buffer);
+            peer.queue(MSG_EDIT, message);
+            outstanding.swap(buffer);
+            buffer.clear();
+            awaiting = true;
+        }
+        if (saveQueued && buffer.empty()) { // setelah semua edit lokal terkirim
+            peer.queue(MSG_SAVE, "");
+            saveQueued = false;
+        }
+        if (!peer.flush(loop)) lost();
+    }
+
+    // Penyimpanan dilakukan server (pemilik file)
+    void requestSave() {
+        saveQueued = true;
+        if (doc) doc->modified = false;
+        flush();
+    }
+
+private:
+    EventLoop& loop;
+    CollabPeer peer;
+    Document* doc = nullptr;
+    std::unique_ptr<EditTracker> tracker;
+    std::string name;
+    std::string initialText;
+    uint32_t rev = 0;      // revisi server terakhir yang sudah diterapkan
+    bool awaiting = false; // outstanding sudah dikirim, menunggu ack
+    bool saveQueued = false;
+    EditOp outstanding;
+    EditOp buffer;
+
+    void disconnect() {
+        if (peer.fd < 0) return;
+        if (doc) loop.unwatch(peer.fd);
+        ::close(peer.fd);
+        peer.fd = -1;
+    }
+
+    void lost() {
+        disconnect();
+        if (onDisconnect) onDisconnect();
+    }
+
+    void readServer() {
+        bool alive = peer.receive();
+        uint8_t type;
+        std::string payload;
+        while (connected() && peer.next(type, payload))
+            if (type == MSG_APPLIED) receiveApplied(payload);
+        if (!alive || peer.closed)
+            lost();
+    }
+
+    void receiveApplied(const std::string& payload) {
+        if (payload.size() < 5) return;
+        uint32_t revision = journalGetU32(payload.data());
+        if (payload[4]) { // ack operasi kita sendiri
+            rev = revision;
+            awaiting = false;
+            outstanding.clear();
+            return;
+        }
+        EditOp op;
+        if (!decodeEdits(payload.data() + 5, payload.size() - 5, op)) return;
+        EditOp local = tracker->take();
+        buffer.insert(buffer.end(), local.begin(), local.end());
+        // Di server operasi ini lebih dulu dari outstanding dan buffer kita
+        if (awaiting) transform(op, outstanding);
+        transform(op, buffer);
+        rev = revision;
+        if (op.empty()) return;
+        tracker->muted = true;
+        doc->applyEdits(op);
+        doc->version++; // bukan perubahan lokal: tidak menandai modified
+        tracker->muted = false;
+        if (onRemoteEdit) onRemoteEdit();
+    }
+};
+
+#endif
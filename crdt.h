@@ -0,0 +1,687 @@
+#ifndef CRDT_H
+#define CRDT_H
+
+// Buffer teks CRDT urutan (YATA, algoritma integrasi yang sama dengan Yjs)
+// untuk edit bersamaan antar proses tanpa server yang mengurutkan.
+//
+// Setiap byte punya ID unik (agent, seq); seq naik per agent. Sisipan
+// menyimpan ID tetangga kiri dan kanan saat dibuat (origin), dan replika
+// lain menempatkannya di antara keduanya; kalau ada sisipan lain di celah
+// yang sama, urutannya ditentukan aturan YATA, jadi semua replika sampai ke
+// teks yang sama tanpa peduli urutan op datang.
+//
+// Run-length: satu Item menyimpan rangkaian byte dengan seq berurutan dari
+// agent yang sama, jadi kata (atau kalimat) yang diketik berurutan tetap
+// satu Item, mirip granularitas Node di ets.cpp. Item dipecah hanya saat
+// ada sisipan/hapus di tengahnya. Teksnya tidak disimpan per Item tapi di
+// satu buffer `content` (Item cukup menyimpan offset).
+//
+// Backspace di ujung ketikan yang belum dikirim (masih di op terakhir
+// `out`) tidak meninggalkan tombstone: byte-nya dibuang dan seq-nya dipakai
+// lagi, jadi ketikan berikutnya tetap menyambung Item yang sama.
+//
+// Hapus lainnya tidak membuang Item (replika lain mungkin masih memakainya
+// sebagai origin), hanya menandainya tombstone. Garbage collection: isi tombstone
+// dibuang dari content dan tombstone yang bersebelahan digabung lagi jadi
+// satu Item saat compact().
+//
+// Posisi di sini offset byte seperti textedit.h; merge() mengembalikan
+// perubahan sebagai EditOp yang bisa langsung diterapkan ke Document.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include "textedit.h"
+
+struct CrdtId {
+    uint32_t agent = 0; // 0 = tidak ada (awal / akhir dokumen)
+    uint32_t seq = 0;
+
+    bool operator==(const CrdtId& other) const {
+        return agent == other.agent && seq == other.seq;
+    }
+
+    bool operator!=(const CrdtId& other) const {
+        return !(*this == other);
+    }
+};
+
+// Satu op antar replika: sisip satu run, atau hapus `length` byte milik
+// id.agent mulai dari id.seq
+struct CrdtOp {
+    bool insert = false;
+    CrdtId id;
+    uint32_t length = 0;
+    CrdtId left;  // origin: byte tepat di kiri saat dibuat
+    CrdtId right; // origin: item tepat di kanan saat dibuat
+    std::string text;
+};
+
+inline void crdtPutVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out += (char)(v | 0x80);
+        v >>= 7;
+    }
+    out += (char)v;
+}
+
+inline bool crdtGetVarint(const char*& p, const char* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t byte = (uint8_t)*p++;
+        v |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// ID ringkas: varint, dan origin kiri yang hampir selalu "byte sebelumnya
+// dari agent yang sama" (ketikan berurutan) cukup satu bit di flag
+enum CrdtOpFlag : uint8_t {
+    CRDT_INSERT = 1,
+    CRDT_LEFT_NONE = 2,
+    CRDT_LEFT_PREV = 4,
+    CRDT_RIGHT_NONE = 8
+};
+
+inline void encodeCrdtOps(std::string& out, const std::vector<CrdtOp>& ops) {
+    crdtPutVarint(out, ops.size());
+    for (const CrdtOp& op : ops) {
+        uint8_t flags = op.insert ? CRDT_INSERT : 0;
+        if (op.insert) {
+            if (op.left.agent == 0) flags |= CRDT_LEFT_NONE;
+            else if (op.left.agent == op.id.agent && op.left.seq + 1 == op.id.seq) flags |= CRDT_LEFT_PREV;
+            if (op.right.agent == 0) flags |= CRDT_RIGHT_NONE;
+        }
+        out += (char)flags;
+        crdtPutVarint(out, op.id.agent);
+        crdtPutVarint(out, op.id.seq);
+        if (!op.insert) {
+            crdtPutVarint(out, op.length);
+            continue;
+        }
+        if (!(flags & (CRDT_LEFT_NONE | CRDT_LEFT_PREV))) {
+            crdtPutVarint(out, op.left.agent);
+            crdtPutVarint(out, op.left.seq);
+        }
+        if (!(flags & CRDT_RIGHT_NONE)) {
+            crdtPutVarint(out, op.right.agent);
+            crdtPutVarint(out, op.right.seq);
+        }
+        crdtPutVarint(out, op.text.size());
+        out += op.text;
+    }
+}
+
+// false jika data terpotong atau rusak
+inline bool decodeCrdtOps(const char* p, size_t n, std::vector<CrdtOp>& ops) {
+    const char* end = p + n;
+    uint64_t count, a, b;
+    ops.clear();
+    if (!crdtGetVarint(p, end, count)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (p >= end) return false;
+        uint8_t flags = (uint8_t)*p++;
+        CrdtOp op;
+        op.insert = flags & CRDT_INSERT;
+        if (!crdtGetVarint(p, end, a) || !crdtGetVarint(p, end, b) || a == 0) return false;
+        op.id = {(uint32_t)a, (uint32_t)b};
+        if (!op.insert) {
+            if (!crdtGetVarint(p, end, a)) return false;
+            op.length = (uint32_t)a;
+            ops.push_back(std::move(op));
+            continue;
+        }
+        if (flags & CRDT_LEFT_PREV) {
+            op.left = {op.id.agent, op.id.seq - 1};
+        } else if (!(flags & CRDT_LEFT_NONE)) {
+            if (!crdtGetVarint(p, end, a) || !crdtGetVarint(p, end, b)) return false;
+            op.left = {(uint32_t)a, (uint32_t)b};
+        }
+        if (!(flags & CRDT_RIGHT_NONE)) {
+            if (!crdtGetVarint(p, end, a) || !crdtGetVarint(p, end, b)) return false;
+            op.right = {(uint32_t)a, (uint32_t)b};
+        }
+        if (!crdtGetVarint(p, end, a) || (uint64_t)(end - p) < a || a == 0) return false;
+        op.text.assign(p, a);
+        op.length = (uint32_t)a;
+        p += a;
+        ops.push_back(std::move(op));
+    }
+    return true;
+}
+
+class CrdtText {
+public:
+    // agent harus unik antar replika dan bukan 0 (mis. pid)
+    explicit CrdtText(uint32_t agentId) : me(agentId) {}
+
+    CrdtText(const CrdtText&) = delete;
+    CrdtText& operator=(const CrdtText&) = delete;
+
+    ~CrdtText() {
+        for (Block* block : blocks)
+            delete block;
+    }
+
+    uint32_t agent() const {
+        return me;
+    }
+
+    size_t size() const {
+        return visible;
+    }
+
+    size_t itemCount() const {
+        return items;
+    }
+
+    size_t pendingOps() const {
+        return pending.size();
+    }
+
+    std::string text() const {
+        std::string out;
+        out.reserve(visible);
+        for (const Block* block : blocks)
+            for (const Item* it : block->items)
+                if (!it->deleted) out.append(content, it->offset, it->length);
+        return out;
+    }
+
+    // Heap yang dipakai: pool Item, blok, content, index ID dan pohon blok
+    size_t memoryBytes() const {
+        size_t bytes = chunks.size() * POOL_CHUNK * sizeof(Item) + freeItems.capacity() * sizeof(Item*);
+        bytes += content.capacity() + tree.capacity() * sizeof(uint64_t) + blocks.capacity() * sizeof(Block*);
+        for (const Block* block : blocks)
+            bytes += sizeof(Block) + block->items.capacity() * sizeof(Item*);
+        for (const auto& entry : byAgent)
+            bytes += entry.second.capacity() * sizeof(Item*) + 48;
+        return bytes;
+    }
+
+    // Edit lokal. Op untuk replika lain ditambahkan ke `out`.
+    void insert(size_t pos, std::string_view text, std::vector<CrdtOp>& out) {
+        if (text.empty()) return;
+        pos = std::min(pos, visible);
+        Item* left = pos ? leftOf(pos) : nullptr;
+        Item* right = left ? next(left) : first();
+        CrdtOp op;
+        op.insert = true;
+        op.id = {me, clock[me]};
+        op.length = (uint32_t)text.size();
+        op.left = left ? left->lastId() : CrdtId{};
+        op.right = right ? right->id : CrdtId{};
+        op.text = std::string(text);
+        integrate(op, nullptr);
+        if (!out.empty() && extends(out.back(), op)) {
+            out.back().text += op.text;
+            out.back().length += op.length;
+        } else {
+            out.push_back(std::move(op));
+        }
+        maybeCompact();
+    }
+
+    void remove(size_t pos, size_t length, std::vector<CrdtOp>& out) {
+        if (pos >= visible) return;
+        length = std::min(length, visible - pos);
+        uint32_t offset = 0;
+        Item* it = itemAt(pos, offset);
+        if (offset && offset + length == it->length && untype(it, (uint32_t)length, out)) return;
+        if (offset) it = split(it, offset);
+        while (length > 0) {
+            if (!it->deleted) {
+                if (it->length > length) split(it, (uint32_t)length);
+                markDeleted(it);
+                length -= it->length;
+                CrdtOp* last = out.empty() ? nullptr : &out.back();
+                if (last && !last->insert && last->id.agent == it->id.agent &&
+                    last->id.seq + last->length == it->id.seq) {
+                    last->length += it->length;
+                } else {
+                    CrdtOp op;
+                    op.id = it->id;
+                    op.length = it->length;
+                    out.push_back(std::move(op));
+                }
+            }
+            it = next(it);
+        }
+        maybeCompact();
+    }
+
+    // Integrasikan op dari replika lain (urutan antar agent bebas, op dari
+    // satu agent harus datang berurutan). Op yang dependensinya belum ada
+    // disimpan dan dicoba lagi di merge berikutnya. Perubahan teks lokal
+    // ditambahkan ke `edits`.
+    void merge(const std::vector<CrdtOp>& ops, EditOp* edits = nullptr) {
+        pending.insert(pending.end(), ops.begin(), ops.end());
+        bool progress = true;
+        while (progress && !pending.empty()) {
+            progress = false;
+            std::vector<CrdtOp> waiting;
+            for (CrdtOp& op : pending) {
+                Ready state = ready(op);
+                if (state == WAIT) {
+                    waiting.push_back(std::move(op));
+                    continue;
+                }
+                if (state == APPLY) {
+                    if (op.insert) integrate(op, edits);
+                    else erase(op, edits);
+                }
+                progress = true;
+            }
+            pending.swap(waiting);
+        }
+        maybeCompact();
+    }
+
+    // Garbage collection tombstone: isi byte yang sudah dihapus dibuang dari
+    // content, Item bersebelahan yang bisa disambung (termasuk deretan
+    // tombstone) digabung lagi, lalu blok dan index disusun ulang
+    void compact() {
+        std::vector<Item*> order;
+        order.reserve(items);
+        std::string live;
+        live.reserve(content.size() - deadBytes);
+        for (Block* block : blocks) {
+            for (Item* it : block->items) {
+                if (!it->deleted) {
+                    uint32_t offset = (uint32_t)live.size();
+                    live.append(content, it->offset, it->length);
+                    it->offset = offset;
+                }
+                Item* last = order.empty() ? nullptr : order.back();
+                if (last && it->id.agent == last->id.agent && it->id.seq == last->id.seq + last->length &&
+                    it->left == last->lastId() && it->right == last->right && it->deleted == last->deleted &&
+                    (it->deleted || it->offset == last->offset + last->length)) {
+                    last->length += it->length;
+                    freeItem(it);
+                } else {
+                    order.push_back(it);
+                }
+            }
+            delete block;
+        }
+        content.swap(live);
+        deadBytes = 0;
+        blocks.clear();
+        for (size_t i = 0; i < order.size(); i += BLOCK_MAX / 2) {
+            Block* block = new Block;
+            block->items.assign(order.begin() + i, order.begin() + std::min(order.size(), i + BLOCK_MAX / 2));
+            for (Item* it : block->items) {
+                it->block = block;
+                block->visible += visibleLength(it);
+            }
+            blocks.push_back(block);
+        }
+        for (auto& entry : byAgent)
+            entry.second.clear();
+        for (Item* it : order)
+            byAgent[it->id.agent].push_back(it);
+        for (auto& entry : byAgent)
+            std::sort(entry.second.begin(), entry.second.end(),
+                      [](const Item* a, const Item* b) { return a->id.seq < b->id.seq; });
+        renumberBlocks(0);
+    }
+
+private:
+    struct Block;
+
+    // 48 byte; diambil dari pool supaya tanpa header malloc per Item
+    struct Item {
+        CrdtId id;
+        CrdtId left;   // origin byte pertama; byte berikutnya ber-origin byte sebelumnya
+        CrdtId right;  // origin kanan, sama untuk seluruh run
+        uint32_t length = 0;
+        uint32_t offset = 0; // di content; tidak berarti lagi kalau deleted
+        Block* block = nullptr;
+        bool deleted = false;
+
+        CrdtId lastId() const {
+            return {id.agent, id.seq + length - 1};
+        }
+    };
+
+    // Urutan dokumen = Item di blocks[0], blocks[1], ... Panjang terlihat
+    // tiap blok dijumlah di pohon Fenwick, jadi posisi <-> Item O(log n + B)
+    struct Block {
+        std::vector<Item*> items;
+        uint64_t visible = 0;
+        size_t index = 0;
+    };
+
+    enum Ready { APPLY, SKIP, WAIT };
+
+    static const size_t BLOCK_MAX = 128;
+    static const size_t POOL_CHUNK = 1024;
+    static const size_t COMPACT_MIN_BYTES = 1 << 16;
+
+    uint32_t me;
+    std::vector<Block*> blocks;
+    std::vector<uint64_t> tree; // Fenwick atas Block::visible, 1-based
+    std::vector<std::unique_ptr<Item[]>> chunks;
+    size_t chunkUsed = POOL_CHUNK;
+    std::vector<Item*> freeItems;
+    std::string content; // teks semua Item, hanya ditambah (dirapikan di compact)
+    std::unordered_map<uint32_t, std::vector<Item*>> byAgent; // terurut seq
+    std::unordered_map<uint32_t, uint32_t> clock;             // seq berikutnya per agent
+    std::vector<CrdtOp> pending;
+    size_t visible = 0;
+    size_t items = 0;
+    size_t deadBytes = 0; // byte content milik tombstone
+
+    static uint32_t visibleLength(const Item* it) {
+        return it->deleted ? 0 : it->length;
+    }
+
+    // Op sisip lokal yang menyambung op sebelumnya di antrean keluar
+    static bool extends(const CrdtOp& last, const CrdtOp& op) {
+        return last.insert && last.id.agent == op.id.agent && last.id.seq + last.length == op.id.seq &&
+               op.left == CrdtId{op.id.agent, op.id.seq - 1} && last.right == op.right;
+    }
+
+    Item* newItem() {
+        items++;
+        if (!freeItems.empty()) {
+            Item* it = freeItems.back();
+            freeItems.pop_back();
+            *it = Item();
+            return it;
+        }
+        if (chunkUsed == POOL_CHUNK) {
+            chunks.emplace_back(new Item[POOL_CHUNK]);
+            chunkUsed = 0;
+        }
+        return &chunks.back()[chunkUsed++];
+    }
+
+    void freeItem(Item* it) {
+        items--;
+        freeItems.push_back(it);
+    }
+
+    void treeAdd(size_t index, int64_t delta) {
+        for (size_t i = index + 1; i < tree.size(); i += i & (~i + 1))
+            tree[i] += delta;
+    }
+
+    // Jumlah visible blok [0, index)
+    uint64_t treePrefix(size_t index) const {
+        uint64_t sum = 0;
+        for (size_t i = index; i > 0; i -= i & (~i + 1))
+            sum += tree[i];
+        return sum;
+    }
+
+    void renumberBlocks(size_t from) {
+        for (size_t i = from; i < blocks.size(); ++i)
+            blocks[i]->index = i;
+        tree.assign(blocks.size() + 1, 0);
+        for (size_t i = 1; i < tree.size(); ++i) {
+            tree[i] += blocks[i - 1]->visible;
+            size_t parent = i + (i & (~i + 1));
+            if (parent < tree.size()) tree[parent] += tree[i];
+        }
+    }
+
+    void changeVisible(Item* it, int64_t delta) {
+        visible += delta;
+        it->block->visible += delta;
+        treeAdd(it->block->index, delta);
+    }
+
+    static size_t indexIn(const Block* block, const Item* it) {
+        return std::find(block->items.begin(), block->items.end(), it) - block->items.begin();
+    }
+
+    Item* first() const {
+        return blocks.empty() ? nullptr : blocks.front()->items.front();
+    }
+
+    Item* next(const Item* it) const {
+        const Block* block = it->block;
+        size_t i = indexIn(block, it) + 1;
+        if (i < block->items.size()) return block->items[i];
+        return block->index + 1 < blocks.size() ? blocks[block->index + 1]->items.front() : nullptr;
+    }
+
+    Item* find(CrdtId id) const {
+        auto entry = byAgent.find(id.agent);
+        if (entry == byAgent.end()) return nullptr;
+        const std::vector<Item*>& list = entry->second;
+        auto pos = std::upper_bound(list.begin(), list.end(), id.seq,
+                                    [](uint32_t seq, const Item* it) { return seq < it->id.seq; });
+        if (pos == list.begin()) return nullptr;
+        Item* it = *(pos - 1);
+        return id.seq < it->id.seq + it->length ? it : nullptr;
+    }
+
+    void indexItem(Item* it) {
+        std::vector<Item*>& list = byAgent[it->id.agent];
+        auto pos = std::upper_bound(list.begin(), list.end(), it->id.seq,
+                                    [](uint32_t seq, const Item* other) { return seq < other->id.seq; });
+        list.insert(pos, it);
+    }
+
+    // Sisipkan Item tepat setelah `left` (nullptr = di awal dokumen)
+    void linkAfter(Item* left, Item* it) {
+        Block* block;
+        size_t at;
+        if (left) {
+            block = left->block;
+            at = indexIn(block, left) + 1;
+        } else {
+            if (blocks.empty()) {
+                blocks.push_back(new Block);
+                renumberBlocks(0);
+            }
+            block = blocks.front();
+            at = 0;
+        }
+        block->items.insert(block->items.begin() + at, it);
+        it->block = block;
+        if (!it->deleted) changeVisible(it, it->length);
+        if (block->items.size() > BLOCK_MAX) {
+            Block* half = new Block;
+            half->items.assign(block->items.begin() + BLOCK_MAX / 2, block->items.end());
+            block->items.resize(BLOCK_MAX / 2);
+            for (Item* moved : half->items) {
+                moved->block = half;
+                half->visible += visibleLength(moved);
+            }
+            block->visible -= half->visible;
+            blocks.insert(blocks.begin() + block->index + 1, half);
+            renumberBlocks(block->index + 1);
+        }
+    }
+
+    // Pecah Item di offset k (0 < k < length); bagian kanan dikembalikan
+    Item* split(Item* it, uint32_t k) {
+        Item* right = newItem();
+        right->id = {it->id.agent, it->id.seq + k};
+        right->length = it->length - k;
+        right->offset = it->offset + k;
+        right->left = {it->id.agent, it->id.seq + k - 1};
+        right->right = it->right;
+        right->deleted = it->deleted;
+        if (!it->deleted) changeVisible(it, -(int64_t)right->length);
+        it->length = k;
+        linkAfter(it, right);
+        indexItem(right);
+        return right;
+    }
+
+    // Item berisi byte terlihat ke-pos; offset = posisi di dalam Item
+    Item* itemAt(size_t pos, uint32_t& offset) const {
+        size_t index = 0;
+        uint64_t rest = pos;
+        size_t step = 1;
+        while (step * 2 < tree.size()) step *= 2;
+        for (; step > 0; step /= 2) {
+            if (index + step < tree.size() && tree[index + step] <= rest) {
+                index += step;
+                rest -= tree[index];
+            }
+        }
+        for (Item* it : blocks[index]->items) {
+            if (!it->deleted && rest < it->length) {
+                offset = (uint32_t)rest;
+                return it;
+            }
+            rest -= visibleLength(it);
+        }
+        return nullptr; // tidak terjadi untuk pos < visible
+    }
+
+    // Item yang berakhir tepat di byte terlihat ke-(pos - 1)
+    Item* leftOf(size_t pos) {
+        uint32_t offset = 0;
+        Item* it = itemAt(pos - 1, offset);
+        if (offset + 1 < it->length) split(it, offset + 1);
+        return it;
+    }
+
+    size_t positionOf(const Item* target) const {
+        size_t pos = treePrefix(target->block->index);
+        for (const Item* it : target->block->items) {
+            if (it == target) break;
+            pos += visibleLength(it);
+        }
+        return pos;
+    }
+
+    // Buang `length` byte terakhir Item lokal kalau byte itu juga ekor op
+    // sisip terakhir di `out` (belum dikirim, jadi belum ada replika yang
+    // bisa memakainya sebagai origin) dan ekor content
+    bool untype(Item* it, uint32_t length, std::vector<CrdtOp>& out) {
+        if (out.empty() || it->id.agent != me) return false;
+        CrdtOp& last = out.back();
+        uint32_t end = it->id.seq + it->length;
+        if (!last.insert || last.id.agent != me || last.id.seq + last.length != end || last.length < length ||
+            clock[me] != end || it->offset + it->length != content.size())
+            return false;
+        changeVisible(it, -(int64_t)length);
+        it->length -= length;
+        content.resize(content.size() - length);
+        clock[me] = end - length;
+        last.length -= length;
+        last.text.resize(last.length);
+        if (!last.length) out.pop_back();
+        return true;
+    }
+
+    void markDeleted(Item* it) {
+        changeVisible(it, -(int64_t)it->length);
+        it->deleted = true;
+        deadBytes += it->length;
+    }
+
+    Ready ready(const CrdtOp& op) {
+        auto known = clock.find(op.id.agent);
+        uint32_t expected = known == clock.end() ? 0 : known->second;
+        if (op.insert) {
+            if (op.id.seq < expected) return SKIP; // sudah pernah diterima
+            if (op.id.seq > expected) return WAIT;
+            if (op.left.agent && !find(op.left)) return WAIT;
+            if (op.right.agent && !find(op.right)) return WAIT;
+            return APPLY;
+        }
+        return op.id.seq + op.length <= expected ? APPLY : WAIT;
+    }
+
+    // YATA: mulai dari origin kiri, lewati item lain yang bersaing di celah
+    // yang sama sampai posisi yang disepakati semua replika
+    void integrate(const CrdtOp& op, EditOp* edits) {
+        Item* left = nullptr;
+        if (op.left.agent) {
+            left = find(op.left);
+            uint32_t k = op.left.seq - left->id.seq + 1;
+            if (k < left->length) split(left, k);
+        }
+        Item* right = nullptr;
+        if (op.right.agent) {
+            right = find(op.right);
+            if (right->id.seq < op.right.seq) right = split(right, op.right.seq - right->id.seq);
+        }
+        Item* o = left ? next(left) : first();
+        if (o != right) {
+            std::unordered_set<const Item*> beforeOrigin, conflicting;
+            while (o && o != right) {
+                beforeOrigin.insert(o);
+                conflicting.insert(o);
+                if (o->left == op.left) {
+                    if (o->id.agent < op.id.agent) {
+                        left = o;
+                        conflicting.clear();
+                    } else if (o->right == op.right) {
+                        break;
+                    }
+                } else if (o->left.agent && beforeOrigin.count(find(o->left))) {
+                    if (!conflicting.count(find(o->left))) {
+                        left = o;
+                        conflicting.clear();
+                    }
+                } else {
+                    break;
+                }
+                o = next(o);
+            }
+        }
+
+        size_t pos = left ? positionOf(left) + visibleLength(left) : 0;
+        uint32_t offset = (uint32_t)content.size();
+        content += op.text;
+        clock[op.id.agent] = op.id.seq + op.length;
+        if (left && !left->deleted && left->id.agent == op.id.agent && left->lastId() == op.left &&
+            left->id.seq + left->length == op.id.seq && left->right == op.right &&
+            left->offset + left->length == offset) {
+            left->length += op.length; // run-length: ketikan berurutan tetap satu Item
+            changeVisible(left, op.length);
+        } else {
+            Item* it = newItem();
+            it->id = op.id;
+            it->length = op.length;
+            it->offset = offset;
+            it->left = op.left;
+            it->right = op.right;
+            linkAfter(left, it);
+            indexItem(it);
+        }
+        if (edits) edits->push_back(TextEdit::insertion(pos, op.text));
+    }
+
+    void erase(const CrdtOp& op, EditOp* edits) {
+        uint32_t seq = op.id.seq, end = op.id.seq + op.length;
+        while (seq < end) {
+            Item* it = find({op.id.agent, seq});
+            if (it->id.seq < seq) it = split(it, seq - it->id.seq);
+            if (it->id.seq + it->length > end) split(it, end - it->id.seq);
+            if (!it->deleted) {
+                size_t pos = positionOf(it);
+                markDeleted(it);
+                if (edits) {
+                    if (!edits->empty() && !edits->back().insert && edits->back().pos == pos)
+                        edits->back().len += it->length;
+                    else
+                        edits->push_back(TextEdit::deletion(pos, it->length));
+                }
+            }
+            seq = it->id.seq + it->length;
+        }
+    }
+
+    void maybeCompact() {
+        if (deadBytes >= COMPACT_MIN_BYTES && deadBytes * 2 > content.size())
+            compact();
+    }
+};
+
+#endif
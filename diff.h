@@ -0,0 +1,243 @@
+#ifndef DIFF_H
+#define DIFF_H
+
+// Diff baris (Myers, ruang linear).
+//
+// Input berupa hash 64-bit setiap baris, jadi baris dibandingkan sebagai
+// angka; peluang dua baris berbeda punya hash sama di dokumen jutaan baris
+// ~1e-7, diterima tanpa membandingkan isi. Sebelum Myers:
+// - awalan dan akhiran yang sama dibuang,
+// - baris yang tidak muncul sama sekali di sisi lain langsung ditandai
+//   berubah dan tidak ikut dicari (seperti xdiff), jadi dua file yang
+//   hampir seluruhnya berbeda tetap cepat.
+// Myers mencari titik tengah jalur edit (bisect) lalu membagi dua secara
+// rekursif, memori O(N + M). Kalau jarak edit sangat besar, pencarian
+// dibatasi ~sqrt(N + M) langkah dan hasilnya boleh tidak minimal; total
+// kerja jadi O((N + M) * sqrt(N + M)) paling buruk.
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+struct DiffHunk {
+    uint32_t oldStart; // baris di sisi lama (file)
+    uint32_t oldCount;
+    uint32_t newStart; // baris di sisi baru (buffer)
+    uint32_t newCount;
+};
+
+class LineDiff {
+public:
+    std::vector<DiffHunk> run(const std::vector<uint64_t>& oldLines, const std::vector<uint64_t>& newLines) {
+        a = &oldLines;
+        b = &newLines;
+        size_t n = oldLines.size(), m = newLines.size();
+        oldChanged.assign(n, 0);
+        newChanged.assign(m, 0);
+
+        // Awalan dan akhiran yang sama
+        size_t lo = 0;
+        while (lo < n && lo < m && oldLines[lo] == newLines[lo])
+            lo++;
+        size_t endA = n, endB = m;
+        while (endA > lo && endB > lo && oldLines[endA - 1] == newLines[endB - 1]) {
+            endA--;
+            endB--;
+        }
+
+        // Baris yang hanya ada di satu sisi tidak mungkin cocok. Keanggotaan
+        // dicek lewat bitmap ~8 bit per baris (muat di cache, tidak seperti
+        // tabel hash jutaan entri); bit yang kebetulan bertabrakan hanya
+        // membuat baris ikut Myers, hasilnya tetap benar.
+        bitShift = 64 - 6;
+        while ((1ull << (64 - bitShift)) < 8 * (endA - lo + endB - lo) && bitShift > 32)
+            bitShift--;
+        inOld.assign((1ull << (64 - bitShift)) / 64, 0);
+        inNew.assign(inOld.size(), 0);
+        for (size_t i = lo; i < endA; ++i) mark(inOld, oldLines[i]);
+        for (size_t j = lo; j < endB; ++j) mark(inNew, newLines[j]);
+        ra.clear();
+        rb.clear();
+        for (size_t i = lo; i < endA; ++i) {
+            if (marked(inNew, oldLines[i])) ra.push_back((uint32_t)i);
+            else oldChanged[i] = 1;
+        }
+        for (size_t j = lo; j < endB; ++j) {
+            if (marked(inOld, newLines[j])) rb.push_back((uint32_t)j);
+            else newChanged[j] = 1;
+        }
+
+        maxCost = std::max<long>(256, (long)std::sqrt((double)(ra.size() + rb.size())));
+        compare(0, ra.size(), 0, rb.size());
+        return hunks();
+    }
+
+private:
+    const std::vector<uint64_t>* a = nullptr;
+    const std::vector<uint64_t>* b = nullptr;
+    std::vector<uint32_t> ra, rb;           // indeks baris yang ikut Myers
+    std::vector<uint8_t> oldChanged, newChanged;
+    std::vector<long> forward, backward;    // V Myers, dipakai ulang antar level rekursi
+    std::vector<uint64_t> inOld, inNew;     // bitmap hash baris tiap sisi
+    int bitShift = 0;
+    long maxCost = 0;
+
+    size_t bitOf(uint64_t h) const {
+        return (size_t)((h * 0x9e3779b97f4a7c15ull) >> bitShift);
+    }
+
+    void mark(std::vector<uint64_t>& set, uint64_t h) const {
+        size_t bit = bitOf(h);
+        set[bit >> 6] |= 1ull << (bit & 63);
+    }
+
+    bool marked(const std::vector<uint64_t>& set, uint64_t h) const {
+        size_t bit = bitOf(h);
+        return set[bit >> 6] >> (bit & 63) & 1;
+    }
+
+    bool same(size_t x, size_t y) const {
+        return (*a)[ra[x]] == (*b)[rb[y]];
+    }
+
+    void compare(size_t aLo, size_t aHi, size_t bLo, size_t bHi) {
+        while (aLo < aHi && bLo < bHi && same(aLo, bLo)) {
+            aLo++;
+            bLo++;
+        }
+        while (aLo < aHi && bLo < bHi && same(aHi - 1, bHi - 1)) {
+            aHi--;
+            bHi--;
+        }
+        if (aLo == aHi) {
+            for (size_t y = bLo; y < bHi; ++y) newChanged[rb[y]] = 1;
+            return;
+        }
+        if (bLo == bHi) {
+            for (size_t x = aLo; x < aHi; ++x) oldChanged[ra[x]] = 1;
+            return;
+        }
+        size_t x, y;
+        bisect(aLo, aHi, bLo, bHi, x, y);
+        compare(aLo, x, bLo, y);
+        compare(x, aHi, y, bHi);
+    }
+
+    // Titik (x, y) di jalur edit terpendek yang membagi masalah jadi dua
+    void bisect(size_t aLo, size_t aHi, size_t bLo, size_t bHi, size_t& splitX, size_t& splitY) {
+        long n = (long)(aHi - aLo), m = (long)(bHi - bLo);
+        long maxD = (n + m + 1) / 2;
+        long reach = std::min(maxD, maxCost + 1) + 1; // diagonal terjauh yang mungkin disentuh
+        long offset = reach + 1;
+        long length = 2 * reach + 3;
+        forward.assign(length, -1);
+        backward.assign(length, -1);
+        forward[offset + 1] = 0;
+        backward[offset + 1] = 0;
+        long delta = n - m;
+        bool front = delta & 1; // jalur maju yang bertemu jalur mundur
+        long k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+        long bestX = 0, bestY = 0;
+
+        for (long d = 0; d < maxD; ++d) {
+            if (d > maxCost && bestX + bestY > 0) {
+                // Terlalu mahal: bagi di titik maju terjauh, hasil tidak minimal
+                splitX = aLo + bestX;
+                splitY = bLo + bestY;
+                return;
+            }
+            for (long k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+                long k1o = offset + k1;
+                long x1 = (k1 == -d || (k1 != d && forward[k1o - 1] < forward[k1o + 1]))
+                              ? forward[k1o + 1] : forward[k1o - 1] + 1;
+                long y1 = x1 - k1;
+                while (x1 < n && y1 < m && same(aLo + x1, bLo + y1)) {
+                    x1++;
+                    y1++;
+                }
+                forward[k1o] = x1;
+                if (x1 > n) {
+                    k1end += 2;
+                } else if (y1 > m) {
+                    k1start += 2;
+                } else {
+                    if (x1 + y1 > bestX + bestY && (x1 < n || y1 < m)) {
+                        bestX = x1;
+                        bestY = y1;
+                    }
+                    if (front) {
+                        long k2o = offset + delta - k1;
+                        if (k2o >= 0 && k2o < length && backward[k2o] != -1 && x1 >= n - backward[k2o]) {
+                            splitX = aLo + x1;
+                            splitY = bLo + y1;
+                            return;
+                        }
+                    }
+                }
+            }
+            for (long k2 = -d + k2start; k2 <= d - k2end; k2 += 2) {
+                long k2o = offset + k2;
+                long x2 = (k2 == -d || (k2 != d && backward[k2o - 1] < backward[k2o + 1]))
+                              ? backward[k2o + 1] : backward[k2o - 1] + 1;
+                long y2 = x2 - k2;
+                while (x2 < n && y2 < m && same(aLo + n - x2 - 1, bLo + m - y2 - 1)) {
+                    x2++;
+                    y2++;
+                }
+                backward[k2o] = x2;
+                if (x2 > n) {
+                    k2end += 2;
+                } else if (y2 > m) {
+                    k2start += 2;
+                } else if (!front) {
+                    long k1o = offset + delta - k2;
+                    if (k1o >= 0 && k1o < length && forward[k1o] != -1) {
+                        long x1 = forward[k1o];
+                        long y1 = offset + x1 - k1o;
+                        if (x1 >= n - x2) {
+                            splitX = aLo + x1;
+                            splitY = bLo + y1;
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+        // Tidak ada yang sama: semua baris berubah
+        splitX = aHi;
+        splitY = bLo;
+    }
+
+    // Baris tidak berubah di kedua sisi berpasangan berurutan; di antaranya hunk
+    std::vector<DiffHunk> hunks() const {
+        std::vector<DiffHunk> out;
+        size_t n = oldChanged.size(), m = newChanged.size();
+        size_t i = 0, j = 0;
+        while (i < n || j < m) {
+            if (i < n && j < m && !oldChanged[i] && !newChanged[j]) {
+                i++;
+                j++;
+                continue;
+            }
+            DiffHunk h{(uint32_t)i, 0, (uint32_t)j, 0};
+            while (i < n && oldChanged[i]) {
+                i++;
+                h.oldCount++;
+            }
+            while (j < m && newChanged[j]) {
+                j++;
+                h.newCount++;
+            }
+            out.push_back(h);
+        }
+        return out;
+    }
+};
+
+inline std::vector<DiffHunk> diffLines(const std::vector<uint64_t>& oldLines, const std::vector<uint64_t>& newLines) {
+    LineDiff diff;
+    return diff.run(oldLines, newLines);
+}
+
+#endif
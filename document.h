@@ -0,0 +1,1794 @@
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+// Satu dokumen yang sedang dibuka: buffer baris, riwayat undo/redo,
+// atribut format, dan journal miliknya sendiri.
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "journal.h"
+#include "bufferpool.h"
+#include "linestore.h"
+#include "utf8.h"
+#include "highlight.h"
+#include "threadpool.h"
+#include "diff.h"
+#include "textedit.h"
+#include "format.h"
+#include "export.h"
+#include "native.h"
+#include "manualstack.h"
+
+// Satu langkah undo/redo: baris [line, line + count) diganti kembali dengan
+// `text`. Edit biasa cukup menyimpan isi satu baris (count = 1); paste
+// banyak baris tetap jadi satu delta. Edit multi-kursor menyimpan satu
+// delta per baris yang kena; `chained` menandai delta yang masih satu grup
+// dengan delta di bawahnya, sehingga satu undo membatalkan semuanya.
+struct EditDelta {
+    uint32_t line = 0;
+    uint32_t count = 1;
+    bool chained = false;
+    std::vector<std::string> text;
+};
+
+// Delta yang keluar dari budget stack undo di-spill dengan layout yang sama
+// dengan packHistory: [u32 line][u32 count][u32 chained][u32 n][n string]
+template<>
+struct StackTraits<EditDelta> {
+    static const bool spillable = true;
+
+    static size_t bytes(const EditDelta& delta) {
+        size_t n = sizeof(EditDelta) + delta.text.capacity() * sizeof(std::string);
+        for (const std::string& text : delta.text)
+            n += text.capacity() > 15 ? text.capacity() + 1 : 0; // di bawah itu masuk SSO
+        return n;
+    }
+
+    static void encode(std::string& out, const EditDelta& delta) {
+        journalPutU32(out, delta.line);
+        journalPutU32(out, delta.count);
+        journalPutU32(out, delta.chained ? 1 : 0);
+        journalPutU32(out, (uint32_t)delta.text.size());
+        for (const std::string& text : delta.text) {
+            journalPutU32(out, (uint32_t)text.size());
+            out += text;
+        }
+    }
+
+    static bool decode(const char*& p, const char* end, EditDelta& delta) {
+        if (end - p < 16) return false;
+        delta.line = journalGetU32(p);
+        delta.count = journalGetU32(p + 4);
+        delta.chained = journalGetU32(p + 8) != 0;
+        uint32_t n = journalGetU32(p + 12);
+        p += 16;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (end - p < 4) return false;
+            uint32_t len = journalGetU32(p);
+            p += 4;
+            if ((size_t)(end - p) < len) return false;
+            delta.text.emplace_back(p, len);
+            p += len;
+        }
+        return true;
+    }
+};
+
+// Kursor tambahan (multi-kursor): nomor baris dan offset byte di baris itu
+struct Cursor {
+    uint32_t line = 0;
+    uint32_t offset = 0;
+
+    bool operator<(const Cursor& other) const {
+        return line != other.line ? line < other.line : offset < other.offset;
+    }
+
+    bool operator==(const Cursor& other) const {
+        return line == other.line && offset == other.offset;
+    }
+};
+
+enum MultiEdit {
+    MULTI_INSERT,
+    MULTI_BACKSPACE,
+    MULTI_DELETE
+};
+
+// Log aktivitas bersama untuk semua dokumen (.log.txt)
+class ActionLog {
+private:
+    std::ofstream file;
+public:
+    bool muted = false; // true selama replay journal, aksi tidak di-log ulang
+
+    void open(const std::string& path) {
+        file.open(path, std::ios::app);
+    }
+
+    void close() {
+        file.close();
+    }
+
+    void write(const std::string& action) {
+        if (file.is_open() && !muted) {
+            time_t now = time(0);
+            struct tm* timeinfo = localtime(&now);
+            char timestamp[32];
+            strftime(timestamp, sizeof(timestamp), "%d-%m-%Y[%H:%M:%S]", timeinfo);
+            file << "[" << timestamp << "] - " << action << std::endl;
+        }
+    }
+};
+
+// false (errno terisi) jika file tidak bisa dibuka atau fsync gagal
+inline bool syncFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    int error = errno;
+    ::close(fd);
+    errno = error;
+    return ok;
+}
+
+// Hasil Document::syncWithDisk
+enum DiskChange {
+    DISK_NONE,
+    DISK_APPENDED, // hanya byte baru di akhir file yang dibaca
+    DISK_RELOADED, // file dipotong atau diganti: dibaca ulang seluruhnya
+    DISK_CONFLICT  // file berubah tapi buffer punya perubahan belum disimpan
+};
+
+class Document {
+public:
+    std::string path;
+    LineStore lines;         // baris yang sedang diedit ada di currentLine, lihat lineAt()
+    std::string currentLine;
+    int currentLineIndex = 0;
+    size_t cursor = 0;       // offset byte di currentLine, selalu di batas grapheme
+    ManualStack<EditDelta> undoStack;
+    ManualStack<EditDelta> redoStack;
+    std::vector<Cursor> extraCursors; // terurut, tanpa duplikat dan tanpa kursor utama
+    bool isBold = false;
+    bool isItalic = false;
+    bool underlineActive = false;
+    bool isStartOfWord = true;
+    bool modified = false;
+    uint64_t version = 0;    // naik setiap isi berubah; hasil pekerjaan background dicocokkan ke sini
+    bool saving = false;     // simpan background sedang berjalan
+    bool follow = false;     // seperti tail -f: kursor (dan layar) ikut ke akhir file saat file bertambah
+    bool shared = false;     // isi milik proses lain (klien kolaborasi): tidak pernah disimpan/dibaca dari disk
+    bool native = false;     // disimpan dalam format native (native.h, path .pkd): format ikut disimpan
+    bool saveHistory = true; // dokumen native ikut menyimpan riwayat undo/redo
+    bool mapped = false;     // baris terakhir dibaca dari file native lewat mmap (bukan teks)
+    Journal journal;
+    SyntaxCache syntax;      // state highlight per baris, diperbarui lewat lines.onChange
+    FormatSpans formats;     // atribut bold/italic/underline per karakter, lihat format.h
+
+    // Pengamat perubahan isi baris di luar highlight (mis. EditTracker
+    // kolaborasi); argumennya sama dengan LineStore::onBeforeChange/onChange
+    std::function<void(size_t line, size_t removed)> beforeLinesChange;
+    std::function<void(size_t line, size_t removed, size_t inserted)> afterLinesChange;
+
+    // Dokumen idle dipadatkan ke pool bersama, lalu bisa di-spill ke swap file
+    // atau, kalau tidak ada perubahan, dibuang dan nanti dibaca ulang dari file
+    bool compacted = false;
+    bool spilled = false;
+    bool evicted = false;
+    PagedText packed;
+    off_t spillOffset = 0;
+    size_t spillLength = 0;
+    std::chrono::steady_clock::time_point lastActive;
+    // compact/spill idle yang gagal (sedang menyimpan, swap gagal ditulis)
+    // baru dicoba lagi setelah waktu ini
+    std::chrono::steady_clock::time_point idleRetry;
+
+    // Riwayat undo/redo yang di-spill saat memori melebihi budget
+    bool historySpilled = false;
+    PagedText history;
+    off_t historyOffset = 0;
+    size_t historyLength = 0;
+
+    Document(const std::string& p, PagePool* pool, SwapFile* swap, ActionLog* log)
+        : path(p), lines(pool), syntax(highlighterFor(p)), formats(lines), packed(pool), history(pool), swap(swap),
+          log(log) {
+        lines.onChange = [this](size_t line, size_t removed, size_t inserted) {
+            syntax.linesChanged(line, removed, inserted);
+            formats.afterChange(removed, inserted);
+            if (afterLinesChange) afterLinesChange(line, removed, inserted);
+        };
+        lines.onBeforeChange = [this](size_t line, size_t removed) {
+            formats.beforeChange(line, removed);
+            if (beforeLinesChange) beforeLinesChange(line, removed);
+        };
+        touch();
+    }
+
+    ~Document() {
+        journal.close();
+    }
+
+    // .saved_text.journal untuk saved_text.txt, di direktori yang sama
+    std::string journalPath() const {
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+        std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+        size_t dot = base.find_last_of('.');
+        if (dot != std::string::npos && dot > 0)
+            base = base.substr(0, dot);
+        return dir + "." + base + ".journal";
+    }
+
+    std::string name() const {
+        size_t slash = path.find_last_of('/');
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    void touch() {
+        lastActive = std::chrono::steady_clock::now();
+        idleRetry = std::chrono::steady_clock::time_point();
+    }
+
+    // Mulai sesi edit: pulihkan dari journal jika ada, atau muat isi file.
+    // Mengembalikan jumlah record journal yang di-replay.
+    size_t start(bool loadFile) {
+        size_t recovered = recover();
+        journal.open(journalPath());
+        if (recovered > 0) {
+            modified = true;
+            journal.reset(J_SNAPSHOT, encodeState(true));
+            log->write("Recovered " + std::to_string(recovered) + " journal records: " + path);
+        } else if (loadFile && loadFromFile(true)) {
+            journal.reset(J_BASE, encodeState(false));
+        } else {
+            journal.reset(J_SNAPSHOT, encodeState(true));
+        }
+        if (lines.contentBytes() >= COLD_STORAGE_BYTES)
+            lines.enableColdStorage(); // log raksasa: sebagian besar baris tidak pernah disentuh
+        return recovered;
+    }
+
+    // Kompres blok baris yang dingin sedikit demi sedikit; dipanggil setelah
+    // frame digambar. true = masih ada pekerjaan.
+    bool coolLines() {
+        if (saving || compacted) return false;
+        return lines.trimHot();
+    }
+
+    // Keluar normal: journal tidak diperlukan lagi
+    void finish() {
+        journal.remove();
+    }
+
+    void pushToUndo() {
+        loadHistory();
+        const EditDelta* top = undoStack.empty() ? nullptr : &undoStack.top();
+        if (!top || top->line != (uint32_t)currentLineIndex || top->count != 1 ||
+            top->text.size() != 1 || top->text[0] != currentLine) {
+            EditDelta delta;
+            delta.line = (uint32_t)currentLineIndex;
+            delta.text.push_back(currentLine);
+            pushDelta(std::move(delta));
+            log->write("Push to undo: " + currentLine);
+        }
+    }
+
+    void pushDelta(EditDelta&& delta) {
+        loadHistory();
+        undoStack.push(std::move(delta));
+        redoStack.clear();
+    }
+
+    void handleUndo() {
+        loadHistory();
+        if (unwind(undoStack, redoStack))
+            log->write("Undo: " + currentLine);
+    }
+
+    void handleRedo() {
+        loadHistory();
+        if (unwind(redoStack, undoStack))
+            log->write("Redo: " + currentLine);
+    }
+
+    // Hapus kata sebelum kursor sampai pemisah kata terakhir (spasi Unicode
+    // atau tanda baca CJK)
+    void handleDeleteLastWord() {
+        pushToUndo();
+        size_t pos = findLastSeparator(currentLine, cursor);
+        if (pos == std::string::npos)
+            pos = 0;
+        currentLine.erase(pos, cursor - pos);
+        cursor = pos;
+        log->write("Delete last word: " + currentLine);
+    }
+
+    // Ketikan sebelum toggle masuk store dulu dengan atribut lama
+    void toggleBold() {
+        settleLine();
+        isBold = !isBold;
+    }
+
+    void toggleItalic() {
+        settleLine();
+        isItalic = !isItalic;
+    }
+
+    void toggleUnderline() {
+        settleLine();
+        underlineActive = !underlineActive;
+    }
+
+    // Atribut untuk teks yang diketik sekarang (TextAttr)
+    uint8_t typingAttr() const {
+        return (isBold ? ATTR_BOLD : 0) | (isItalic ? ATTR_ITALIC : 0) | (underlineActive ? ATTR_UNDERLINE : 0);
+    }
+
+    // Run atribut baris ke-i, nullptr untuk baris polos. Selama dokumen
+    // punya format, baris aktif selalu sudah tercatat di store.
+    const LineAttrs* lineAttrs(size_t i) const {
+        return formats.at(i);
+    }
+
+    // Isi baris ke-i; baris aktif dibaca dari currentLine
+    std::string_view lineAt(size_t i) const {
+        return (int)i == currentLineIndex ? std::string_view(currentLine) : lines[i];
+    }
+
+    // Siapkan state highlight untuk merender baris [0, upTo). Baris aktif
+    // diedit langsung di currentLine, jadi selalu dicek ulang; baris lain
+    // hanya jika berubah. Mengembalikan jumlah baris yang di-tokenize.
+    size_t refreshHighlight(size_t upTo) {
+        // Selama highlight awal masih dihitung worker, baris di luar cache
+        // dirender dari state kosong dulu daripada menahan loop input
+        if (highlightJob)
+            upTo = std::min(upTo, syntax.cachedLines());
+        syntax.touch(currentLineIndex);
+        return syntax.update(std::min(upTo, lines.size()), [this](size_t i) { return lineAt(i); });
+    }
+
+    bool highlightPending() const {
+        return highlightJob != nullptr;
+    }
+
+    void highlightLine(size_t i, std::vector<Token>& out) const {
+        syntax.tokens(lineAt(i), syntax.startState(i), out);
+    }
+
+    // Tulis currentLine ke store; selama mengetik hanya currentLine yang berubah
+    void commitCurrentLine() {
+        if (currentLineIndex < (int)lines.size() && lines[currentLineIndex] != currentLine)
+            lines.set(currentLineIndex, currentLine);
+    }
+
+    // Pindah baris dengan mempertahankan kolom tampilan kursor
+    void moveTo(size_t index) {
+        if (lines.empty()) return;
+        index = std::min(index, lines.size() - 1);
+        if ((int)index == currentLineIndex) return;
+        size_t column = cursorColumn();
+        commitCurrentLine();
+        currentLineIndex = (int)index;
+        currentLine = std::string(lines[currentLineIndex]);
+        cursor = offsetAtColumn(currentLine, column);
+    }
+
+    void moveUp() {
+        if (currentLineIndex > 0) {
+            moveTo(currentLineIndex - 1);
+            log->write("Moved up to line: " + currentLine);
+        }
+    }
+
+    void moveDown() {
+        if (currentLineIndex < (int)lines.size() - 1) {
+            moveTo(currentLineIndex + 1);
+            log->write("Moved down to line: " + currentLine);
+        }
+    }
+
+    void moveLeft() {
+        if (cursor > 0)
+            cursor = prevGrapheme(currentLine, cursor);
+    }
+
+    void moveRight() {
+        if (cursor < currentLine.size())
+            cursor = nextGrapheme(currentLine, cursor);
+    }
+
+    void moveHome() {
+        cursor = 0;
+    }
+
+    void moveEnd() {
+        cursor = currentLine.size();
+    }
+
+    // Ke awal kata sebelum kursor (lewati pemisah dulu, seperti Alt+B di shell)
+    void moveWordLeft() {
+        size_t pos = cursor;
+        while (pos > 0) {
+            size_t start = utf8PrevStart(currentLine, pos);
+            if (!isWordSeparator(decodeUtf8(currentLine, start, nullptr))) break;
+            pos = start;
+        }
+        size_t sep = findLastSeparator(currentLine, pos);
+        if (sep == std::string::npos) {
+            cursor = 0;
+        } else {
+            size_t len;
+            decodeUtf8(currentLine, sep, &len);
+            cursor = sep + len;
+        }
+    }
+
+    // Ke akhir kata setelah kursor
+    void moveWordRight() {
+        size_t pos = cursor, len;
+        bool inWord = false;
+        while (pos < currentLine.size()) {
+            bool separator = isWordSeparator(decodeUtf8(currentLine, pos, &len));
+            if (separator && inWord) break;
+            if (!separator) inWord = true;
+            pos += len;
+        }
+        cursor = pos < currentLine.size() ? pos : currentLine.size();
+    }
+
+    // Kolom tampilan kursor (lebar teks sebelum kursor)
+    size_t cursorColumn() const {
+        return displayWidth(std::string_view(currentLine).substr(0, cursor));
+    }
+
+    // Enter memecah baris di kursor; sisa baris pindah ke baris baru tepat di bawahnya
+    void handleNewline() {
+        if (currentLineIndex >= (int)lines.size())
+            syncCurrentLine();
+        pushLineDelta(currentLineIndex, 2, 1);
+        std::string tail = currentLine.substr(cursor);
+        currentLine.erase(cursor);
+        lines.set(currentLineIndex, currentLine); // menyimpan currentLine ke dalam lines
+        lines.insert(currentLineIndex + 1, tail);
+        currentLineIndex++; // pindah ke baris baru
+        currentLine = tail;
+        cursor = 0;
+        isStartOfWord = true;
+    }
+
+    // Hapus satu grapheme utuh sebelum kursor (bukan satu byte); di awal
+    // baris, baris ini digabung ke baris sebelumnya
+    void handleBackspace() {
+        if (cursor > 0) { //ketika ada karakter sebelum kursor
+            size_t start = prevGrapheme(currentLine, cursor);
+            currentLine.erase(start, cursor - start);
+            cursor = start;
+        } else if (currentLineIndex > 0 && currentLineIndex < (int)lines.size()) {
+            commitCurrentLine();
+            currentLineIndex--;
+            std::string next = currentLine;
+            currentLine = std::string(lines[currentLineIndex]);
+            cursor = currentLine.size();
+            joinNext(next);
+        }
+    }
+
+    // Tombol Delete: hapus grapheme setelah kursor; di akhir baris, baris
+    // berikutnya digabung ke sini
+    void handleDeleteForward() {
+        if (cursor < currentLine.size())
+            currentLine.erase(cursor, nextGrapheme(currentLine, cursor) - cursor);
+        else
+            joinLine();
+    }
+
+    // Gabungkan baris berikutnya ke akhir baris ini
+    void joinLine() {
+        if (currentLineIndex + 1 < (int)lines.size()) {
+            commitCurrentLine();
+            joinNext(std::string(lines[currentLineIndex + 1]));
+        }
+    }
+
+    void deleteLine() {
+        if (currentLineIndex >= (int)lines.size())
+            syncCurrentLine();
+        if (lines.size() == 1) {
+            pushLineDelta(0, 1, 1);
+            currentLine.clear();
+            lines.set(0, "");
+            cursor = 0;
+            return;
+        }
+        size_t column = cursorColumn();
+        pushLineDelta(currentLineIndex, 0, 1);
+        lines.erase(currentLineIndex);
+        currentLineIndex = std::min(currentLineIndex, (int)lines.size() - 1);
+        currentLine = std::string(lines[currentLineIndex]);
+        cursor = offsetAtColumn(currentLine, column);
+        log->write("Delete line " + std::to_string(currentLineIndex + 1) + ": " + path);
+    }
+
+    // Tukar baris ini dengan baris di atas/bawahnya, kursor ikut baris
+    void moveLineUp() {
+        if (currentLineIndex > 0 && currentLineIndex < (int)lines.size())
+            swapWithNext(currentLineIndex - 1);
+    }
+
+    void moveLineDown() {
+        if (currentLineIndex + 1 < (int)lines.size())
+            swapWithNext(currentLineIndex);
+    }
+
+    // Teks dari bracketed paste: dipecah per baris sekaligus, semua baris
+    // baru disisipkan ke store dalam satu splice, dan dicatat sebagai satu
+    // delta undo (baris asal -> semua baris hasil paste)
+    void insertText(const std::string& text) {
+        if (!validateUtf8(text)) {
+            // Byte yang bukan UTF-8 valid jadi U+FFFD, store hanya berisi teks valid
+            std::string repaired = text;
+            repairUtf8(repaired);
+            insertText(repaired);
+            return;
+        }
+        loadHistory();
+        if (currentLineIndex >= (int)lines.size())
+            syncCurrentLine();
+        std::vector<std::string_view> pieces;
+        splitLines(text, pieces);
+
+        EditDelta delta;
+        delta.line = (uint32_t)currentLineIndex;
+        delta.count = (uint32_t)pieces.size();
+        delta.text.push_back(currentLine);
+        pushDelta(std::move(delta));
+
+        std::string tail = currentLine.substr(cursor);
+        if (pieces.size() == 1) {
+            currentLine.insert(cursor, text);
+            cursor += text.size();
+        } else {
+            std::string first = currentLine.substr(0, cursor);
+            first += pieces.front();
+            std::string last(pieces.back());
+            cursor = last.size();
+            last += tail;
+            pieces.front() = first;
+            pieces.back() = last;
+            lines.replace(currentLineIndex, 1, pieces);
+            currentLineIndex += (int)pieces.size() - 1;
+            currentLine = last;
+        }
+        isStartOfWord = true;
+        log->write("Paste: " + std::to_string(text.size()) + " bytes, " +
+                   std::to_string(pieces.size()) + " baris");
+    }
+
+    void insertChar(char ch) {
+        if (isStartOfWord) {
+            pushToUndo(); // menyimpan currentLine ke dalam undoStack
+            isStartOfWord = false; // menandai bahwa kita sudah tidak di awal kata lagi
+        }
+        // Byte UTF-8 datang satu per satu dan disisipkan berurutan di kursor
+        if (cursor == currentLine.size())
+            currentLine += ch; // menambahkan karakter yang dimasukkan ke currentLine
+        else
+            currentLine.insert(cursor, 1, ch);
+        cursor++;
+        if (ch == ' ') {
+            isStartOfWord = true;
+        }
+    }
+
+    bool multiCursor() const {
+        return !extraCursors.empty();
+    }
+
+    // Tambah kursor satu baris di bawah kursor paling bawah, pada kolom
+    // tampilan kursor utama
+    void addCursorBelow() {
+        prepareCursors();
+        size_t bottom = (size_t)currentLineIndex;
+        if (!extraCursors.empty())
+            bottom = std::max<size_t>(bottom, extraCursors.back().line);
+        if (bottom + 1 >= lines.size()) return;
+        uint32_t offset = (uint32_t)offsetAtColumn(lines[bottom + 1], cursorColumn());
+        extraCursors.push_back({(uint32_t)(bottom + 1), offset});
+        isStartOfWord = true;
+    }
+
+    // Kursor di akhir setiap kemunculan kata di kursor utama, di seluruh dokumen
+    void addCursorsAtWord() {
+        prepareCursors();
+        size_t start = findLastSeparator(currentLine, cursor), len;
+        if (start == std::string::npos) {
+            start = 0;
+        } else {
+            decodeUtf8(currentLine, start, &len);
+            start += len;
+        }
+        size_t end = cursor;
+        while (end < currentLine.size() && !isWordSeparator(decodeUtf8(currentLine, end, &len)))
+            end += len;
+        if (end == start) return;
+        std::string word = currentLine.substr(start, end - start);
+        cursor = end;
+
+        extraCursors.clear();
+        uint32_t index = 0;
+        for (std::string_view line : lines) {
+            for (size_t pos = line.find(word); pos != std::string::npos; pos = line.find(word, pos)) {
+                pos += word.size();
+                if (index != (uint32_t)currentLineIndex || pos != cursor)
+                    extraCursors.push_back({index, (uint32_t)pos});
+            }
+            index++;
+        }
+        isStartOfWord = true;
+        log->write("Cursors at \"" + word + "\": " + std::to_string(extraCursors.size() + 1));
+    }
+
+    void clearCursors() {
+        extraCursors.clear();
+    }
+
+    // Kursor tambahan di baris `line`, sebagai rentang [first, last)
+    std::pair<const Cursor*, const Cursor*> cursorsOnLine(size_t line) const {
+        auto first = std::lower_bound(extraCursors.begin(), extraCursors.end(), Cursor{(uint32_t)line, 0});
+        auto last = first;
+        while (last != extraCursors.end() && last->line == line)
+            ++last;
+        return {extraCursors.data() + (first - extraCursors.begin()),
+                extraCursors.data() + (last - extraCursors.begin())};
+    }
+
+    // Satu edit untuk semua kursor dalam satu pass: kursor utama disisipkan
+    // ke daftar yang sudah terurut, lalu tiap baris yang kena dibangun ulang
+    // sekali dari kiri ke kanan sambil menghitung offset baru kursornya.
+    // Biayanya linear terhadap jumlah kursor + panjang baris yang kena.
+    void editAllCursors(MultiEdit kind, const std::string& text) {
+        loadHistory();
+        prepareCursors();
+        bool saveUndo = isStartOfWord;
+        Cursor primary{(uint32_t)currentLineIndex, (uint32_t)cursor};
+        std::vector<Cursor> all;
+        all.reserve(extraCursors.size() + 1);
+        auto split = std::lower_bound(extraCursors.begin(), extraCursors.end(), primary);
+        size_t primaryIndex = split - extraCursors.begin();
+        all.insert(all.end(), extraCursors.begin(), split);
+        all.push_back(primary);
+        all.insert(all.end(), split, extraCursors.end());
+
+        bool grouped = false;
+        for (size_t i = 0; i < all.size();) {
+            size_t j = i;
+            while (j < all.size() && all[j].line == all[i].line)
+                ++j;
+            uint32_t line = all[i].line;
+            std::string_view old = lines[line];
+            std::string updated = rebuildLine(old, &all[i], &all[j], kind, text);
+            if (updated != old) {
+                if (saveUndo) {
+                    EditDelta delta;
+                    delta.line = line;
+                    delta.chained = grouped;
+                    delta.text.push_back(std::string(old));
+                    pushDelta(std::move(delta));
+                    grouped = true;
+                }
+                lines.set(line, updated);
+            }
+            i = j;
+        }
+
+        primary = all[primaryIndex];
+        all.erase(all.begin() + primaryIndex);
+        extraCursors = std::move(all);
+        dropDuplicateCursors(primary);
+        currentLineIndex = (int)primary.line;
+        currentLine = std::string(lines[primary.line]);
+        cursor = primary.offset;
+        isStartOfWord = kind == MULTI_INSERT && (text == " " || text.size() > 1);
+    }
+
+    // Gerakan kursor (kiri/kanan/Home/End/per kata) diterapkan ke setiap kursor
+    void moveAllCursors(void (Document::*move)()) {
+        prepareCursors();
+        std::string primaryLine = std::move(currentLine);
+        size_t primaryCursor = cursor;
+        uint32_t loaded = UINT32_MAX;
+        for (Cursor& c : extraCursors) {
+            if (c.line != loaded) {
+                currentLine = std::string(lines[c.line]);
+                loaded = c.line;
+            }
+            cursor = c.offset;
+            (this->*move)();
+            c.offset = (uint32_t)cursor;
+        }
+        currentLine = std::move(primaryLine);
+        cursor = primaryCursor;
+        (this->*move)();
+
+        dropDuplicateCursors({(uint32_t)currentLineIndex, (uint32_t)cursor});
+    }
+
+    // Menerapkan satu operasi edit, dipakai oleh input keyboard dan replay journal
+    void applyOp(JournalOp op, const std::string& payload) {
+        // Teks dari jaringan (J_SPLICE) selalu polos
+        formats.typing = op == J_SPLICE ? 0 : typingAttr();
+        bool styled = formats.tracking();
+        applyEditOp(op, payload);
+        if (styled) { // dokumen berformat: setiap operasi langsung dicatat ke store
+            settleLine();
+            formats.flush(currentLineIndex, cursor);
+        }
+        formats.typing = 0;
+    }
+
+    void markModified() {
+        modified = true;
+        version++;
+    }
+
+    // Write-ahead: operasi dicatat ke journal dulu baru diterapkan.
+    // Undo/redo dicatat bersama isi delta yang diterapkannya (baru diketahui
+    // setelah stack dibaca): setelah J_BASE/J_SNAPSHOT stack undo saat replay
+    // kosong, padahal sesi aslinya masih menyimpan riwayat sebelum simpan.
+    // Record tetap masuk journal sebelum group commit berikutnya.
+    void recordOp(JournalOp op, const std::string& payload) {
+        if ((op == J_UNDO || op == J_REDO) && payload.empty()) {
+            unwound.clear();
+            applyOp(op, payload);
+            if (!unwound.empty())
+                journal.append(op, unwound);
+        } else {
+            journal.append(op, payload);
+            applyOp(op, payload);
+        }
+        if (journal.needsCheckpoint()) // batasi panjang replay saat recovery
+            journal.reset(J_SNAPSHOT, encodeState(true));
+    }
+
+    void recordOp(JournalOp op, char ch = 0) {
+        recordOp(op, op == J_INSERT ? std::string(1, ch) : std::string());
+    }
+
+    bool save() {
+        if (shared) return false;
+        settleForSnapshot();
+        std::vector<std::string_view> views;
+        views.reserve(lines.size());
+        for (std::string_view line : lines)
+            views.push_back(line);
+        std::string attrs, undo;
+        if (native) encodeNativeExtras(attrs, undo);
+        if (!(native ? writeNative(path, views, attrs, undo) : writeLines(path, views)))
+            return false;
+        finishSave(version);
+        return true;
+    }
+
+    // Simpan di worker. Thread utama hanya mengambil snapshot copy-on-write
+    // store (LineStore::Snapshot, O(daun + blok), teks tidak disalin); daftar
+    // baris, tulis dan fsync di background. Kalau dokumen berubah sebelum
+    // selesai, journal tetap dipakai apa adanya dan dokumen tetap ditandai
+    // berubah. `done` dipanggil di thread utama dengan hasil simpan.
+    void saveAsync(ThreadPool& workers, std::function<void(bool)> done = nullptr) {
+        if (shared) {
+            if (done) done(false);
+            return;
+        }
+        if (saving) {
+            saveQueued = true; // jangan sampai dua penulisan file yang sama jalan bersamaan
+            queuedDone = std::move(done);
+            return;
+        }
+        saving = true;
+        uint64_t snapshot = version;
+        std::shared_ptr<LineStore::Snapshot> text = snapshotLines();
+        std::string attrs, undo;
+        if (native) encodeNativeExtras(attrs, undo);
+        workers.submit([this, &workers, text, attrs = std::move(attrs), undo = std::move(undo),
+                        target = path, nativeFile = native, snapshot, done](const CancelToken&) {
+            std::vector<std::string_view> views;
+            text->lines(views);
+            bool ok = nativeFile ? writeNative(target, views, attrs, undo) : writeLines(target, views);
+            workers.post([this, &workers, text, ok, snapshot, done] {
+                lines.release(*text);
+                saving = false;
+                if (ok)
+                    finishSave(snapshot);
+                else
+                    log->write("Save failed: " + path);
+                if (done) done(ok);
+                if (saveQueued) {
+                    saveQueued = false;
+                    saveAsync(workers, std::move(queuedDone));
+                }
+            });
+        });
+    }
+
+    // Ekspor ke HTML/Markdown/ANSI (export.h) di worker, dengan cara yang
+    // sama seperti saveAsync: baris dibaca dari snapshot store, atribut
+    // format disalin. Selama berjalan dokumen dianggap sedang menyimpan, jadi
+    // tidak dipadatkan dan Ctrl+S menunggu.
+    void exportAsync(ThreadPool& workers, const std::string& target, ExportFormat format,
+                     std::function<void(bool)> done = nullptr) {
+        if (saving) {
+            if (done) done(false);
+            return;
+        }
+        saving = true;
+        std::shared_ptr<LineStore::Snapshot> text = snapshotLines();
+        std::vector<FormattedLine> spans = formats.lines();
+        workers.submit([this, &workers, text, spans = std::move(spans), target, format,
+                        title = name(), done](const CancelToken&) {
+            std::vector<std::string_view> views;
+            text->lines(views);
+            bool ok = exportLines(target, format, views, spans, title);
+            workers.post([this, &workers, text, ok, target, done] {
+                lines.release(*text);
+                saving = false;
+                log->write((ok ? "Export to " : "Export failed: ") + target);
+                if (done) done(ok);
+                if (saveQueued) {
+                    saveQueued = false;
+                    saveAsync(workers, std::move(queuedDone));
+                }
+            });
+        });
+    }
+
+    // File besar: state highlight seluruh file dihitung di worker dari isi
+    // file di disk. Kalau dokumen sudah diedit saat hasilnya datang, hanya
+    // baris sebelum edit pertama yang dipasang.
+    void warmHighlight(ThreadPool& workers) {
+        if (lines.size() < WARM_HIGHLIGHT_LINES) return;
+        if (highlightJob) highlightJob->cancel();
+        syntax.markSnapshot();
+        uint64_t snapshot = version;
+        size_t count = lines.size();
+        highlightJob = workers.submit([this, &workers, target = path, hl = syntax.highlighter, snapshot,
+                                       count](const CancelToken& cancel) {
+            std::vector<uint8_t> states;
+            states.reserve(count);
+            uint8_t state = 0;
+            bool cancelled = false;
+            readSavedLines(target, [&](std::string_view line) {
+                if ((states.size() & 0xffff) == 0 && cancel.cancelled()) {
+                    cancelled = true;
+                    return false;
+                }
+                state = hl->tokenize(line, state, nullptr);
+                states.push_back(state);
+                return true;
+            });
+            if (cancelled) return;
+            workers.post([this, states = std::move(states), snapshot]() mutable {
+                highlightJob.reset();
+                if (compacted) return;
+                size_t valid = states.size() == lines.size() ? states.size() : 0;
+                if (version != snapshot) // currentLine diedit di tempat, belum tentu tercatat di store
+                    valid = std::min({valid, syntax.firstChangeSinceSnapshot(), (size_t)currentLineIndex});
+                syntax.install(std::move(states), valid);
+            });
+        });
+    }
+
+    // Kalau currentLine belum punya tempat di lines, tambahkan sebelum disimpan
+    void syncCurrentLine() {
+        if (currentLineIndex < (int)lines.size())
+            lines.set(currentLineIndex, currentLine);
+        else
+            lines.push_back(currentLine);
+    }
+
+    // Offset byte awal baris di teks dokumen (baris digabung dengan '\n')
+    uint64_t offsetOf(size_t line) const {
+        return lines.stats(0, line).bytes + line;
+    }
+
+    // Terapkan edit berbasis offset (kolaborasi, lihat textedit.h). Kursor
+    // ikut digeser; undo/redo dan multi-kursor dikosongkan karena delta
+    // barisnya tidak lagi cocok dengan isi dokumen.
+    void applyEdits(const EditOp& edits) {
+        loadHistory();
+        syncCurrentLine();
+        uint64_t pos = offsetOf(currentLineIndex) + cursor;
+        for (const TextEdit& e : edits) {
+            if (e.insert)
+                spliceInsert(e.pos, e.text);
+            else
+                spliceDelete(e.pos, e.len);
+            pos = mapPosition(pos, e);
+        }
+        size_t line = clampOffset(pos);
+        currentLineIndex = (int)line;
+        currentLine = std::string(lines[line]);
+        size_t at = 0;
+        while (at < pos) { // kursor tetap di batas grapheme
+            size_t next = nextGrapheme(currentLine, at);
+            if (next > pos) break;
+            at = next;
+        }
+        cursor = at;
+        extraCursors.clear();
+        undoStack.clear();
+        redoStack.clear();
+        formats.flush();
+    }
+
+    // Padatkan baris dan riwayat undo ke halaman pool bersama
+    void compact() {
+        if (compacted || saving) return; // worker masih membaca record baris
+        packState(true);
+        compacted = true;
+        log->write("Compact: " + path + " (" + std::to_string(packed.pageCount()) + " pages)");
+    }
+
+    // Dokumen tanpa perubahan tidak perlu disimpan: baris dibuang dan dibaca
+    // ulang dari file saat diaktifkan lagi. Riwayat undo tetap dipadatkan.
+    bool evict() {
+        if (evicted) return true;
+        if (modified || saving || shared || !fileUnchanged()) return false;
+        expand();
+        packState(false);
+        compacted = true;
+        evicted = true;
+        log->write("Evict: " + path);
+        return true;
+    }
+
+    // Tulis halaman yang sudah dipadatkan ke swap file dan bebaskan dari pool
+    bool spill() {
+        compact();
+        if (spilled) return true;
+        if (!compacted) return false;
+        int fd = swap->handle();
+        if (fd < 0) return false;
+        spillLength = packed.size();
+        spillOffset = swap->reserve(spillLength);
+        if (!packed.spill(fd, spillOffset)) {
+            swap->release(spillLength);
+            return false;
+        }
+        spilled = true;
+        log->write("Spill: " + path + " (" + std::to_string(spillLength) + " bytes)");
+        return true;
+    }
+
+    // Kembalikan dokumen ke bentuk biasa saat diaktifkan lagi
+    void expand() {
+        if (!compacted) return;
+        if (spilled) {
+            packed.unspill(swap->handle(), spillOffset, spillLength);
+            swap->release(spillLength);
+            spilled = false;
+        }
+        PagedText::Reader reader(packed);
+        uint32_t count = reader.readU32();
+        auto notify = std::move(lines.onChange); // isi sama, cache highlight tetap berlaku
+        auto notifyBefore = std::move(lines.onBeforeChange);
+        lines.onChange = nullptr;
+        lines.onBeforeChange = nullptr;
+        if (count == EVICTED_LINES) {
+            readFileLines();
+            log->write("Reload: " + path);
+        } else {
+            for (uint32_t i = 0; i < count; ++i)
+                lines.push_back(reader.readString());
+        }
+        lines.onChange = std::move(notify);
+        lines.onBeforeChange = std::move(notifyBefore);
+        unpackHistory(reader);
+        packed.release();
+        compacted = false;
+        evicted = false;
+    }
+
+    // Riwayat undo dokumen aktif jarang disentuh: tulis ke swap file, dan
+    // baca lagi otomatis saat undo/redo berikutnya
+    bool spillHistory() {
+        if (historySpilled || compacted || (undoStack.empty() && redoStack.empty()))
+            return false;
+        int fd = swap->handle();
+        if (fd < 0) return false;
+        packHistory(history);
+        historyLength = history.size();
+        historyOffset = swap->reserve(historyLength);
+        if (!history.spill(fd, historyOffset)) {
+            swap->release(historyLength);
+            return false;
+        }
+        historySpilled = true;
+        log->write("Spill undo history: " + path + " (" + std::to_string(historyLength) + " bytes)");
+        return true;
+    }
+
+    void loadHistory() {
+        if (!historySpilled) return;
+        history.unspill(swap->handle(), historyOffset, historyLength);
+        swap->release(historyLength);
+        PagedText::Reader reader(history);
+        unpackHistory(reader);
+        history.release();
+        historySpilled = false;
+    }
+
+    // Batas byte riwayat undo dan redo yang tinggal di memori (masing-masing);
+    // delta terlama di luar budget di-spill, lihat manualstack.h
+    void setUndoBudget(size_t bytes) {
+        undoStack.setBudget(bytes);
+        redoStack.setBudget(bytes);
+    }
+
+    size_t lineCount() const {
+        return std::max(lines.size(), (size_t)currentLineIndex + 1);
+    }
+
+    // Statistik seluruh dokumen dari agregat B+tree, hanya baris aktif yang
+    // dihitung ulang (isinya di currentLine, record di store bisa basi).
+    // Dokumen yang dipadatkan tidak punya baris di store.
+    LineStats textStats() const {
+        LineStats s = lines.stats();
+        if (currentLineIndex < (int)lines.size())
+            s -= LineStats::of(lines[currentLineIndex]);
+        s += LineStats::of(currentLine);
+        return s;
+    }
+
+    // Karakter bold/italic/underline seluruh dokumen dari agregat B+tree.
+    // Baris aktif dokumen berformat selalu sudah dicatat ke store (applyOp).
+    const AttrStats& attrStats() const {
+        return lines.attrStats();
+    }
+
+    // Perubahan buffer dibanding file tersimpan (sisi lama = file, sisi baru =
+    // buffer). Hash baris buffer di-cache di LineStore, hash baris file di-cache
+    // selama ukuran dan mtime file tidak berubah, jadi diff berikutnya hanya
+    // meng-hash baris yang disunting.
+    std::vector<DiffHunk> diffWithSaved() {
+        expand();
+        if (!savedHashesFresh())
+            readSavedHashes();
+        std::vector<uint64_t> current;
+        lines.lineHashes(current);
+        uint64_t active = LineStore::lineHash(currentLine); // record di store bisa basi
+        if (currentLineIndex < (int)current.size())
+            current[currentLineIndex] = active;
+        else
+            current.push_back(active);
+        return diffLines(savedHashes, current);
+    }
+
+    // Samakan buffer dengan file di disk setelah diubah program lain. File
+    // yang hanya bertambah (log) dibaca dari offset terakhir saja; file yang
+    // dipotong, diganti, atau bagian lamanya berubah dibaca ulang. Buffer
+    // dengan perubahan belum disimpan tidak ditimpa.
+    DiskChange syncWithDisk() {
+        if (saving || compacted || shared) return DISK_NONE; // tulisan sendiri / dicek lagi saat diaktifkan
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return DISK_NONE; // file dihapus: isi buffer tetap
+        if (st.st_size == fileSize && st.st_mtime == fileMtime && st.st_ino == fileInode)
+            return DISK_NONE;
+        if (modified) return DISK_CONFLICT;
+        if (!native && fileSize >= 0 && st.st_ino == fileInode && st.st_size > fileSize && tailUnchanged() &&
+            appendFromDisk(st))
+            return DISK_APPENDED;
+        reloadFromDisk();
+        return DISK_RELOADED;
+    }
+
+    // Isi baris lama (dari file) untuk hunk-hunk ini, berurutan
+    std::vector<std::string> savedLinesOf(const std::vector<DiffHunk>& hunks) const {
+        std::vector<std::string> out;
+        size_t lineNo = 0, hunk = 0;
+        readSavedLines(path, [&](std::string_view line) {
+            while (hunk < hunks.size() && lineNo >= hunks[hunk].oldStart + hunks[hunk].oldCount)
+                hunk++;
+            if (hunk == hunks.size()) return false;
+            if (lineNo >= hunks[hunk].oldStart)
+                out.push_back(std::string(line));
+            lineNo++;
+            return true;
+        });
+        return out;
+    }
+
+    // Baris file tersimpan berurutan, teks biasa atau native; f(line)
+    // mengembalikan false untuk berhenti. false kalau file tidak bisa dibaca.
+    template<typename F>
+    static bool readSavedLines(const std::string& target, F f) {
+        NativeFile file;
+        if (file.open(target)) {
+            for (size_t i = 0; i < file.lineCount(); ++i)
+                if (!f(file.line(i))) break;
+            return true;
+        }
+        if (file.corrupt()) return false;
+        std::ifstream in(target);
+        if (!in) return false;
+        std::string line;
+        while (std::getline(in, line))
+            if (!f(std::string_view(line))) break;
+        return true;
+    }
+
+    // Perkiraan memori yang dipakai dokumen ini (heap std::string + halaman pool)
+    size_t memoryBytes() const {
+        size_t bytes = lines.memoryBytes() + stringHeap(currentLine) +
+                       extraCursors.capacity() * sizeof(Cursor) + syntax.memoryBytes() + formats.memoryBytes();
+        bytes += undoStack.memoryBytes() + redoStack.memoryBytes();
+        bytes += savedHashes.capacity() * sizeof(uint64_t);
+        return bytes + (packed.pageCount() + history.pageCount()) * POOL_PAGE_SIZE;
+    }
+
+    std::string stateName() const {
+        if (evicted) return "evicted";
+        if (spilled) return "swap";
+        if (compacted) return "padat";
+        return "aktif";
+    }
+
+private:
+    static const uint32_t EVICTED_LINES = 0xffffffffu;
+    static const size_t WARM_HIGHLIGHT_LINES = 10000; // di bawah ini cukup tokenize saat render
+    static const size_t COLD_STORAGE_BYTES = 32 << 20;
+
+    bool saveQueued = false;
+    std::function<void(bool)> queuedDone;
+    std::shared_ptr<CancelToken> highlightJob;
+    std::string unwound; // delta undo/redo terakhir (layout StackTraits<EditDelta>) untuk journal
+
+    SwapFile* swap;
+    ActionLog* log;
+    off_t fileSize = -1;
+    time_t fileMtime = 0;
+    ino_t fileInode = 0;
+    std::string fileTail; // byte terakhir file saat dicatat, untuk mengenali append
+    std::vector<uint64_t> savedHashes; // hash baris file di disk, untuk diff
+    off_t savedHashSize = -1;
+    time_t savedHashMtime = 0;
+
+    static size_t stringHeap(const std::string& s) {
+        return s.capacity() > 15 ? s.capacity() + 1 : 0; // di bawah itu masuk SSO
+    }
+
+    void packState(bool withLines) {
+        loadHistory();
+        commitCurrentLine();
+        formats.flush();
+        packed.appendU32(withLines ? (uint32_t)lines.size() : EVICTED_LINES);
+        if (withLines) {
+            for (std::string_view line : lines) {
+                packed.appendU32((uint32_t)line.size());
+                packed.append(line.data(), line.size());
+            }
+        }
+        packHistory(packed);
+        auto notify = std::move(lines.onChange);
+        auto notifyBefore = std::move(lines.onBeforeChange);
+        lines.onChange = nullptr;
+        lines.onBeforeChange = nullptr;
+        lines.clear();
+        lines.onChange = std::move(notify);
+        lines.onBeforeChange = std::move(notifyBefore);
+    }
+
+    // Bagian tambahan file native: atribut format dan, kalau saveHistory,
+    // riwayat undo/redo dengan layout packHistory (tanpa melepas stack)
+    void encodeNativeExtras(std::string& attrs, std::string& undo) {
+        formats.encode(attrs);
+        if (!saveHistory) return;
+        loadHistory();
+        for (const ManualStack<EditDelta>* stack : {&undoStack, &redoStack}) {
+            journalPutU32(undo, (uint32_t)stack->size());
+            stack->forEach([&](const EditDelta& delta) { StackTraits<EditDelta>::encode(undo, delta); });
+        }
+    }
+
+    // Per delta: [u32 line][u32 count][u32 chained][u32 n][n string]
+    void packHistory(PagedText& out) {
+        for (ManualStack<EditDelta>* stack : {&undoStack, &redoStack}) {
+            out.appendU32((uint32_t)stack->size());
+            stack->forEach([&](const EditDelta& delta) {
+                out.appendU32(delta.line);
+                out.appendU32(delta.count);
+                out.appendU32(delta.chained ? 1 : 0);
+                out.appendU32((uint32_t)delta.text.size());
+                for (const std::string& text : delta.text)
+                    out.appendString(text);
+            });
+            stack->release();
+        }
+    }
+
+    void unpackHistory(PagedText::Reader& reader) {
+        for (ManualStack<EditDelta>* stack : {&undoStack, &redoStack}) {
+            uint32_t count = reader.readU32();
+            for (uint32_t i = 0; i < count; ++i) {
+                EditDelta delta;
+                delta.line = reader.readU32();
+                delta.count = reader.readU32();
+                delta.chained = reader.readU32() != 0;
+                uint32_t n = reader.readU32();
+                for (uint32_t j = 0; j < n; ++j)
+                    delta.text.push_back(reader.readString());
+                stack->push(std::move(delta));
+            }
+        }
+    }
+
+    void settleLine() {
+        if (compacted) return;
+        if (currentLineIndex >= (int)lines.size())
+            syncCurrentLine();
+        else
+            commitCurrentLine();
+    }
+
+    void applyEditOp(JournalOp op, const std::string& payload) {
+        char ch = payload.empty() ? 0 : payload[0];
+        if (multiCursor() && applyMultiOp(op, payload)) {
+            if (op != J_MOVE_LEFT && op != J_MOVE_RIGHT && op != J_WORD_LEFT &&
+                op != J_WORD_RIGHT && op != J_HOME && op != J_END)
+                markModified();
+            return;
+        }
+        switch (op) {
+        case J_INSERT: insertChar(ch); break;
+        case J_BACKSPACE: handleBackspace(); break;
+        case J_NEWLINE: handleNewline(); break;
+        case J_DELETE_WORD: handleDeleteLastWord(); break;
+        case J_UNDO:
+            if (payload.empty()) handleUndo();
+            else replayUnwind(payload, undoStack, redoStack);
+            break;
+        case J_REDO:
+            if (payload.empty()) handleRedo();
+            else replayUnwind(payload, redoStack, undoStack);
+            break;
+        case J_MOVE_UP: moveUp(); break;
+        case J_MOVE_DOWN: moveDown(); break;
+        case J_TOGGLE_BOLD: toggleBold(); break;
+        case J_TOGGLE_ITALIC: toggleItalic(); break;
+        case J_TOGGLE_UNDERLINE: toggleUnderline(); break;
+        case J_MOVE_LEFT: moveLeft(); break;
+        case J_MOVE_RIGHT: moveRight(); break;
+        case J_WORD_LEFT: moveWordLeft(); break;
+        case J_WORD_RIGHT: moveWordRight(); break;
+        case J_HOME: moveHome(); break;
+        case J_END: moveEnd(); break;
+        case J_MOVE_TO:
+            if (payload.size() >= 4) moveTo(journalGetU32(payload.data()));
+            break;
+        case J_DELETE_FORWARD: handleDeleteForward(); break;
+        case J_PASTE: insertText(payload); break;
+        case J_JOIN_LINE: joinLine(); break;
+        case J_DELETE_LINE: deleteLine(); break;
+        case J_MOVE_LINE_UP: moveLineUp(); break;
+        case J_MOVE_LINE_DOWN: moveLineDown(); break;
+        case J_ADD_CURSOR_BELOW: addCursorBelow(); break;
+        case J_ADD_CURSORS_AT_WORD: addCursorsAtWord(); break;
+        case J_CLEAR_CURSORS: clearCursors(); break;
+        case J_SPLICE: {
+            EditOp edits;
+            if (decodeEdits(payload.data(), payload.size(), edits))
+                applyEdits(edits);
+            break;
+        }
+        default: break;
+        }
+        if ((op >= J_INSERT && op <= J_REDO) || (op >= J_DELETE_FORWARD && op <= J_MOVE_LINE_DOWN) || op == J_SPLICE)
+            markModified();
+    }
+
+    // Catat delta undo: `count` baris mulai dari `line` nanti diganti kembali
+    // dengan `saved` baris yang ada sekarang (currentLine sudah ikut dihitung)
+    // Offset -> baris, pos jadi kolom; offset di luar teks dijepit ke akhir
+    size_t clampOffset(uint64_t& pos) const {
+        size_t line = lines.lineAtOffset(pos);
+        if (line >= lines.size()) {
+            line = lines.size() - 1;
+            pos = lines[line].size();
+        }
+        return line;
+    }
+
+    void spliceInsert(uint64_t pos, const std::string& text) {
+        size_t line = clampOffset(pos);
+        std::string merged(lines[line]);
+        merged.insert(pos, text);
+        std::vector<std::string_view> pieces;
+        std::string_view rest(merged);
+        for (size_t nl; (nl = rest.find('\n')) != std::string_view::npos; rest.remove_prefix(nl + 1))
+            pieces.push_back(rest.substr(0, nl));
+        pieces.push_back(rest);
+        lines.replace(line, 1, pieces);
+    }
+
+    void spliceDelete(uint64_t pos, uint64_t length) {
+        uint64_t end = pos + length;
+        size_t first = clampOffset(pos);
+        size_t last = clampOffset(end);
+        std::string merged(lines[first].substr(0, pos));
+        merged += lines[last].substr(end);
+        lines.replace(first, last - first + 1, {merged});
+    }
+
+    void pushLineDelta(int line, uint32_t count, uint32_t saved) {
+        EditDelta delta;
+        delta.line = (uint32_t)line;
+        delta.count = count;
+        for (uint32_t i = 0; i < saved; ++i)
+            delta.text.push_back(std::string(lineAt(line + i)));
+        pushDelta(std::move(delta));
+    }
+
+    // currentLine (di currentLineIndex) + `next` jadi satu baris
+    void joinNext(const std::string& next) {
+        pushLineDelta(currentLineIndex, 1, 2);
+        currentLine += next;
+        lines.set(currentLineIndex, currentLine);
+        lines.erase(currentLineIndex + 1);
+        isStartOfWord = true;
+    }
+
+    void swapWithNext(int line) {
+        commitCurrentLine();
+        pushLineDelta(line, 2, 2);
+        std::string upper(lines[line]);
+        std::string lower(lines[line + 1]);
+        formats.flush();
+        formats.muted = true;
+        lines.set(line, lower);
+        lines.set(line + 1, upper);
+        formats.muted = false;
+        formats.swapLines(line);
+        currentLineIndex = currentLineIndex == line ? line + 1 : line;
+        currentLine = std::string(lines[currentLineIndex]);
+    }
+
+    // Pindahkan satu grup delta dari `from` ke `to` (undo atau redo). Urutan
+    // grup terbalik di stack tujuan, jadi tanda `chained` dipasang ulang:
+    // semua kecuali delta pertama yang diterapkan.
+    bool unwind(ManualStack<EditDelta>& from, ManualStack<EditDelta>& to) {
+        unwound.clear();
+        bool applied = false;
+        while (!from.empty()) {
+            bool chained = from.top().chained;
+            StackTraits<EditDelta>::encode(unwound, from.top());
+            EditDelta inverse = applyDelta(from.top());
+            inverse.chained = applied;
+            to.push(std::move(inverse));
+            from.pop();
+            applied = true;
+            if (!chained) break;
+        }
+        return applied;
+    }
+
+    // Undo/redo dari journal: delta yang diterapkan ada di payload. Stack
+    // replay hanya berisi entri sejak J_BASE/J_SNAPSHOT, yaitu bagian atas
+    // stack sesi aslinya, jadi entrinya dibuang sebanyak yang tersedia.
+    void replayUnwind(const std::string& payload, ManualStack<EditDelta>& from, ManualStack<EditDelta>& to) {
+        loadHistory();
+        const char* p = payload.data();
+        const char* end = p + payload.size();
+        bool applied = false;
+        EditDelta delta;
+        while (p < end && StackTraits<EditDelta>::decode(p, end, delta)) {
+            if (!from.empty())
+                from.pop();
+            EditDelta inverse = applyDelta(delta);
+            inverse.chained = applied;
+            to.push(std::move(inverse));
+            applied = true;
+            delta = EditDelta();
+        }
+    }
+
+    // Sebelum edit multi-kursor semua baris harus ada di store
+    void prepareCursors() {
+        if (currentLineIndex >= (int)lines.size())
+            syncCurrentLine();
+        commitCurrentLine();
+    }
+
+    // Edit dan gerakan tidak mengubah urutan kursor di satu baris, jadi
+    // cukup buang duplikat dan kursor yang menimpa kursor utama
+    void dropDuplicateCursors(const Cursor& primary) {
+        auto last = std::unique(extraCursors.begin(), extraCursors.end());
+        last = std::remove(extraCursors.begin(), last, primary);
+        extraCursors.erase(last, extraCursors.end());
+    }
+
+    // Operasi yang berlaku untuk semua kursor; operasi lain kembali ke satu
+    // kursor dulu. Mengembalikan true jika operasi sudah ditangani.
+    bool applyMultiOp(JournalOp op, const std::string& payload) {
+        switch (op) {
+        case J_INSERT: editAllCursors(MULTI_INSERT, payload); return true;
+        case J_BACKSPACE: editAllCursors(MULTI_BACKSPACE, payload); return true;
+        case J_DELETE_FORWARD: editAllCursors(MULTI_DELETE, payload); return true;
+        case J_PASTE:
+            if (payload.find('\n') != std::string::npos) break;
+            isStartOfWord = true;
+            editAllCursors(MULTI_INSERT, payload);
+            return true;
+        case J_MOVE_LEFT: moveAllCursors(&Document::moveLeft); return true;
+        case J_MOVE_RIGHT: moveAllCursors(&Document::moveRight); return true;
+        case J_WORD_LEFT: moveAllCursors(&Document::moveWordLeft); return true;
+        case J_WORD_RIGHT: moveAllCursors(&Document::moveWordRight); return true;
+        case J_HOME: moveAllCursors(&Document::moveHome); return true;
+        case J_END: moveAllCursors(&Document::moveEnd); return true;
+        case J_ADD_CURSOR_BELOW:
+        case J_ADD_CURSORS_AT_WORD:
+        case J_CLEAR_CURSORS:
+        case J_TOGGLE_BOLD:
+        case J_TOGGLE_ITALIC:
+        case J_TOGGLE_UNDERLINE:
+            return false;
+        default:
+            break;
+        }
+        clearCursors();
+        return false;
+    }
+
+    // Bangun ulang satu baris untuk kursor [first, last) yang terurut. Offset
+    // kursor diganti dengan posisinya di baris hasil.
+    static std::string rebuildLine(std::string_view text, Cursor* first, Cursor* last,
+                                   MultiEdit kind, const std::string& insert) {
+        std::string out;
+        out.reserve(text.size() + (kind == MULTI_INSERT ? insert.size() * (last - first) : 0));
+        size_t pos = 0;
+        for (Cursor* c = first; c != last; ++c) {
+            size_t at = std::max<size_t>(std::min<size_t>(c->offset, text.size()), pos);
+            if (kind == MULTI_INSERT) {
+                out.append(text.substr(pos, at - pos));
+                out += insert;
+                pos = at;
+            } else if (kind == MULTI_BACKSPACE) {
+                size_t start = at > 0 ? std::max(prevGrapheme(text, at), pos) : pos;
+                out.append(text.substr(pos, start - pos));
+                pos = at;
+            } else {
+                out.append(text.substr(pos, at - pos));
+                pos = at < text.size() ? nextGrapheme(text, at) : at;
+            }
+            c->offset = (uint32_t)out.size();
+        }
+        out.append(text.substr(pos));
+        return out;
+    }
+
+    // Terapkan delta undo/redo, kembalikan delta kebalikannya
+    EditDelta applyDelta(const EditDelta& delta) {
+        if (currentLineIndex >= (int)lines.size())
+            syncCurrentLine();
+        commitCurrentLine();
+        size_t first = std::min<size_t>(delta.line, lines.size());
+        size_t count = std::min<size_t>(delta.count, lines.size() - first);
+        EditDelta inverse;
+        inverse.line = (uint32_t)first;
+        inverse.count = (uint32_t)delta.text.size();
+        for (size_t i = first; i < first + count; ++i)
+            inverse.text.push_back(std::string(lines[i]));
+
+        std::vector<std::string_view> with(delta.text.begin(), delta.text.end());
+        lines.replace(first, count, with);
+        if (lines.empty())
+            lines.push_back("");
+        currentLineIndex = (int)std::min(first + (with.empty() ? 0 : with.size() - 1), lines.size() - 1);
+        currentLine = std::string(lines[currentLineIndex]);
+        cursor = currentLine.size();
+        return inverse;
+    }
+
+    // Baris aktif dan format yang masih tertunda masuk store dulu
+    void settleForSnapshot() {
+        if (currentLineIndex >= (int)lines.size())
+            syncCurrentLine();
+        commitCurrentLine();
+        formats.flush();
+    }
+
+    std::shared_ptr<LineStore::Snapshot> snapshotLines() {
+        settleForSnapshot();
+        return lines.snapshot();
+    }
+
+    static bool writeLines(const std::string& target, const std::vector<std::string_view>& views) {
+        std::ofstream file(target);
+        if (!file)
+            return false;
+        for (std::string_view line : views) {
+            file.write(line.data(), line.size());
+            file.put('\n');
+        }
+        file.close();
+        if (file.fail()) return false; // mis. ENOSPC saat flush
+        return syncFile(target);
+    }
+
+    // File tersimpan jadi dasar baru, journal cukup mencatat posisi kursor.
+    // `snapshot` = versi isi yang ditulis ke file.
+    void finishSave(uint64_t snapshot) {
+        recordFileStat();
+        if (snapshot == version) {
+            journal.reset(J_BASE, encodeState(false));
+            modified = false;
+        }
+        log->write("Save to " + path);
+    }
+
+    static const size_t TAIL_CHECK_BYTES = 64;
+
+    void recordFileStat() {
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            fileSize = st.st_size;
+            fileMtime = st.st_mtime;
+            fileInode = st.st_ino;
+            fileTail = readFileRange(fileSize - std::min<off_t>(fileSize, TAIL_CHECK_BYTES), fileSize);
+        }
+    }
+
+    std::string readFileRange(off_t from, off_t to) const {
+        std::string out;
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return out;
+        out.resize(to - from);
+        size_t done = 0;
+        while (done < out.size()) {
+            ssize_t n = pread(fd, &out[done], out.size() - done, from + done);
+            if (n <= 0) break;
+            done += n;
+        }
+        out.resize(done);
+        ::close(fd);
+        return out;
+    }
+
+    // Byte terakhir yang dulu dibaca masih sama = file hanya ditambah
+    bool tailUnchanged() const {
+        return readFileRange(fileSize - (off_t)fileTail.size(), fileSize) == fileTail;
+    }
+
+    // Baca byte [fileSize, newSize) dan tambahkan sebagai baris, dengan aturan
+    // yang sama seperti getline di readFileLines: potongan sebelum \n pertama
+    // menyambung baris terakhir kalau file lama tidak diakhiri \n
+    bool appendFromDisk(const struct stat& st) {
+        std::string tail = readFileRange(fileSize, st.st_size);
+        if (tail.empty()) return false;
+        commitCurrentLine();
+        bool phantom = currentLineIndex >= (int)lines.size(); // baris kosong yang belum ada di store
+        bool joinLast = !lines.empty() && !fileTail.empty() && fileTail.back() != '\n';
+        bool activeChanged = phantom || (joinLast && currentLineIndex == (int)lines.size() - 1);
+        size_t start = 0;
+        while (start < tail.size()) {
+            size_t end = tail.find('\n', start);
+            if (end == std::string::npos) end = tail.size();
+            std::string_view piece(tail.data() + start, end - start);
+            std::string repaired;
+            if (!validateUtf8(piece)) {
+                repaired = std::string(piece);
+                repairUtf8(repaired);
+                piece = repaired;
+            }
+            if (joinLast) {
+                lines.set(lines.size() - 1, std::string(lines[lines.size() - 1]) + std::string(piece));
+                joinLast = false;
+            } else {
+                lines.push_back(piece);
+            }
+            start = end + 1;
+        }
+        if (activeChanged) {
+            currentLineIndex = std::min(currentLineIndex, (int)lines.size() - 1);
+            currentLine = std::string(lines[currentLineIndex]);
+            cursor = std::min(cursor, currentLine.size());
+            journal.reset(J_BASE, encodeState(false)); // baris aktif ikut berubah
+        }
+        // Dicatat sampai byte yang benar-benar dibaca; kalau file sudah
+        // bertambah lagi, event berikutnya melanjutkan dari sini
+        formats.flush();
+        fileSize += (off_t)tail.size();
+        fileMtime = st.st_mtime;
+        fileTail += tail;
+        if (fileTail.size() > TAIL_CHECK_BYTES)
+            fileTail.erase(0, fileTail.size() - TAIL_CHECK_BYTES);
+        log->write("Append from disk: " + path + " (" + std::to_string(tail.size()) + " bytes)");
+        return true;
+    }
+
+    // Isi lama tidak berlaku lagi: riwayat undo dan kursor tambahan dibuang,
+    // kursor tetap di nomor baris yang sama sebisanya
+    void reloadFromDisk() {
+        size_t line = currentLineIndex;
+        loadFromFile();
+        moveTo(line);
+        loadHistory();
+        undoStack.clear();
+        redoStack.clear();
+        extraCursors.clear();
+        version++;
+        journal.reset(J_BASE, encodeState(false));
+        log->write("Reload from disk: " + path);
+    }
+
+    bool fileUnchanged() const {
+        struct stat st;
+        return fileSize >= 0 && stat(path.c_str(), &st) == 0 &&
+               st.st_size == fileSize && st.st_mtime == fileMtime;
+    }
+
+    bool savedHashesFresh() const {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0)
+            return savedHashSize < 0 && savedHashes.empty();
+        return st.st_size == savedHashSize && st.st_mtime == savedHashMtime;
+    }
+
+    void readSavedHashes() {
+        savedHashes.clear();
+        savedHashSize = -1;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !readSavedLines(path, [this](std::string_view line) {
+                savedHashes.push_back(LineStore::lineHash(line));
+                return true;
+            }))
+            return;
+        savedHashSize = st.st_size;
+        savedHashMtime = st.st_mtime;
+    }
+
+    // Serialisasi state editor untuk journal (J_BASE tanpa baris, J_SNAPSHOT lengkap)
+    std::string encodeState(bool withLines) {
+        commitCurrentLine();
+        std::string out;
+        journalPutU32(out, (uint32_t)currentLineIndex);
+        out += (char)((isBold ? 1 : 0) | (isItalic ? 2 : 0) |
+                      (underlineActive ? 4 : 0) | (isStartOfWord ? 8 : 0));
+        journalPutU32(out, (uint32_t)currentLine.size());
+        out += currentLine;
+        journalPutU32(out, (uint32_t)cursor);
+        journalPutU32(out, (uint32_t)extraCursors.size());
+        for (const Cursor& c : extraCursors) {
+            journalPutU32(out, c.line);
+            journalPutU32(out, c.offset);
+        }
+        if (withLines) {
+            journalPutU32(out, (uint32_t)lines.size());
+            for (std::string_view line : lines) {
+                journalPutU32(out, (uint32_t)line.size());
+                out += line;
+            }
+        }
+        formats.flush();
+        formats.encode(out);
+        return out;
+    }
+
+    void decodeState(const std::string& data, bool withLines) {
+        currentLineIndex = (int)journalGetU32(data.data());
+        char flags = data[4];
+        isBold = flags & 1;
+        isItalic = flags & 2;
+        underlineActive = flags & 4;
+        isStartOfWord = flags & 8;
+        uint32_t len = journalGetU32(data.data() + 5);
+        currentLine = data.substr(9, len);
+        cursor = std::min<size_t>(journalGetU32(data.data() + 9 + len), currentLine.size());
+        size_t pos = 13 + len;
+        extraCursors.resize(journalGetU32(data.data() + pos));
+        pos += 4;
+        for (Cursor& c : extraCursors) {
+            c.line = journalGetU32(data.data() + pos);
+            c.offset = journalGetU32(data.data() + pos + 4);
+            pos += 8;
+        }
+        if (withLines) {
+            formats.clear();
+            lines.clear();
+            uint32_t count = journalGetU32(data.data() + pos);
+            pos += 4;
+            for (uint32_t i = 0; i < count; ++i) {
+                len = journalGetU32(data.data() + pos);
+                lines.push_back(std::string_view(data).substr(pos + 4, len));
+                pos += 4 + len;
+            }
+        }
+        if (pos < data.size()) // journal lama tidak punya bagian format
+            formats.decode(data.data() + pos, data.size() - pos);
+        undoStack.clear();
+        redoStack.clear();
+    }
+
+    // File native dipasang lewat mmap (native.h) dan tetap terbuka di
+    // `nativeOut` untuk dibaca atribut/riwayatnya; selain itu dibaca per baris.
+    // `native` hanya menentukan format simpan: path .pkd yang isinya teks
+    // biasa (atau kosong) dibaca sebagai teks dan nanti disimpan sebagai .pkd.
+    bool readFileLines(NativeFile* nativeOut = nullptr) {
+        lines.clear();
+        NativeFile nativeFile;
+        if (nativeFile.open(path)) {
+            native = true;
+            mapped = true;
+            nativeFile.loadInto(lines);
+            recordFileStat();
+            if (nativeOut) *nativeOut = std::move(nativeFile);
+            return true;
+        }
+        native = isNativePath(path);
+        mapped = false;
+        if (nativeFile.corrupt()) {
+            log->write("Corrupt native file: " + path);
+            return false;
+        }
+        std::ifstream file(path);
+        if (!file)
+            return false;
+        std::string line;
+        size_t repaired = 0;
+        while (std::getline(file, line)) {
+            repaired += repairUtf8(line);
+            lines.push_back(line);
+        }
+        lines.shrink_to_fit();
+        if (repaired)
+            log->write("Invalid UTF-8 replaced in " + std::to_string(repaired) + " lines: " + path);
+        recordFileStat();
+        return true;
+    }
+
+    // `withHistory`: riwayat undo yang disimpan di file native ikut dipulihkan
+    bool loadFromFile(bool withHistory = false) {
+        formats.clear(); // file teks biasa tidak membawa format
+        NativeFile nativeFile;
+        if (!readFileLines(&nativeFile))
+            return false;
+        if (nativeFile.isOpen()) {
+            std::string_view attrs = nativeFile.attrs();
+            formats.decode(attrs.data(), attrs.size());
+            if (withHistory && !nativeFile.history().empty()) {
+                history.append(nativeFile.history().data(), nativeFile.history().size());
+                PagedText::Reader reader(history);
+                unpackHistory(reader);
+                history.release();
+            }
+        }
+        currentLineIndex = 0;
+        currentLine = lines.empty() ? "" : std::string(lines[0]);
+        cursor = currentLine.size();
+        return true;
+    }
+
+    // Replay journal sisa sesi yang crash ke atas file tersimpan terakhir
+    size_t recover() {
+        log->muted = true;
+        size_t count = Journal::replay(journalPath(), [this](JournalOp op, const std::string& payload) {
+            if (op == J_BASE) {
+                loadFromFile();
+                decodeState(payload, false);
+            } else if (op == J_SNAPSHOT) {
+                decodeState(payload, true);
+            } else {
+                applyOp(op, payload);
+            }
+        });
+        log->muted = false;
+        return count;
+    }
+};
+
+#endif
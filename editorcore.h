@@ -0,0 +1,406 @@
+#ifndef EDITORCORE_H
+#define EDITORCORE_H
+
+// Inti editor baris sederhana (model varian lama: baris aktif + daftar
+// baris, undo per kata) yang ditemplate pada tiga policy, jadi setiap
+// kombinasi dikompilasi tanpa virtual call di jalur ketik:
+//
+//   Buffer  penyimpanan baris
+//           VectorBuffer   vector<string> (pagiini, sukses3)
+//           StoreBuffer    LineStore (bismillahbisa, Document)
+//   Undo    riwayat undo/redo
+//           SnapshotUndo<Stack>  isi baris utuh sebelum diubah (pushToUndo),
+//                                di atas ManualStack atau std::stack
+//           DeltaUndo            hanya potongan yang berubah
+//   Log     log aktivitas
+//           FileLog        .log.txt dengan timestamp (logAction)
+//           NullLog        tidak ada log; panggilannya hilang saat kompilasi
+//
+// Policy undo memanggil balik core lewat lineText(i) dan setLine(i, text),
+// juga tanpa virtual call karena tipenya parameter template.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stack>
+#include <fstream>
+#include <ctime>
+#include <cstdint>
+#include <algorithm>
+#include "manualstack.h"
+#include "linestore.h"
+#include "utf8.h"
+
+class VectorBuffer {
+public:
+    size_t size() const {
+        return lines.size();
+    }
+
+    std::string_view get(size_t i) const {
+        return lines[i];
+    }
+
+    void set(size_t i, std::string_view text) {
+        lines[i].assign(text.data(), text.size());
+    }
+
+    void insert(size_t i, std::string_view text) {
+        lines.insert(lines.begin() + i, std::string(text));
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = lines.capacity() * sizeof(std::string);
+        for (const std::string& line : lines)
+            bytes += line.capacity() > 15 ? line.capacity() + 1 : 0; // di bawah itu masuk SSO
+        return bytes;
+    }
+
+private:
+    std::vector<std::string> lines;
+};
+
+class StoreBuffer {
+public:
+    size_t size() const {
+        return lines.size();
+    }
+
+    std::string_view get(size_t i) const {
+        return lines[i];
+    }
+
+    void set(size_t i, std::string_view text) {
+        lines.set(i, text);
+    }
+
+    void insert(size_t i, std::string_view text) {
+        lines.insert(i, text);
+    }
+
+    size_t memoryBytes() const {
+        return lines.memoryBytes();
+    }
+
+private:
+    LineStore lines;
+};
+
+// Satu entri per checkpoint: nomor baris dan isinya sebelum diubah.
+// `Stack` = ManualStack atau std::stack.
+template<template<typename...> class Stack>
+class SnapshotUndo {
+public:
+    template<typename Core>
+    void record(Core&, uint32_t line, const std::string& before) {
+        if (!undoStack.empty() && undoStack.top().line == line && undoStack.top().text == before)
+            return;
+        push(undoStack, {line, before});
+        while (!redoStack.empty())
+            pop(redoStack);
+    }
+
+    template<typename Core>
+    bool undo(Core& core) {
+        return swapTop(core, undoStack, redoStack);
+    }
+
+    template<typename Core>
+    bool redo(Core& core) {
+        return swapTop(core, redoStack, undoStack);
+    }
+
+    size_t depth() const {
+        return undoStack.size();
+    }
+
+    size_t memoryBytes() const {
+        return bytes;
+    }
+
+private:
+    struct Entry {
+        uint32_t line;
+        std::string text;
+    };
+
+    Stack<Entry> undoStack;
+    Stack<Entry> redoStack;
+    size_t bytes = 0;
+
+    static size_t cost(const Entry& e) {
+        return sizeof(Entry) + (e.text.capacity() > 15 ? e.text.capacity() + 1 : 0);
+    }
+
+    void push(Stack<Entry>& stack, Entry&& e) {
+        bytes += cost(e);
+        stack.push(std::move(e));
+    }
+
+    void pop(Stack<Entry>& stack) {
+        bytes -= cost(stack.top());
+        stack.pop();
+    }
+
+    template<typename Core>
+    bool swapTop(Core& core, Stack<Entry>& from, Stack<Entry>& to) {
+        if (from.empty()) return false;
+        bytes -= cost(from.top());
+        Entry e = std::move(from.top());
+        from.pop();
+        push(to, {e.line, std::string(core.lineText(e.line))});
+        core.setLine(e.line, e.text);
+        return true;
+    }
+};
+
+using ManualSnapshotUndo = SnapshotUndo<ManualStack>;
+using StdStackSnapshotUndo = SnapshotUndo<std::stack>;
+
+// Alternatif: entri hanya menyimpan potongan yang berubah. Checkpoint
+// menyalin baris sekali (pending); saat checkpoint berikutnya atau undo,
+// isi baris sekarang dibandingkan dengan salinan itu dan yang disimpan cuma
+// selisihnya (prefix/suffix yang sama dibuang). Mengetik di baris panjang
+// tidak lagi menyimpan baris utuh per kata.
+class DeltaUndo {
+public:
+    template<typename Core>
+    void record(Core& core, uint32_t line, const std::string& before) {
+        settle(core);
+        pending = true;
+        pendingLine = line;
+        pendingText = before;
+        redoStack.clear();
+        redoBytes = 0;
+    }
+
+    template<typename Core>
+    bool undo(Core& core) {
+        settle(core);
+        return swapTop(core, undoStack, undoBytes, redoStack, redoBytes);
+    }
+
+    template<typename Core>
+    bool redo(Core& core) {
+        settle(core);
+        return swapTop(core, redoStack, redoBytes, undoStack, undoBytes);
+    }
+
+    size_t depth() const {
+        return undoStack.size() + (pending ? 1 : 0);
+    }
+
+    size_t memoryBytes() const {
+        return undoBytes + redoBytes + pendingText.capacity();
+    }
+
+private:
+    // Diterapkan ke isi baris: text.replace(start, removed, inserted)
+    struct Delta {
+        uint32_t line;
+        uint32_t start;
+        uint32_t removed;
+        std::string inserted;
+    };
+
+    ManualStack<Delta> undoStack;
+    ManualStack<Delta> redoStack;
+    size_t undoBytes = 0;
+    size_t redoBytes = 0;
+    bool pending = false;
+    uint32_t pendingLine = 0;
+    std::string pendingText;
+
+    static size_t cost(const Delta& d) {
+        return sizeof(Delta) + (d.inserted.capacity() > 15 ? d.inserted.capacity() + 1 : 0);
+    }
+
+    // Delta yang mengubah `from` jadi `to`
+    static Delta between(uint32_t line, std::string_view from, std::string_view to) {
+        size_t shorter = std::min(from.size(), to.size());
+        size_t prefix = 0;
+        while (prefix < shorter && from[prefix] == to[prefix])
+            prefix++;
+        size_t suffix = 0;
+        while (suffix < shorter - prefix && from[from.size() - 1 - suffix] == to[to.size() - 1 - suffix])
+            suffix++;
+        return Delta{line, (uint32_t)prefix, (uint32_t)(from.size() - prefix - suffix),
+                     std::string(to.substr(prefix, to.size() - prefix - suffix))};
+    }
+
+    template<typename Core>
+    void settle(Core& core) {
+        if (!pending) return;
+        pending = false;
+        std::string_view now = core.lineText(pendingLine);
+        if (now == pendingText) return;
+        undoStack.push(between(pendingLine, now, pendingText));
+        undoBytes += cost(undoStack.top());
+    }
+
+    template<typename Core>
+    bool swapTop(Core& core, ManualStack<Delta>& from, size_t& fromBytes, ManualStack<Delta>& to, size_t& toBytes) {
+        if (from.empty()) return false;
+        Delta d = std::move(from.top());
+        fromBytes -= cost(d);
+        from.pop();
+        std::string current(core.lineText(d.line));
+        std::string restored = current;
+        restored.replace(d.start, d.removed, d.inserted);
+        to.push(between(d.line, restored, current));
+        toBytes += cost(to.top());
+        core.setLine(d.line, restored);
+        return true;
+    }
+};
+
+// Log aktivitas ke file, satu baris bertimestamp per aksi seperti logAction
+// varian lama (di-flush setiap baris)
+class FileLog {
+public:
+    void open(const std::string& path) {
+        file.open(path, std::ios::app);
+    }
+
+    template<typename... Parts>
+    void write(const Parts&... parts) {
+        if (!file.is_open()) return;
+        time_t now = time(0);
+        struct tm* timeinfo = localtime(&now);
+        char timestamp[32];
+        strftime(timestamp, sizeof(timestamp), "%d-%m-%Y[%H:%M:%S]", timeinfo);
+        file << "[" << timestamp << "] - ";
+        (file << ... << parts);
+        file << std::endl;
+    }
+
+private:
+    std::ofstream file;
+};
+
+class NullLog {
+public:
+    void open(const std::string&) {}
+
+    template<typename... Parts>
+    void write(const Parts&...) {}
+};
+
+template<typename Buffer, typename Undo, typename Log>
+class EditorCore {
+public:
+    Buffer buffer;
+    Undo history;
+    Log log;
+    std::string currentLine;
+    size_t currentLineIndex = 0;
+
+    EditorCore() {
+        buffer.insert(0, "");
+    }
+
+    size_t lineCount() const {
+        return buffer.size();
+    }
+
+    // Isi baris ke-i; baris aktif diambil dari currentLine
+    std::string_view lineText(size_t i) const {
+        return i == currentLineIndex ? std::string_view(currentLine) : buffer.get(i);
+    }
+
+    void setLine(size_t i, const std::string& text) {
+        buffer.set(i, text);
+        if (i == currentLineIndex) currentLine = text;
+    }
+
+    void insertChar(char ch) {
+        if (isStartOfWord) {
+            history.record(*this, (uint32_t)currentLineIndex, currentLine);
+            isStartOfWord = false;
+        }
+        currentLine += ch;
+        if (ch == ' ') isStartOfWord = true;
+    }
+
+    void backspace() {
+        if (!currentLine.empty()) popGrapheme(currentLine);
+    }
+
+    void newline() {
+        history.record(*this, (uint32_t)currentLineIndex, currentLine);
+        commit();
+        buffer.insert(currentLineIndex + 1, "");
+        currentLineIndex++;
+        currentLine.clear();
+        isStartOfWord = true;
+        log.write("Newline at line: ", currentLineIndex);
+    }
+
+    void deleteLastWord() {
+        history.record(*this, (uint32_t)currentLineIndex, currentLine);
+        size_t pos = findLastSeparator(currentLine, currentLine.size());
+        currentLine.resize(pos != std::string::npos ? pos : 0);
+        isStartOfWord = true;
+        log.write("Delete last word: ", currentLine);
+    }
+
+    void undo() {
+        commit();
+        if (history.undo(*this)) log.write("Undo: ", currentLine);
+        isStartOfWord = true;
+    }
+
+    void redo() {
+        commit();
+        if (history.redo(*this)) log.write("Redo: ", currentLine);
+        isStartOfWord = true;
+    }
+
+    void moveUp() {
+        if (currentLineIndex == 0) return;
+        moveTo(currentLineIndex - 1);
+        log.write("Moved up to line: ", currentLine);
+    }
+
+    void moveDown() {
+        if (currentLineIndex + 1 >= buffer.size()) return;
+        moveTo(currentLineIndex + 1);
+        log.write("Moved down to line: ", currentLine);
+    }
+
+    bool save(const std::string& path) {
+        commit();
+        std::ofstream file(path);
+        if (!file) return false;
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            std::string_view line = buffer.get(i);
+            file.write(line.data(), line.size());
+            file.put('\n');
+        }
+        log.write("Save to ", path);
+        return (bool)file;
+    }
+
+    size_t memoryBytes() const {
+        return buffer.memoryBytes() + history.memoryBytes() + currentLine.capacity();
+    }
+
+private:
+    bool isStartOfWord = true;
+
+    // Baris aktif diedit di currentLine dan baru ditulis ke buffer saat
+    // pindah baris, undo atau simpan
+    void commit() {
+        if (buffer.get(currentLineIndex) != currentLine)
+            buffer.set(currentLineIndex, currentLine);
+    }
+
+    void moveTo(size_t line) {
+        commit();
+        currentLineIndex = line;
+        currentLine = std::string(buffer.get(line));
+        isStartOfWord = true;
+    }
+};
+
+#endif
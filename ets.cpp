@@ -1,22 +1,13 @@
 #include <iostream>
-#include <stack>
-#include <fstream>
 #include <vector>
 #include <string>
 #include <termios.h>
 #include <unistd.h>
+#include "utf8.h"
+#include "wordlist.h"
 
 using namespace std;
 
-// Node for Linked List
-struct Node {
-    string word;
-    string format;
-    Node* next;
-
-    Node(string w, string f) : word(w), format(f), next(nullptr) {}
-};
-
 // Terminal raw input (Linux)
 char getChar() {
     struct termios oldt, newt;
@@ -30,148 +21,6 @@ char getChar() {
     return ch;
 }
 
-// Text Editor Class
-class TextEditor {
-private:
-    Node* head;
-    stack<Node*> undoStack;
-    stack<Node*> redoStack;
-    ofstream logFile;
-    string currentFormat;
-
-public:
-    TextEditor() {
-        head = nullptr;
-        currentFormat = "";
-        logFile.open(".log.txt", ios::app); // hidden log
-    }
-
-    ~TextEditor() {
-        clearList();
-        logFile.close();
-    }
-
-    void clearList() {
-        Node* temp;
-        while (head) {
-            temp = head;
-            head = head->next;
-            delete temp;
-        }
-    }
-
-    void toggleFormat(char fmt) {
-        if (fmt == 'B') currentFormat = "[B]";
-        else if (fmt == 'N') currentFormat = "[I]";
-        else if (fmt == 'M') currentFormat = "[U]";
-        else currentFormat = "";
-    }
-
-    void addInput(const string& text) {
-        string word = "";
-        for (char ch : text + " ") {
-            if (ch == ' ') {
-                if (!word.empty()) {
-                    Node* newNode = new Node(word, currentFormat);
-                    appendNode(newNode);
-                    undoStack.push(newNode);
-                    log("Input: " + word + " " + currentFormat);
-                    word.clear();
-                }
-            } else {
-                word += ch;
-            }
-        }
-        // Clear redo stack karena input baru
-        while (!redoStack.empty()){
-            delete redoStack.top();
-            redoStack.pop();
-        }
-    }
-
-    void appendNode(Node* node) {
-        if (!head) head = node;
-        else {
-            Node* temp = head;
-            while (temp->next) temp = temp->next;
-            temp->next = node;
-        }
-    }
-
-    void deleteLastWord() {
-        if (!head) return;
-        if (!head->next) {
-            undoStack.push(head);
-            log("Delete: " + head->word);
-            head = nullptr;
-            return;
-        }
-
-        Node* temp = head;
-        while (temp->next && temp->next->next) temp = temp->next;
-        Node* del = temp->next;
-        temp->next = nullptr;
-        undoStack.push(del);
-        log("Delete: " + del->word);
-    }
-
-    void undo() {
-        if (undoStack.empty()) return;
-    
-        Node* last = undoStack.top(); undoStack.pop();
-        Node* removed = removeLastNode();
-    
-        if (removed) {
-            redoStack.push(removed);
-            log("Undo: " + removed->word);
-        }
-    }
-    
-
-    void redo() {
-        if (redoStack.empty()) return;
-        Node* redoNode = redoStack.top(); redoStack.pop();
-        appendNode(redoNode);
-        undoStack.push(redoNode);
-        log("Redo: " + redoNode->word);
-    }
-
-    Node* removeLastNode() {
-        if (!head) return nullptr;
-        if (!head->next) {
-            Node* temp = head;
-            head = nullptr;
-            return temp;
-        }
-    
-        Node* temp = head;
-        while (temp->next && temp->next->next) temp = temp->next;
-        Node* removed = temp->next;
-        temp->next = nullptr;
-        return removed;
-    }
-    
-
-    void displayText() {
-        Node* temp = head;
-        cout << "\nCurrent text: ";
-        while (temp) {
-            cout << temp->format << temp->word << " ";
-            temp = temp->next;
-        }
-        cout << endl;
-    }
-
-    void saveToFile() {
-        log("Saved to file.");
-        cout << "\n[SAVED TO .log.txt]\n";
-    }
-
-    void log(const string& activity) {
-        logFile << activity << endl;
-    }
-};
-
 // === MAIN ===
 
 int main() {
@@ -213,8 +62,13 @@ int main() {
                 continue;
             }else if (ch == 127 || ch == 8) {
                 if (!input.empty()) {
-                    input.pop_back(); // hapus 1 karakter dari input
-                    cout << "\b \b" << flush; // hapus dari layar: back, space, back
+                    // hapus 1 grapheme dari input, mundur selebar tampilannya
+                    size_t start = prevGrapheme(input, input.size());
+                    size_t width = displayWidth(string_view(input).substr(start));
+                    input.erase(start);
+                    for (size_t i = 0; i < width; ++i)
+                        cout << "\b \b"; // hapus dari layar: back, space, back
+                    cout << flush;
                 }
                 continue;
             
@@ -0,0 +1,244 @@
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+// Event loop berbasis epoll untuk loop utama editor.
+//
+// Semua sumber event jadi file descriptor yang di-multiplex satu epoll:
+// stdin, eventfd hasil worker (ThreadPool::completionFd), satu timerfd untuk
+// semua timer, dan signalfd untuk sinyal (SIGWINCH, SIGTERM, ...). Tidak ada
+// lagi read() yang memblok atau sleep(): pesan status kedaluwarsa lewat
+// timer, dan resize terminal langsung digambar ulang.
+//
+// Timer diberi id tetap (mis. TIMER_STATUS); setTimer dengan id yang sama
+// mengganti deadline lamanya. Jumlah timer sedikit, jadi cukup vector dan
+// timerfd dipasang ke deadline paling awal.
+//
+// Socket yang output-nya bisa tertahan (klien kolaborasi) memasang
+// onWritable dan menyalakan wantWrite() hanya selama masih ada antrean;
+// kalau terus dinyalakan, epoll membangunkan loop tanpa henti.
+
+#include <functional>
+#include <initializer_list>
+#include <vector>
+#include <chrono>
+#include <csignal>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+class EventLoop {
+public:
+    // Dipanggil setelah setiap batch event, mis. untuk memasang ulang timer
+    // dan menggambar layar sekali
+    std::function<void()> afterEvents;
+
+    EventLoop() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        watch(timerFd, [this] { runTimers(); });
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    ~EventLoop() {
+        if (signalFd >= 0) {
+            ::close(signalFd);
+            sigprocmask(SIG_UNBLOCK, &signalMask, nullptr);
+        }
+        ::close(timerFd);
+        ::close(epollFd);
+    }
+
+    bool watch(int fd, std::function<void()> onReadable) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0)
+            return false;
+        handlers.push_back({fd, std::move(onReadable), nullptr});
+        return true;
+    }
+
+    void watchWritable(int fd, std::function<void()> onWritable) {
+        for (Handler& handler : handlers)
+            if (handler.fd == fd) handler.onWritable = std::move(onWritable);
+    }
+
+    // Minta (atau berhenti minta) dibangunkan saat fd bisa ditulis
+    void wantWrite(int fd, bool enable) {
+        epoll_event ev{};
+        ev.events = enable ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+    }
+
+    void unwatch(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        for (size_t i = 0; i < handlers.size(); ++i) {
+            if (handlers[i].fd == fd) {
+                handlers.erase(handlers.begin() + i);
+                break;
+            }
+        }
+    }
+
+    // Sinyal diblok lalu dibaca lewat signalfd, jadi handler berjalan di loop
+    // utama seperti event lain (aman memanggil apa saja)
+    bool watchSignals(std::initializer_list<int> signals, std::function<void(int)> onSignal) {
+        sigemptyset(&signalMask);
+        for (int sig : signals)
+            sigaddset(&signalMask, sig);
+        if (sigprocmask(SIG_BLOCK, &signalMask, nullptr) < 0)
+            return false;
+        signalFd = signalfd(-1, &signalMask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (signalFd < 0)
+            return false;
+        return watch(signalFd, [this, onSignal] {
+            signalfd_siginfo info;
+            while (read(signalFd, &info, sizeof(info)) == (ssize_t)sizeof(info))
+                onSignal((int)info.ssi_signo);
+        });
+    }
+
+    void setTimer(int id, int ms, std::function<void()> fn) {
+        auto deadline = Clock::now() + std::chrono::milliseconds(ms < 0 ? 0 : ms);
+        for (Timer& timer : timers) {
+            if (timer.id == id) {
+                timer.deadline = deadline;
+                timer.fn = std::move(fn);
+                armTimer();
+                return;
+            }
+        }
+        timers.push_back({id, deadline, std::move(fn)});
+        armTimer();
+    }
+
+    void cancelTimer(int id) {
+        for (size_t i = 0; i < timers.size(); ++i) {
+            if (timers[i].id == id) {
+                timers.erase(timers.begin() + i);
+                armTimer();
+                return;
+            }
+        }
+    }
+
+    bool hasTimer(int id) const {
+        for (const Timer& timer : timers)
+            if (timer.id == id) return true;
+        return false;
+    }
+
+    void run() {
+        running = true;
+        if (afterEvents) afterEvents();
+        while (running && poll(-1) >= 0) {}
+    }
+
+    // Proses satu batch event (menunggu paling lama timeoutMs, -1 = tanpa
+    // batas). Dipakai run(), juga oleh benchmark yang menggerakkan beberapa
+    // editor dalam satu proses. Mengembalikan jumlah event, -1 kalau gagal.
+    int poll(int timeoutMs) {
+        epoll_event events[16];
+        int n = epoll_wait(epollFd, events, 16, timeoutMs);
+        if (n < 0)
+            return errno == EINTR ? 0 : -1;
+        for (int i = 0; i < n && running; ++i)
+            dispatch(events[i].data.fd, events[i].events);
+        if (running && afterEvents) afterEvents();
+        return n;
+    }
+
+    void stop() {
+        running = false;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Handler {
+        int fd;
+        std::function<void()> onReadable;
+        std::function<void()> onWritable;
+    };
+
+    struct Timer {
+        int id;
+        Clock::time_point deadline;
+        std::function<void()> fn;
+    };
+
+    int epollFd = -1;
+    int timerFd = -1;
+    int signalFd = -1;
+    sigset_t signalMask;
+    bool running = true; // false setelah stop(); sisa batch tidak di-dispatch
+    std::vector<Handler> handlers;
+    std::vector<Timer> timers;
+
+    void dispatch(int fd, uint32_t events) {
+        for (const Handler& handler : handlers) {
+            if (handler.fd == fd) {
+                auto onReadable = handler.onReadable; // handler boleh memanggil unwatch()
+                auto onWritable = handler.onWritable;
+                if ((events & EPOLLOUT) && onWritable)
+                    onWritable();
+                if (events & ~EPOLLOUT)
+                    dispatchReadable(fd, onReadable);
+                return;
+            }
+        }
+    }
+
+    // fd bisa sudah di-unwatch oleh onWritable
+    void dispatchReadable(int fd, const std::function<void()>& fn) {
+        for (const Handler& handler : handlers)
+            if (handler.fd == fd) {
+                fn();
+                return;
+            }
+    }
+
+    // timerfd dipasang ke deadline paling awal (0 = matikan)
+    void armTimer() {
+        itimerspec spec{};
+        if (!timers.empty()) {
+            Clock::time_point first = timers[0].deadline;
+            for (const Timer& timer : timers)
+                if (timer.deadline < first) first = timer.deadline;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(first - Clock::now()).count();
+            if (ns < 1) ns = 1; // sudah lewat: bangun secepatnya
+            spec.it_value.tv_sec = ns / 1000000000;
+            spec.it_value.tv_nsec = ns % 1000000000;
+        }
+        timerfd_settime(timerFd, 0, &spec, nullptr);
+    }
+
+    // Jalankan semua timer yang sudah jatuh tempo; callback boleh memasang
+    // timer lagi (termasuk dengan id yang sama)
+    void runTimers() {
+        uint64_t expirations;
+        if (read(timerFd, &expirations, sizeof(expirations)) < 0) {}
+        auto now = Clock::now();
+        std::vector<std::function<void()>> due;
+        for (size_t i = 0; i < timers.size();) {
+            if (timers[i].deadline <= now) {
+                due.push_back(std::move(timers[i].fn));
+                timers.erase(timers.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+        armTimer();
+        for (auto& fn : due)
+            fn();
+    }
+};
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+// Ekspor dokumen beserta atribut formatnya (format.h) ke HTML, Markdown
+// atau teks dengan escape ANSI.
+//
+// Output tidak pernah dirakit utuh di memori: formatter menulis ke
+// ChunkWriter, buffer tetap 1 MiB yang dikirim dengan satu write() setiap
+// kali penuh. Baris dibaca sebagai string_view dan potongan tanpa karakter
+// khusus disalin apa adanya, jadi dokumen besar diekspor kira-kira secepat
+// disk menulisnya.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "format.h"
+
+enum ExportFormat {
+    EXPORT_HTML,
+    EXPORT_MARKDOWN,
+    EXPORT_ANSI
+};
+
+// Format dari ekstensi file: .html/.htm, .md/.markdown, .ans/.ansi
+inline bool exportFormatFor(const std::string& path, ExportFormat& format) {
+    size_t dot = path.find_last_of('.');
+    std::string ext = dot == std::string::npos ? "" : path.substr(dot + 1);
+    if (ext == "html" || ext == "htm") format = EXPORT_HTML;
+    else if (ext == "md" || ext == "markdown") format = EXPORT_MARKDOWN;
+    else if (ext == "ans" || ext == "ansi") format = EXPORT_ANSI;
+    else return false;
+    return true;
+}
+
+class ChunkWriter {
+public:
+    static const size_t CAPACITY = 1 << 20;
+
+    explicit ChunkWriter(int fd) : fd(fd), buffer(new char[CAPACITY]) {}
+
+    ChunkWriter(const ChunkWriter&) = delete;
+    ChunkWriter& operator=(const ChunkWriter&) = delete;
+
+    void append(const char* data, size_t n) {
+        if (n > CAPACITY - used) {
+            flush();
+            if (n >= CAPACITY) { // potongan besar langsung ditulis tanpa disalin
+                writeAll(data, n);
+                return;
+            }
+        }
+        memcpy(buffer.get() + used, data, n);
+        used += n;
+    }
+
+    void append(std::string_view text) {
+        append(text.data(), text.size());
+    }
+
+    void put(char c) {
+        if (used == CAPACITY) flush();
+        buffer[used++] = c;
+    }
+
+    // false kalau ada write() yang gagal sejak awal
+    bool flush() {
+        if (used > 0) {
+            writeAll(buffer.get(), used);
+            used = 0;
+        }
+        return !failed;
+    }
+
+    uint64_t bytesWritten() const {
+        return written + used;
+    }
+
+private:
+    int fd;
+    std::unique_ptr<char[]> buffer;
+    size_t used = 0;
+    uint64_t written = 0;
+    bool failed = false;
+
+    void writeAll(const char* data, size_t n) {
+        while (n > 0 && !failed) {
+            ssize_t k = ::write(fd, data, n);
+            if (k < 0) {
+                if (errno == EINTR) continue;
+                failed = true;
+                return;
+            }
+            data += k;
+            n -= k;
+            written += k;
+        }
+    }
+};
+
+// Salin `text` dengan byte tertentu diganti: Formatter::escape(c)
+// mengembalikan penggantinya atau nullptr. Byte khusus dicari lewat tabel
+// 256 entri (dibuat sekali per formatter) dan potongan di antaranya
+// disalin sekaligus.
+template<typename Formatter>
+void appendEscaped(ChunkWriter& out, std::string_view text) {
+    static const struct Table {
+        const char* replacement[256];
+        uint8_t length[256]; // 0 = disalin apa adanya
+        Table() {
+            for (int c = 0; c < 256; ++c) {
+                replacement[c] = Formatter::escape((char)c);
+                length[c] = replacement[c] ? (uint8_t)strlen(replacement[c]) : 0;
+            }
+        }
+    } table;
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = (unsigned char)text[i];
+        if (!table.length[c]) continue;
+        out.append(text.data() + start, i - start);
+        out.append(table.replacement[c], table.length[c]);
+        start = i + 1;
+    }
+    out.append(text.data() + start, text.size() - start);
+}
+
+// <pre> berisi baris apa adanya; run berformat dibungkus <b>/<i>/<u> yang
+// ditutup di akhir run, jadi setiap baris HTML-nya berdiri sendiri
+struct HtmlFormatter {
+    static const char* escape(char c) {
+        switch (c) {
+        case '&': return "&amp;";
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        default: return nullptr;
+        }
+    }
+
+    void begin(ChunkWriter& out, std::string_view title) {
+        out.append("<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>");
+        appendEscaped<HtmlFormatter>(out, title);
+        out.append("</title>\n</head>\n<body>\n<pre>\n");
+    }
+
+    void line(ChunkWriter& out, std::string_view text, const LineAttrs* attrs) {
+        forEachAttrRun(text, attrs, [&](std::string_view piece, uint8_t attr) {
+            if (attr & ATTR_BOLD) out.append("<b>");
+            if (attr & ATTR_ITALIC) out.append("<i>");
+            if (attr & ATTR_UNDERLINE) out.append("<u>");
+            appendEscaped<HtmlFormatter>(out, piece);
+            if (attr & ATTR_UNDERLINE) out.append("</u>");
+            if (attr & ATTR_ITALIC) out.append("</i>");
+            if (attr & ATTR_BOLD) out.append("</b>");
+        });
+        out.put('\n');
+    }
+
+    void end(ChunkWriter& out) {
+        out.append("</pre>\n</body>\n</html>\n");
+    }
+};
+
+// Bold = **, italic = *, underline = <u> (Markdown tidak punya underline,
+// HTML inline diizinkan CommonMark). Spasi di tepi run diletakkan di luar
+// penanda karena "** teks**" tidak dikenali sebagai emphasis. Baris yang
+// bersebelahan disambung dengan hard break (\ di akhir baris) supaya
+// pemisahan baris editor tetap terlihat.
+struct MarkdownFormatter {
+    bool started = false;
+    bool previousText = false;
+
+    static const char* escape(char c) {
+        switch (c) {
+        case '\\': return "\\\\";
+        case '`': return "\\`";
+        case '*': return "\\*";
+        case '_': return "\\_";
+        case '[': return "\\[";
+        case ']': return "\\]";
+        case '<': return "\\<";
+        case '>': return "\\>";
+        case '&': return "\\&";
+        default: return nullptr;
+        }
+    }
+
+    void begin(ChunkWriter&, std::string_view) {}
+
+    void line(ChunkWriter& out, std::string_view text, const LineAttrs* attrs) {
+        if (started)
+            out.append(previousText && !text.empty() ? "\\\n" : "\n");
+        started = true;
+        previousText = !text.empty();
+        size_t blockMarker = blockMarkerAt(text);
+        forEachAttrRun(text, attrs, [&](std::string_view piece, uint8_t attr) {
+            size_t lead = 0, trail = 0;
+            if (attr) {
+                while (lead < piece.size() && (piece[lead] == ' ' || piece[lead] == '\t'))
+                    lead++;
+                while (trail < piece.size() - lead &&
+                       (piece[piece.size() - 1 - trail] == ' ' || piece[piece.size() - 1 - trail] == '\t'))
+                    trail++;
+            }
+            std::string_view core = piece.substr(lead, piece.size() - lead - trail);
+            out.append(piece.substr(0, lead));
+            if (!core.empty()) {
+                if (attr & ATTR_UNDERLINE) out.append("<u>");
+                if (attr & ATTR_BOLD) out.append("**");
+                if (attr & ATTR_ITALIC) out.put('*');
+            }
+            // Penanda blok di awal baris (#, -, 1. dst.) di-escape sekali
+            size_t offset = core.data() - text.data();
+            if (blockMarker != std::string::npos && blockMarker >= offset && blockMarker < offset + core.size()) {
+                size_t k = blockMarker - offset;
+                appendEscaped<MarkdownFormatter>(out, core.substr(0, k));
+                out.put('\\');
+                appendEscaped<MarkdownFormatter>(out, core.substr(k));
+            } else {
+                appendEscaped<MarkdownFormatter>(out, core);
+            }
+            if (!core.empty()) {
+                if (attr & ATTR_ITALIC) out.put('*');
+                if (attr & ATTR_BOLD) out.append("**");
+                if (attr & ATTR_UNDERLINE) out.append("</u>");
+            }
+            out.append(piece.substr(piece.size() - trail));
+        });
+    }
+
+    void end(ChunkWriter& out) {
+        if (started) out.put('\n');
+    }
+
+    // Posisi byte yang membuat baris dibaca sebagai heading, daftar,
+    // garis atau kutipan, npos kalau tidak ada. '>' sudah di-escape di mana
+    // saja, jadi tidak perlu di sini.
+    static size_t blockMarkerAt(std::string_view text) {
+        size_t i = 0;
+        while (i < 3 && i < text.size() && text[i] == ' ')
+            i++;
+        if (i >= text.size()) return std::string::npos;
+        char c = text[i];
+        if (c == '#' || c == '-' || c == '+' || c == '=') return i;
+        size_t digits = i;
+        while (digits < text.size() && digits - i < 9 && text[digits] >= '0' && text[digits] <= '9')
+            digits++;
+        if (digits > i && digits < text.size() && (text[digits] == '.' || text[digits] == ')'))
+            return digits;
+        return std::string::npos;
+    }
+};
+
+// Teks biasa dengan SGR; escape hanya dikirim saat atribut berubah dan
+// direset di akhir baris berformat (untuk cat/less -R)
+struct AnsiFormatter {
+    void begin(ChunkWriter&, std::string_view) {}
+
+    void line(ChunkWriter& out, std::string_view text, const LineAttrs* attrs) {
+        uint8_t active = 0;
+        forEachAttrRun(text, attrs, [&](std::string_view piece, uint8_t attr) {
+            if (attr != active) {
+                out.append("\033[0");
+                if (attr & ATTR_BOLD) out.append(";1");
+                if (attr & ATTR_ITALIC) out.append(";3");
+                if (attr & ATTR_UNDERLINE) out.append(";4");
+                out.put('m');
+                active = attr;
+            }
+            out.append(piece);
+        });
+        if (active) out.append("\033[0m");
+        out.put('\n');
+    }
+
+    void end(ChunkWriter&) {}
+};
+
+// Baris ke-i memakai entri `spans` dengan line == i; spans terurut, jadi
+// cukup satu penunjuk yang maju bersama baris
+template<typename Formatter>
+void exportWith(ChunkWriter& out, Formatter formatter, const std::vector<std::string_view>& lines,
+                const std::vector<FormattedLine>& spans, std::string_view title) {
+    formatter.begin(out, title);
+    size_t next = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        while (next < spans.size() && spans[next].line < i)
+            next++;
+        const LineAttrs* attrs = next < spans.size() && spans[next].line == i ? &spans[next].attrs : nullptr;
+        formatter.line(out, lines[i], attrs);
+    }
+    formatter.end(out);
+}
+
+// Tulis dokumen ke `target`; false kalau file tidak bisa dibuat atau ditulis
+inline bool exportLines(const std::string& target, ExportFormat format, const std::vector<std::string_view>& lines,
+                        const std::vector<FormattedLine>& spans, std::string_view title = "") {
+    int fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok;
+    {
+        ChunkWriter out(fd);
+        switch (format) {
+        case EXPORT_HTML: exportWith(out, HtmlFormatter(), lines, spans, title); break;
+        case EXPORT_MARKDOWN: exportWith(out, MarkdownFormatter(), lines, spans, title); break;
+        case EXPORT_ANSI: exportWith(out, AnsiFormatter(), lines, spans, title); break;
+        }
+        ok = out.flush();
+    }
+    ok = fsync(fd) == 0 && ok;
+    return ::close(fd) == 0 && ok;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef FILEWATCH_H
+#define FILEWATCH_H
+
+// Pantau perubahan file dari luar editor lewat inotify.
+//
+// Satu fd inotify untuk semua file, didaftarkan ke EventLoop; readEvents()
+// dipanggil saat fd readable. Selain file-nya sendiri, direktorinya juga
+// dipantau (difilter per nama) supaya file yang diganti lewat rename atau
+// dibuat ulang (logrotate) tetap ketahuan: watch file lalu dipasang ulang ke
+// inode yang baru.
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+class FileWatch {
+public:
+    FileWatch() {
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+
+    FileWatch(const FileWatch&) = delete;
+    FileWatch& operator=(const FileWatch&) = delete;
+
+    ~FileWatch() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    int handle() const {
+        return fd;
+    }
+
+    bool add(const std::string& path) {
+        if (fd < 0) return false;
+        for (const Watch& w : watches)
+            if (w.path == path) return true;
+        Watch w;
+        w.path = path;
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : path.substr(0, slash ? slash : 1);
+        w.name = slash == std::string::npos ? path : path.substr(slash + 1);
+        w.dirWd = inotify_add_watch(fd, dir.c_str(), DIR_EVENTS);
+        w.fileWd = inotify_add_watch(fd, path.c_str(), FILE_EVENTS); // boleh gagal: file belum ada
+        if (w.dirWd < 0 && w.fileWd < 0) return false;
+        watches.push_back(w);
+        return true;
+    }
+
+    // Baca semua event yang tertunda; onChange(path) dipanggil sekali per
+    // file yang berubah, walaupun event-nya banyak (mis. append beruntun)
+    template<typename F>
+    void readEvents(F onChange) {
+        alignas(inotify_event) char buf[4096];
+        std::vector<size_t> changed;
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + n;) {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                for (size_t i = 0; i < watches.size(); ++i) {
+                    const Watch& w = watches[i];
+                    bool hit = ev->wd == w.fileWd || (ev->wd == w.dirWd && ev->len && w.name == ev->name);
+                    if (hit && std::find(changed.begin(), changed.end(), i) == changed.end())
+                        changed.push_back(i);
+                }
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+        for (size_t i : changed) {
+            // Path yang sama bisa sudah menunjuk inode lain; kalau inode-nya
+            // sama, inotify mengembalikan wd yang lama
+            Watch& w = watches[i];
+            w.fileWd = inotify_add_watch(fd, w.path.c_str(), FILE_EVENTS);
+            onChange(w.path);
+        }
+    }
+
+private:
+    static const uint32_t FILE_EVENTS = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB;
+    static const uint32_t DIR_EVENTS = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+    struct Watch {
+        std::string path;
+        std::string name; // nama file di dalam direktori, untuk event direktori
+        int fileWd = -1;
+        int dirWd = -1;
+    };
+
+    int fd = -1;
+    std::vector<Watch> watches;
+};
+
+#endif
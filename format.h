@@ -0,0 +1,400 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+// Atribut format per karakter (bold, italic, underline).
+//
+// Disimpan sebagai run per baris: LineAttrs = deretan {panjang, atribut}
+// dari awal baris. Byte setelah run terakhir berarti polos, dan baris tanpa
+// format sama sekali tidak punya entri, jadi dokumen polos tidak membayar
+// apa-apa. Entri baris berformat disimpan terurut nomor baris.
+//
+// FormatSpans mengikuti perubahan LineStore lewat onBeforeChange/onChange
+// dengan cara yang sama seperti EditTracker (collab.h): rentang baris yang
+// berubah dikumpulkan, lalu di flush() isi lama dan barunya dibandingkan
+// (awalan/akhiran yang sama). Byte di awalan dan akhiran tetap membawa
+// atributnya, byte baru mendapat atribut ketik `typing`. Kalau letak sisipan
+// atau hapusan ambigu (mengetik "a" setelah "a"), dipilih letak yang
+// berakhir di kursor.
+//
+// Setiap baris yang atributnya dipasang ulang (flush, put, decode) juga
+// menulis AttrStats-nya ke LineStore, jadi jumlah karakter bold/italic/
+// underline seluruh dokumen atau rentang baris dibaca dari B+tree.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "linestore.h"
+#include "journal.h"
+
+enum TextAttr : uint8_t {
+    ATTR_BOLD = 1,
+    ATTR_ITALIC = 2,
+    ATTR_UNDERLINE = 4
+};
+
+struct AttrRun {
+    uint32_t length;
+    uint8_t attr;
+};
+
+using LineAttrs = std::vector<AttrRun>;
+
+struct FormattedLine {
+    uint32_t line;
+    LineAttrs attrs;
+};
+
+// Tambah run di akhir; disambung ke run terakhir kalau atributnya sama
+inline void attrsAppend(LineAttrs& out, uint64_t length, uint8_t attr) {
+    while (length > 0) {
+        if (!out.empty() && out.back().attr == attr && out.back().length < UINT32_MAX) {
+            uint32_t room = std::min<uint64_t>(UINT32_MAX - out.back().length, length);
+            out.back().length += room;
+            length -= room;
+        } else {
+            uint32_t part = (uint32_t)std::min<uint64_t>(UINT32_MAX, length);
+            out.push_back({part, attr});
+            length -= part;
+        }
+    }
+}
+
+// Atribut byte [from, to) dari `in` ditambahkan ke `out`
+inline void attrsSlice(const LineAttrs& in, uint64_t from, uint64_t to, LineAttrs& out) {
+    uint64_t pos = 0;
+    for (const AttrRun& run : in) {
+        if (pos >= to) break;
+        uint64_t end = pos + run.length;
+        if (end > from)
+            attrsAppend(out, std::min(end, to) - std::max(pos, from), run.attr);
+        pos = end;
+    }
+    if (pos < to)
+        attrsAppend(out, to - std::max(pos, from), 0);
+}
+
+inline bool attrsPlain(const LineAttrs& attrs) {
+    for (const AttrRun& run : attrs)
+        if (run.attr) return false;
+    return true;
+}
+
+// Panggil fn(potongan, atribut) untuk setiap run di `text`. Run yang lebih
+// panjang dari teks dipotong, sisa teks tanpa run dianggap polos.
+template<typename Fn>
+void forEachAttrRun(std::string_view text, const LineAttrs* attrs, Fn fn) {
+    size_t pos = 0;
+    if (attrs) {
+        for (const AttrRun& run : *attrs) {
+            if (pos >= text.size()) return;
+            size_t len = std::min<size_t>(run.length, text.size() - pos);
+            fn(text.substr(pos, len), run.attr);
+            pos += len;
+        }
+    }
+    if (pos < text.size())
+        fn(text.substr(pos), (uint8_t)0);
+}
+
+// Karakter per atribut di `text` dengan run `attrs` (nullptr = polos)
+inline AttrStats attrStatsOf(std::string_view text, const LineAttrs* attrs) {
+    AttrStats s;
+    forEachAttrRun(text, attrs, [&](std::string_view piece, uint8_t attr) {
+        if (!attr) return;
+        uint64_t chars = LineStats::of(piece).chars;
+        for (int b = 0; b < AttrStats::KINDS; ++b)
+            if (attr & (1 << b)) s.chars[b] += chars;
+    });
+    return s;
+}
+
+class FormatSpans {
+public:
+    uint8_t typing = 0; // atribut byte baru; dipasang Document selama satu operasi
+    bool muted = false; // perubahan store diurus pemanggil (lihat swapLines)
+
+    explicit FormatSpans(LineStore& store) : store(store) {}
+
+    FormatSpans(const FormatSpans&) = delete;
+    FormatSpans& operator=(const FormatSpans&) = delete;
+
+    // false = tidak ada yang perlu dicatat (dokumen polos, mengetik polos)
+    bool tracking() const {
+        return open || typing || !spans.empty();
+    }
+
+    bool empty() const {
+        return spans.empty();
+    }
+
+    // Run baris ke-i, nullptr untuk baris polos
+    const LineAttrs* at(size_t line) const {
+        auto it = std::lower_bound(spans.begin(), spans.end(), line,
+                                   [](const FormattedLine& f, size_t l) { return f.line < l; });
+        return it != spans.end() && it->line == line ? &it->attrs : nullptr;
+    }
+
+    // Semua baris berformat, terurut; untuk ekspor dan penyimpanan
+    const std::vector<FormattedLine>& lines() const {
+        return spans;
+    }
+
+    void clear() {
+        if (!spans.empty()) store.clearAttrStats();
+        open = false;
+        oldLines.clear();
+        oldAttrs.clear();
+        spans.clear();
+    }
+
+    // Dipanggil dari LineStore::onBeforeChange
+    void beforeChange(size_t line, size_t removed) {
+        if (muted || !tracking()) return;
+        if (open && (line > newEnd || line + removed < lo))
+            flush();
+        if (!open) {
+            open = true;
+            lo = oldEnd = newEnd = line;
+            oldLines.clear();
+            oldAttrs.clear();
+        }
+        if (line < lo) { // baris di depan rentang belum bergeser
+            for (size_t i = line; i < lo; ++i) {
+                oldLines.emplace(oldLines.begin() + (i - line), store[i]);
+                oldAttrs.emplace(oldAttrs.begin() + (i - line), attrsOf(i));
+            }
+            lo = line;
+        }
+        // Entri di belakang rentang masih bernomor lama
+        for (; newEnd < line + removed; ++newEnd, ++oldEnd) {
+            oldLines.emplace_back(store[newEnd]);
+            oldAttrs.push_back(attrsOf(oldEnd));
+        }
+    }
+
+    // Dipanggil dari LineStore::onChange
+    void afterChange(size_t removed, size_t inserted) {
+        if (open && !muted)
+            newEnd = newEnd + inserted - removed;
+    }
+
+    // Tutup rentang yang terbuka. Kursor (hintLine, hintOffset) dipakai
+    // untuk memilih letak perubahan yang ambigu.
+    void flush(size_t hintLine = SIZE_MAX, size_t hintOffset = 0) {
+        if (!open) return;
+        open = false;
+        std::string oldText, newText;
+        LineAttrs oldRuns;
+        for (size_t i = 0; i < oldLines.size(); ++i) {
+            oldText += oldLines[i];
+            oldText += '\n';
+            attrsSlice(oldAttrs[i], 0, oldLines[i].size(), oldRuns);
+            attrsAppend(oldRuns, 1, 0);
+        }
+        uint64_t hint = UINT64_MAX;
+        std::vector<size_t> newLengths;
+        for (size_t i = lo; i < newEnd; ++i) {
+            std::string_view line = store[i];
+            if (i == hintLine) hint = newText.size() + std::min(hintOffset, line.size());
+            newText += line;
+            newText += '\n';
+            newLengths.push_back(line.size());
+        }
+
+        size_t start, removed, inserted;
+        diff(oldText, newText, hint, start, removed, inserted);
+        LineAttrs runs;
+        attrsSlice(oldRuns, 0, start, runs);
+        attrsAppend(runs, inserted, typing);
+        attrsSlice(oldRuns, start + removed, oldText.size(), runs);
+
+        // Pecah lagi per baris; '\n' tidak punya atribut
+        std::vector<LineAttrs> newAttrs(newLengths.size());
+        uint64_t pos = 0;
+        for (size_t i = 0; i < newLengths.size(); ++i) {
+            attrsSlice(runs, pos, pos + newLengths[i], newAttrs[i]);
+            pos += newLengths[i] + 1;
+        }
+        if (removed && inserted)
+            reuseMovedLines(newText, newLengths, start, inserted, newAttrs);
+        for (size_t i = 0; i < newAttrs.size(); ++i)
+            store.setAttrStats(lo + i, attrStatsOf(store[lo + i], &newAttrs[i]));
+
+        auto first = std::lower_bound(spans.begin(), spans.end(), lo,
+                                      [](const FormattedLine& f, size_t l) { return f.line < l; });
+        auto last = std::lower_bound(first, spans.end(), oldEnd,
+                                     [](const FormattedLine& f, size_t l) { return f.line < l; });
+        for (auto it = last; it != spans.end(); ++it)
+            it->line = (uint32_t)(it->line + newEnd - oldEnd);
+        std::vector<FormattedLine> fresh;
+        for (size_t i = 0; i < newAttrs.size(); ++i)
+            if (!attrsPlain(newAttrs[i]))
+                fresh.push_back({(uint32_t)(lo + i), std::move(newAttrs[i])});
+        size_t at = first - spans.begin();
+        spans.erase(first, last);
+        spans.insert(spans.begin() + at, std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+        oldLines.clear();
+        oldAttrs.clear();
+    }
+
+    // Baris `line` dan `line + 1` bertukar tempat. Dua baris yang isinya
+    // sama tidak bisa dibedakan lewat diff, jadi entrinya ditukar langsung.
+    void swapLines(size_t line) {
+        flush();
+        LineAttrs upper = attrsOf(line), lower = attrsOf(line + 1);
+        put(line, std::move(lower));
+        put(line + 1, std::move(upper));
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = spans.capacity() * sizeof(FormattedLine);
+        for (const FormattedLine& f : spans)
+            bytes += f.attrs.capacity() * sizeof(AttrRun);
+        return bytes;
+    }
+
+    // Format: count(u32), lalu per baris: line(u32) runs(u32) lalu per run
+    // length(u32) attr(u8)
+    void encode(std::string& out) const {
+        journalPutU32(out, (uint32_t)spans.size());
+        for (const FormattedLine& f : spans) {
+            journalPutU32(out, f.line);
+            journalPutU32(out, (uint32_t)f.attrs.size());
+            for (const AttrRun& run : f.attrs) {
+                journalPutU32(out, run.length);
+                out += (char)run.attr;
+            }
+        }
+    }
+
+    // false jika data terpotong
+    bool decode(const char* p, size_t n, size_t* used = nullptr) {
+        const char* start = p;
+        const char* end = p + n;
+        clear();
+        if (end - p < 4) return false;
+        uint32_t count = journalGetU32(p);
+        p += 4;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (end - p < 8) return false;
+            FormattedLine f;
+            f.line = journalGetU32(p);
+            uint32_t runs = journalGetU32(p + 4);
+            p += 8;
+            if ((size_t)(end - p) / 5 < runs) return false;
+            for (uint32_t k = 0; k < runs; ++k, p += 5)
+                f.attrs.push_back({journalGetU32(p), (uint8_t)p[4]});
+            if (f.line < store.size())
+                store.setAttrStats(f.line, attrStatsOf(store[f.line], &f.attrs));
+            spans.push_back(std::move(f));
+        }
+        if (used) *used = p - start;
+        return true;
+    }
+
+private:
+    LineStore& store; // AttrStats baris berformat dipasang di sini
+    std::vector<FormattedLine> spans; // terurut line
+    bool open = false;
+    size_t lo = 0;
+    size_t oldEnd = 0;
+    size_t newEnd = 0;
+    std::vector<std::string> oldLines;
+    std::vector<LineAttrs> oldAttrs;
+
+    static const size_t REUSE_MAX_LINES = 64;
+
+    LineAttrs attrsOf(size_t line) const {
+        const LineAttrs* attrs = at(line);
+        return attrs ? *attrs : LineAttrs();
+    }
+
+    void put(size_t line, LineAttrs attrs) {
+        store.setAttrStats(line, attrStatsOf(store[line], &attrs));
+        auto it = std::lower_bound(spans.begin(), spans.end(), line,
+                                   [](const FormattedLine& f, size_t l) { return f.line < l; });
+        bool exists = it != spans.end() && it->line == line;
+        if (attrsPlain(attrs)) {
+            if (exists) spans.erase(it);
+        } else if (exists) {
+            it->attrs = std::move(attrs);
+        } else {
+            spans.insert(it, {(uint32_t)line, std::move(attrs)});
+        }
+    }
+
+    static bool boundary(const std::string& s, size_t pos) {
+        return pos >= s.size() || ((unsigned char)s[pos] & 0xC0) != 0x80;
+    }
+
+    // Teks lama/baru diakhiri '\n'. Hasil: byte [start, start + removed)
+    // teks lama diganti byte [start, start + inserted) teks baru, dengan
+    // batas di awal karakter UTF-8 supaya tag ekspor tidak memecah karakter.
+    static void diff(const std::string& oldText, const std::string& newText, uint64_t hint,
+                     size_t& start, size_t& removed, size_t& inserted) {
+        size_t shorter = std::min(oldText.size(), newText.size());
+        size_t prefix = 0;
+        while (prefix < shorter && oldText[prefix] == newText[prefix])
+            prefix++;
+        size_t suffix = 0;
+        while (suffix < shorter && oldText[oldText.size() - 1 - suffix] == newText[newText.size() - 1 - suffix])
+            suffix++;
+        if (prefix + suffix >= shorter) {
+            // Hanya sisip atau hanya hapus: letak awalnya bisa di mana saja
+            // di [shorter - suffix, prefix]
+            const std::string& longer = oldText.size() > newText.size() ? oldText : newText;
+            size_t d = longer.size() - shorter;
+            size_t lowest = shorter - suffix;
+            size_t want = prefix;
+            if (hint != UINT64_MAX)
+                want = newText.size() > oldText.size() ? (hint >= d ? hint - d : 0) : hint;
+            want = std::min(std::max<size_t>(want, lowest), prefix);
+            start = want;
+            for (size_t k = 0; k <= prefix - lowest; ++k) { // posisi terdekat yang di batas karakter
+                if (want >= lowest + k && boundary(longer, want - k) && boundary(longer, want - k + d)) {
+                    start = want - k;
+                    break;
+                }
+                if (want + k <= prefix && boundary(longer, want + k) && boundary(longer, want + k + d)) {
+                    start = want + k;
+                    break;
+                }
+            }
+            removed = oldText.size() > newText.size() ? d : 0;
+            inserted = newText.size() > oldText.size() ? d : 0;
+            return;
+        }
+        suffix = std::min(suffix, shorter - prefix);
+        while (prefix > 0 && (!boundary(oldText, prefix) || !boundary(newText, prefix)))
+            prefix--;
+        while (suffix > 0 && (!boundary(oldText, oldText.size() - suffix) || !boundary(newText, newText.size() - suffix)))
+            suffix--;
+        start = prefix;
+        removed = oldText.size() - prefix - suffix;
+        inserted = newText.size() - prefix - suffix;
+    }
+
+    // Baris yang dipindah (tukar baris, undo) muncul sebagai teks baru:
+    // baris baru yang isinya sama persis dengan baris lama di rentang ini
+    // memakai lagi atribut baris lama itu
+    void reuseMovedLines(const std::string& newText, const std::vector<size_t>& newLengths,
+                         size_t start, size_t inserted, std::vector<LineAttrs>& newAttrs) {
+        if (oldLines.size() > REUSE_MAX_LINES) return;
+        std::vector<bool> used(oldLines.size());
+        size_t pos = 0;
+        for (size_t i = 0; i < newLengths.size(); pos += newLengths[i] + 1, ++i) {
+            if (pos + newLengths[i] < start || pos >= start + inserted) continue;
+            std::string_view text(newText.data() + pos, newLengths[i]);
+            for (size_t j = 0; j < oldLines.size(); ++j) {
+                if (used[j] || oldLines[j] != text) continue;
+                used[j] = true;
+                newAttrs[i] = oldAttrs[j];
+                break;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,492 @@
+#ifndef HIGHLIGHT_H
+#define HIGHLIGHT_H
+
+// Highlight sintaks per baris.
+//
+// Highlighter adalah mesin state per baris: tokenize(baris, state awal)
+// mengembalikan state di akhir baris (mis. masih di dalam komentar blok,
+// atau level log entri yang belum selesai). SyntaxCache menyimpan state
+// akhir setiap baris; setelah edit hanya baris yang kotor yang di-tokenize
+// ulang, dan propagasi berhenti begitu state akhir sama lagi dengan cache.
+// Token untuk warna hanya dihitung untuk baris yang sedang dirender.
+//
+// State akhir disimpan di gap buffer (StateGapBuffer) dengan celah di baris
+// edit terakhir, jadi Enter / gabung baris tidak menggeser state seluruh
+// file: biayanya sebanding jarak dari edit sebelumnya, dan edit berurutan di
+// sekitar kursor O(baris yang berubah).
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+enum TokenKind : uint8_t {
+    TOK_TIMESTAMP,
+    TOK_NUMBER,
+    TOK_ERROR,
+    TOK_WARN,
+    TOK_INFO,
+    TOK_DEBUG,
+    TOK_KEYWORD,
+    TOK_TYPE,
+    TOK_STRING,
+    TOK_COMMENT,
+    TOK_PREPROCESSOR
+};
+
+struct Token {
+    uint32_t start;
+    uint32_t length;
+    TokenKind kind;
+};
+
+// Kode SGR warna ANSI (hanya foreground, jadi bold/italic/underline global
+// tetap berlaku); 39 = warna default
+inline uint8_t tokenColor(TokenKind kind) {
+    switch (kind) {
+    case TOK_TIMESTAMP: return 36;
+    case TOK_NUMBER: return 35;
+    case TOK_ERROR: return 31;
+    case TOK_WARN: return 33;
+    case TOK_INFO: return 32;
+    case TOK_DEBUG: return 34;
+    case TOK_KEYWORD: return 34;
+    case TOK_TYPE: return 36;
+    case TOK_STRING: return 32;
+    case TOK_COMMENT: return 90;
+    case TOK_PREPROCESSOR: return 35;
+    }
+    return 39;
+}
+
+// Highlighter yang bisa dipasang per dokumen. `tokens` boleh nullptr jika
+// yang dibutuhkan hanya state akhir baris.
+struct Highlighter {
+    const char* name;
+    uint8_t (*tokenize)(std::string_view line, uint8_t state, std::vector<Token>* tokens);
+};
+
+inline bool hlIsDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool hlIsAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+inline bool hlIsAlnum(char c) { return hlIsAlpha(c) || hlIsDigit(c); }
+
+inline void hlEmit(std::vector<Token>* tokens, size_t start, size_t end, TokenKind kind) {
+    if (tokens && end > start)
+        tokens->push_back({(uint32_t)start, (uint32_t)(end - start), kind});
+}
+
+inline bool hlWordIn(std::string_view word, const char* const* list, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        if (word == list[i]) return true;
+    return false;
+}
+
+// Angka: desimal, pecahan, heksadesimal, dengan sufiks huruf (10ms, 42u)
+inline size_t hlScanNumber(std::string_view s, size_t i) {
+    if (s[i] == '0' && i + 1 < s.size() && (s[i + 1] == 'x' || s[i + 1] == 'X')) {
+        i += 2;
+        while (i < s.size() && (hlIsDigit(s[i]) || ((s[i] | 0x20) >= 'a' && (s[i] | 0x20) <= 'f')))
+            i++;
+    } else {
+        while (i < s.size() && (hlIsDigit(s[i]) || s[i] == '.'))
+            i++;
+    }
+    while (i < s.size() && hlIsAlpha(s[i]))
+        i++;
+    return i;
+}
+
+// ---------------------------------------------------------------------------
+// Log: timestamp, level, angka. State = level entri terakhir, sehingga baris
+// lanjutan (stack trace, baris yang diawali spasi/tab) ikut warna levelnya.
+
+enum LogState : uint8_t {
+    LOG_NONE = 0,
+    LOG_ERROR,
+    LOG_WARN,
+    LOG_INFO,
+    LOG_DEBUG
+};
+
+inline LogState logLevel(std::string_view word) {
+    static const char* const ERRORS[] = {"ERROR", "ERR", "FATAL", "CRITICAL", "CRIT", "PANIC",
+                                         "SEVERE", "Error", "error", "Exception"};
+    static const char* const WARNS[] = {"WARN", "WARNING", "Warning", "warning"};
+    static const char* const INFOS[] = {"INFO", "NOTICE", "Info", "info"};
+    static const char* const DEBUGS[] = {"DEBUG", "TRACE", "Debug", "debug"};
+    if (hlWordIn(word, ERRORS, sizeof(ERRORS) / sizeof(*ERRORS))) return LOG_ERROR;
+    if (hlWordIn(word, WARNS, sizeof(WARNS) / sizeof(*WARNS))) return LOG_WARN;
+    if (hlWordIn(word, INFOS, sizeof(INFOS) / sizeof(*INFOS))) return LOG_INFO;
+    if (hlWordIn(word, DEBUGS, sizeof(DEBUGS) / sizeof(*DEBUGS))) return LOG_DEBUG;
+    return LOG_NONE;
+}
+
+inline TokenKind logTokenKind(uint8_t level) {
+    switch (level) {
+    case LOG_ERROR: return TOK_ERROR;
+    case LOG_WARN: return TOK_WARN;
+    case LOG_INFO: return TOK_INFO;
+    default: return TOK_DEBUG;
+    }
+}
+
+// Deretan angka dengan pemisah tanggal/jam ("2024-05-01", "12:00:01.250",
+// "01/05/2024"), opsional diikuti jam setelah spasi atau 'T'
+inline size_t logScanTimestamp(std::string_view s, size_t i) {
+    size_t start = i, colons = 0, dashes = 0;
+    while (i < s.size() && (hlIsDigit(s[i]) || s[i] == '-' || s[i] == '/' || s[i] == ':' ||
+                            s[i] == '.' || s[i] == ',')) {
+        colons += s[i] == ':';
+        dashes += s[i] == '-' || s[i] == '/';
+        i++;
+    }
+    if (colons == 0 && dashes < 2) return start;
+    if (dashes >= 2 && colons == 0 && i + 1 < s.size() && (s[i] == ' ' || s[i] == 'T' || s[i] == '[') &&
+        hlIsDigit(s[i + 1])) {
+        size_t time = logScanTimestamp(s, i + 1);
+        if (time > i + 1) return time;
+    }
+    return i;
+}
+
+inline uint8_t tokenizeLog(std::string_view s, uint8_t state, std::vector<Token>* tokens) {
+    if (s.empty()) return state;
+    // Baris lanjutan entri sebelumnya
+    if (s[0] == ' ' || s[0] == '\t') {
+        if (state != LOG_NONE) hlEmit(tokens, 0, s.size(), logTokenKind(state));
+        return state;
+    }
+    uint8_t level = LOG_NONE;
+    size_t i = 0;
+    while (i < s.size()) {
+        char c = s[i];
+        if (hlIsDigit(c) && (i == 0 || !hlIsAlnum(s[i - 1]))) {
+            size_t end = logScanTimestamp(s, i);
+            if (end > i) {
+                hlEmit(tokens, i, end, TOK_TIMESTAMP);
+            } else {
+                end = hlScanNumber(s, i);
+                hlEmit(tokens, i, end, TOK_NUMBER);
+            }
+            i = end;
+        } else if (hlIsAlpha(c)) {
+            size_t end = i;
+            while (end < s.size() && hlIsAlnum(s[end]))
+                end++;
+            LogState word = level == LOG_NONE ? logLevel(s.substr(i, end - i)) : LOG_NONE;
+            if (word != LOG_NONE) {
+                level = word;
+                hlEmit(tokens, i, end, logTokenKind(word));
+            }
+            i = end;
+        } else {
+            i++;
+        }
+    }
+    return level;
+}
+
+// ---------------------------------------------------------------------------
+// C-like: keyword, tipe, string/char, angka, preprocessor, komentar // dan
+// /* */. State 1 = masih di dalam komentar blok.
+
+enum CState : uint8_t {
+    C_NORMAL = 0,
+    C_BLOCK_COMMENT
+};
+
+inline uint8_t tokenizeC(std::string_view s, uint8_t state, std::vector<Token>* tokens) {
+    static const char* const KEYWORDS[] = {
+        "if", "else", "for", "while", "do", "switch", "case", "default", "break", "continue",
+        "return", "goto", "struct", "class", "union", "enum", "typedef", "template", "typename",
+        "namespace", "using", "public", "private", "protected", "virtual", "override", "static",
+        "const", "constexpr", "inline", "extern", "volatile", "new", "delete", "sizeof", "this",
+        "true", "false", "nullptr", "NULL", "try", "catch", "throw", "operator", "explicit",
+        "friend", "mutable", "auto", "register", "static_assert"};
+    static const char* const TYPES[] = {
+        "void", "bool", "char", "short", "int", "long", "float", "double", "signed", "unsigned",
+        "size_t", "ssize_t", "off_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t", "int8_t",
+        "int16_t", "int32_t", "int64_t", "string", "string_view", "vector"};
+    size_t i = 0;
+    if (state == C_BLOCK_COMMENT) {
+        size_t end = s.find("*/");
+        if (end == std::string_view::npos) {
+            hlEmit(tokens, 0, s.size(), TOK_COMMENT);
+            return C_BLOCK_COMMENT;
+        }
+        hlEmit(tokens, 0, end + 2, TOK_COMMENT);
+        i = end + 2;
+    }
+    size_t first = s.find_first_not_of(" \t");
+    if (first != std::string_view::npos && first >= i && s[first] == '#') {
+        // Direktif sampai komentar pertama (jika ada)
+        size_t end = std::min(s.find("//", first), s.find("/*", first));
+        if (end == std::string_view::npos) end = s.size();
+        hlEmit(tokens, first, end, TOK_PREPROCESSOR);
+        i = end;
+    }
+    while (i < s.size()) {
+        char c = s[i];
+        if (c == '/' && i + 1 < s.size() && s[i + 1] == '/') {
+            hlEmit(tokens, i, s.size(), TOK_COMMENT);
+            return C_NORMAL;
+        }
+        if (c == '/' && i + 1 < s.size() && s[i + 1] == '*') {
+            size_t end = s.find("*/", i + 2);
+            if (end == std::string_view::npos) {
+                hlEmit(tokens, i, s.size(), TOK_COMMENT);
+                return C_BLOCK_COMMENT;
+            }
+            hlEmit(tokens, i, end + 2, TOK_COMMENT);
+            i = end + 2;
+        } else if (c == '"' || c == '\'') {
+            size_t end = i + 1;
+            while (end < s.size() && s[end] != c)
+                end += s[end] == '\\' ? 2 : 1;
+            end = std::min(end + 1, s.size());
+            hlEmit(tokens, i, end, TOK_STRING);
+            i = end;
+        } else if (hlIsDigit(c) && (i == 0 || !hlIsAlnum(s[i - 1]))) {
+            size_t end = hlScanNumber(s, i);
+            hlEmit(tokens, i, end, TOK_NUMBER);
+            i = end;
+        } else if (hlIsAlpha(c)) {
+            size_t end = i;
+            while (end < s.size() && hlIsAlnum(s[end]))
+                end++;
+            std::string_view word = s.substr(i, end - i);
+            if (hlWordIn(word, KEYWORDS, sizeof(KEYWORDS) / sizeof(*KEYWORDS)))
+                hlEmit(tokens, i, end, TOK_KEYWORD);
+            else if (hlWordIn(word, TYPES, sizeof(TYPES) / sizeof(*TYPES)))
+                hlEmit(tokens, i, end, TOK_TYPE);
+            i = end;
+        } else {
+            i++;
+        }
+    }
+    return C_NORMAL;
+}
+
+const Highlighter LOG_HIGHLIGHTER = {"log", tokenizeLog};
+const Highlighter C_HIGHLIGHTER = {"c", tokenizeC};
+
+// Pilih highlighter dari ekstensi file; selain kode sumber dianggap log
+inline const Highlighter* highlighterFor(const std::string& path) {
+    static const char* const SOURCE[] = {".c", ".h", ".cc", ".cpp", ".cxx", ".hpp", ".hh",
+                                         ".java", ".js", ".ts", ".go", ".rs", ".cs"};
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash) &&
+        hlWordIn(std::string_view(path).substr(dot), SOURCE, sizeof(SOURCE) / sizeof(*SOURCE)))
+        return &C_HIGHLIGHTER;
+    return &LOG_HIGHLIGHTER;
+}
+
+// ---------------------------------------------------------------------------
+
+// Deret byte state per baris dengan celah di posisi edit terakhir. Isi
+// [0, gapStart) dan [gapEnd, data.size()) adalah baris berurutan; sisip dan
+// hapus hanya memindahkan celah (memmove sejauh jarak ke edit sebelumnya).
+class StateGapBuffer {
+public:
+    size_t size() const {
+        return data.size() - (gapEnd - gapStart);
+    }
+
+    uint8_t operator[](size_t i) const {
+        return data[i < gapStart ? i : i + (gapEnd - gapStart)];
+    }
+
+    uint8_t& operator[](size_t i) {
+        return data[i < gapStart ? i : i + (gapEnd - gapStart)];
+    }
+
+    void push_back(uint8_t value) {
+        replace(size(), 0, 1, value);
+    }
+
+    // Ganti [pos, pos + removed) dengan `inserted` kali `value`
+    void replace(size_t pos, size_t removed, size_t inserted, uint8_t value) {
+        moveGap(pos);
+        gapEnd += removed; // baris yang dihapus masuk celah
+        reserveGap(inserted);
+        if (inserted) memset(&data[gapStart], value, inserted);
+        gapStart += inserted;
+    }
+
+    void assign(std::vector<uint8_t>&& states) {
+        data = std::move(states);
+        gapStart = gapEnd = data.size();
+    }
+
+    void clear() {
+        std::vector<uint8_t>().swap(data);
+        gapStart = gapEnd = 0;
+    }
+
+    size_t capacity() const {
+        return data.capacity();
+    }
+
+private:
+    static constexpr size_t GAP_MIN = 4096;
+
+    std::vector<uint8_t> data;
+    size_t gapStart = 0;
+    size_t gapEnd = 0;
+
+    void moveGap(size_t pos) {
+        if (pos < gapStart) {
+            size_t n = gapStart - pos;
+            memmove(&data[gapEnd - n], &data[pos], n);
+            gapStart -= n;
+            gapEnd -= n;
+        } else if (pos > gapStart) {
+            size_t n = pos - gapStart;
+            memmove(&data[gapStart], &data[gapEnd], n);
+            gapStart += n;
+            gapEnd += n;
+        }
+    }
+
+    // Celah diperbesar sebanding isi, jadi push_back berulang O(1) amortized
+    void reserveGap(size_t n) {
+        if (gapEnd - gapStart >= n) return;
+        size_t gap = n + std::max(GAP_MIN, size() / 4);
+        size_t tail = data.size() - gapEnd;
+        std::vector<uint8_t> next(gapStart + gap + tail);
+        if (gapStart) memcpy(&next[0], &data[0], gapStart);
+        if (tail) memcpy(&next[gapStart + gap], &data[gapEnd], tail);
+        data.swap(next);
+        gapEnd = gapStart + gap;
+    }
+};
+
+class SyntaxCache {
+public:
+    const Highlighter* highlighter;
+
+    explicit SyntaxCache(const Highlighter* h) : highlighter(h) {}
+
+    // Dipanggil untuk setiap perubahan baris: [line, line + removed) diganti
+    // `inserted` baris baru. State baris sesudahnya ikut bergeser.
+    void linesChanged(size_t line, size_t removed, size_t inserted) {
+        changedFrom = std::min(changedFrom, line);
+        if (line >= endState.size()) return; // belum pernah di-tokenize
+        size_t end = std::min(line + removed, endState.size());
+        if (end - line == inserted) {
+            for (size_t i = line; i < end; ++i)
+                endState[i] = STATE_UNKNOWN;
+        } else {
+            endState.replace(line, end - line, inserted, STATE_UNKNOWN);
+        }
+        for (uint32_t& d : dirty) {
+            if (d >= line + removed) d = (uint32_t)(d + inserted - removed);
+            else if (d >= line) d = (uint32_t)line;
+        }
+        if (line < endState.size())
+            dirty.push_back((uint32_t)line);
+    }
+
+    // Baris diedit langsung di luar store (currentLine di Document)
+    void touch(size_t line) {
+        if (line < endState.size())
+            dirty.push_back((uint32_t)line);
+    }
+
+    // Pastikan state akhir baris [0, upTo) valid. Baris kotor di-tokenize
+    // ulang sampai state akhirnya sama dengan cache; baris kotor di luar
+    // upTo ditunda. Mengembalikan jumlah baris yang di-tokenize.
+    template<typename GetLine>
+    size_t update(size_t upTo, GetLine lineAt) {
+        size_t work = 0;
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+        std::vector<uint32_t> later;
+        size_t done = 0;
+        for (uint32_t d : dirty) {
+            if (d >= endState.size() || d < done) continue;
+            if (d >= upTo) {
+                later.push_back(d);
+                continue;
+            }
+            size_t i = d;
+            uint8_t state = startState(i);
+            while (i < endState.size()) {
+                if (i >= upTo) {
+                    later.push_back((uint32_t)i);
+                    break;
+                }
+                uint8_t next = highlighter->tokenize(lineAt(i), state, nullptr);
+                work++;
+                bool same = endState[i] == next;
+                endState[i++] = next;
+                state = next;
+                if (same) break;
+            }
+            done = i;
+        }
+        dirty.swap(later);
+        while (endState.size() < upTo) {
+            uint8_t state = startState(endState.size());
+            endState.push_back(highlighter->tokenize(lineAt(endState.size()), state, nullptr));
+            work++;
+        }
+        return work;
+    }
+
+    // State di awal baris `line` (= state akhir baris sebelumnya)
+    uint8_t startState(size_t line) const {
+        return line == 0 || line > endState.size() ? 0 : endState[line - 1];
+    }
+
+    // Token untuk merender satu baris
+    void tokens(std::string_view line, uint8_t state, std::vector<Token>& out) const {
+        out.clear();
+        highlighter->tokenize(line, state, &out);
+    }
+
+    // Mulai mencatat baris pertama yang berubah, untuk install()
+    void markSnapshot() {
+        changedFrom = SIZE_MAX;
+    }
+
+    size_t firstChangeSinceSnapshot() const {
+        return changedFrom;
+    }
+
+    // Pasang state yang dihitung di luar (worker) dari isi saat markSnapshot();
+    // hanya `valid` baris pertama yang dipakai (baris sesudahnya sudah berubah)
+    void install(std::vector<uint8_t>&& states, size_t valid) {
+        valid = std::min(valid, states.size());
+        if (valid <= endState.size()) return;
+        states.resize(valid);
+        endState.assign(std::move(states));
+        dirty.erase(std::remove_if(dirty.begin(), dirty.end(),
+                                   [valid](uint32_t d) { return d < valid; }), dirty.end());
+    }
+
+    void clear() {
+        endState.clear();
+        dirty.clear();
+    }
+
+    size_t cachedLines() const {
+        return endState.size();
+    }
+
+    size_t memoryBytes() const {
+        return endState.capacity() + dirty.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr uint8_t STATE_UNKNOWN = 0xff; // baris baru, tidak pernah cocok dengan hasil tokenize
+
+    StateGapBuffer endState;
+    std::vector<uint32_t> dirty; // baris yang perlu di-tokenize ulang
+    size_t changedFrom = SIZE_MAX;
+};
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// Decoder input keyboard berbasis tabel.
+//
+// Semua binding (tombol Ctrl, escape sequence panah/Home/End/PgUp/PgDn,
+// kombinasi Alt, penanda bracketed paste) ada di KEYMAP. Dari tabel itu
+// dibangun trie transisi saat kompilasi (constexpr), jadi setiap byte input
+// cukup satu lookup next[state][byte] tanpa rantai if/else.
+//
+// Isi bracketed paste ("\033[200~" ... "\033[201~") tidak dilewatkan ke
+// trie sama sekali: dikumpulkan utuh lalu dikirim sebagai satu KEY_PASTE.
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+enum KeyAction : uint8_t {
+    KEY_NONE = 0,
+    KEY_INSERT,        // byte biasa (termasuk byte UTF-8)
+    KEY_PASTE,         // teks bracketed paste, lihat InputDecoder::pasted
+    KEY_PASTE_BEGIN,   // internal decoder
+    KEY_EXIT,
+    KEY_SAVE,
+    KEY_UNDO,
+    KEY_REDO,
+    KEY_DELETE_WORD,
+    KEY_BOLD,
+    KEY_ITALIC,
+    KEY_UNDERLINE,
+    KEY_UP,
+    KEY_DOWN,
+    KEY_LEFT,
+    KEY_RIGHT,
+    KEY_WORD_LEFT,
+    KEY_WORD_RIGHT,
+    KEY_HOME,
+    KEY_END,
+    KEY_PAGE_UP,
+    KEY_PAGE_DOWN,
+    KEY_DELETE,
+    KEY_BACKSPACE,
+    KEY_NEWLINE,
+    KEY_OPEN,
+    KEY_NEXT_DOC,
+    KEY_PREV_DOC,
+    KEY_MEMORY,
+    KEY_JOIN_LINE,
+    KEY_DELETE_LINE,
+    KEY_MOVE_LINE_UP,
+    KEY_MOVE_LINE_DOWN,
+    KEY_ADD_CURSOR,
+    KEY_CURSORS_AT_WORD,
+    KEY_DIFF,
+    KEY_FOLLOW,
+    KEY_EXPORT,
+    KEY_ESCAPE          // ESC sendirian, lihat InputDecoder::flush
+};
+
+struct KeyBinding {
+    const char* sequence;
+    KeyAction action;
+};
+
+constexpr KeyBinding KEYMAP[] = {
+    {"\x18", KEY_EXIT},          // Ctrl+X
+    {"\x13", KEY_SAVE},          // Ctrl+S
+    {"\x15", KEY_UNDO},          // Ctrl+U
+    {"\x19", KEY_REDO},          // Ctrl+Y
+    {"\x04", KEY_DELETE_WORD},   // Ctrl+D
+    {"\x02", KEY_BOLD},          // Ctrl+B
+    {"\x0b", KEY_ITALIC},        // Ctrl+K
+    {"\x14", KEY_UNDERLINE},     // Ctrl+T
+    {"\x11", KEY_UP},            // Ctrl+Q
+    {"\x01", KEY_DOWN},          // Ctrl+A
+    {"\x0c", KEY_LEFT},          // Ctrl+L
+    {"\x12", KEY_RIGHT},         // Ctrl+R
+    {"\x0f", KEY_OPEN},          // Ctrl+O
+    {"\x0e", KEY_NEXT_DOC},      // Ctrl+N
+    {"\x10", KEY_PREV_DOC},      // Ctrl+P
+    {"\x07", KEY_MEMORY},        // Ctrl+G
+    {"\n", KEY_NEWLINE},
+    {"\r", KEY_NEWLINE},
+    {"\x7f", KEY_BACKSPACE},
+    {"\x08", KEY_BACKSPACE},
+    {"\t", KEY_INSERT},
+
+    // Panah, mode normal (CSI) dan mode aplikasi (SS3)
+    {"\033[A", KEY_UP},
+    {"\033[B", KEY_DOWN},
+    {"\033[C", KEY_RIGHT},
+    {"\033[D", KEY_LEFT},
+    {"\033OA", KEY_UP},
+    {"\033OB", KEY_DOWN},
+    {"\033OC", KEY_RIGHT},
+    {"\033OD", KEY_LEFT},
+    {"\033[1;5C", KEY_WORD_RIGHT}, // Ctrl+Right
+    {"\033[1;5D", KEY_WORD_LEFT},  // Ctrl+Left
+
+    // Home/End/PgUp/PgDn/Delete dalam variasi xterm, vt220 dan rxvt
+    {"\033[H", KEY_HOME},
+    {"\033[F", KEY_END},
+    {"\033OH", KEY_HOME},
+    {"\033OF", KEY_END},
+    {"\033[1~", KEY_HOME},
+    {"\033[4~", KEY_END},
+    {"\033[7~", KEY_HOME},
+    {"\033[8~", KEY_END},
+    {"\033[5~", KEY_PAGE_UP},
+    {"\033[6~", KEY_PAGE_DOWN},
+    {"\033[3~", KEY_DELETE},
+
+    // Alt (ESC + tombol)
+    {"\033b", KEY_WORD_LEFT},
+    {"\033f", KEY_WORD_RIGHT},
+    {"\033\x7f", KEY_DELETE_WORD},
+    {"\033d", KEY_DELETE_WORD},
+    {"\033j", KEY_JOIN_LINE},
+    {"\033k", KEY_DELETE_LINE},
+    {"\033[1;3A", KEY_MOVE_LINE_UP},   // Alt+Up
+    {"\033[1;3B", KEY_MOVE_LINE_DOWN}, // Alt+Down
+    {"\033c", KEY_ADD_CURSOR},
+    {"\033w", KEY_CURSORS_AT_WORD},
+    {"\033v", KEY_DIFF},
+    {"\033t", KEY_FOLLOW},
+    {"\033e", KEY_EXPORT},
+
+    {"\033[200~", KEY_PASTE_BEGIN},
+};
+
+constexpr size_t keymapStates() {
+    size_t states = 1;
+    for (const KeyBinding& binding : KEYMAP)
+        for (const char* p = binding.sequence; *p; ++p)
+            states++;
+    return states;
+}
+
+const size_t KEY_STATES = keymapStates();
+static_assert(KEY_STATES <= 256, "state trie harus muat di uint8_t");
+
+struct KeyTrie {
+    uint8_t next[KEY_STATES][256];   // 0 = tidak ada transisi
+    KeyAction action[KEY_STATES];    // aksi jika sequence berakhir di state ini
+    bool hasChildren[KEY_STATES];    // masih bisa jadi awalan sequence lain
+};
+
+constexpr KeyTrie buildKeyTrie() {
+    KeyTrie trie{};
+    size_t used = 1;
+    for (const KeyBinding& binding : KEYMAP) {
+        size_t state = 0;
+        for (const char* p = binding.sequence; *p; ++p) {
+            unsigned char b = (unsigned char)*p;
+            if (trie.next[state][b] == 0)
+                trie.next[state][b] = (uint8_t)used++;
+            trie.hasChildren[state] = true;
+            state = trie.next[state][b];
+        }
+        trie.action[state] = binding.action;
+    }
+    return trie;
+}
+
+constexpr KeyTrie KEY_TRIE = buildKeyTrie();
+
+struct KeyEvent {
+    KeyAction action = KEY_NONE;
+    char ch = 0; // byte untuk KEY_INSERT
+};
+
+class InputDecoder {
+public:
+    std::string pasted; // isi paste terakhir untuk KEY_PASTE
+
+    // Masukkan satu byte; true jika menghasilkan event
+    bool feed(char c, KeyEvent& event) {
+        unsigned char b = (unsigned char)c;
+        if (pasting)
+            return feedPaste(c, event);
+        if (skipping) {
+            // Sisa CSI yang tidak dikenal: buang sampai byte penutup
+            if (b >= 0x40 && b <= 0x7e)
+                skipping = false;
+            return false;
+        }
+
+        uint8_t next = KEY_TRIE.next[state][b];
+        if (next != 0) {
+            if (KEY_TRIE.hasChildren[next]) {
+                if (depth < 2) prefix[depth] = c;
+                depth++;
+                state = next;
+                return false; // tunggu byte berikutnya
+            }
+            KeyAction action = KEY_TRIE.action[next];
+            reset();
+            if (action == KEY_PASTE_BEGIN) {
+                pasting = true;
+                pasted.clear();
+                return false;
+            }
+            event.action = action;
+            event.ch = c;
+            return true;
+        }
+
+        if (state == 0) {
+            // Byte tanpa binding: karakter biasa, kontrol lain diabaikan
+            if (b < 0x20) return false;
+            event.action = KEY_INSERT;
+            event.ch = c;
+            return true;
+        }
+
+        // Sequence tidak dikenal
+        bool csi = depth >= 2 && prefix[0] == '\033' && prefix[1] == '[';
+        reset();
+        if (b == 0x1b) { // ESC baru memulai sequence lain
+            return feed(c, event);
+        }
+        if (csi && !(b >= 0x40 && b <= 0x7e))
+            skipping = true;
+        return false; // Alt+tombol yang tidak dipetakan ikut dibuang
+    }
+
+    // Ada awalan sequence yang belum selesai (mis. ESC sendirian)
+    bool pending() const {
+        return state != 0;
+    }
+
+    // Dipanggil saat tidak ada byte lanjutan dalam ESC_TIMEOUT_MS: ESC yang
+    // berdiri sendiri jadi KEY_ESCAPE, sequence terputus lainnya dibuang
+    bool flush(KeyEvent& event) {
+        bool escape = depth == 1 && prefix[0] == '\033';
+        reset();
+        if (!escape) return false;
+        event.action = KEY_ESCAPE;
+        event.ch = '\033';
+        return true;
+    }
+
+    static const int ESC_TIMEOUT_MS = 30;
+
+private:
+    uint8_t state = 0;
+    size_t depth = 0;
+    char prefix[2] = {0, 0};
+    bool skipping = false;
+    bool pasting = false;
+
+    void reset() {
+        state = 0;
+        depth = 0;
+    }
+
+    bool feedPaste(char c, KeyEvent& event) {
+        static const char END[] = "\033[201~";
+        const size_t END_LEN = sizeof(END) - 1;
+        pasted += c;
+        if (c == '~' && pasted.size() >= END_LEN &&
+            memcmp(pasted.data() + pasted.size() - END_LEN, END, END_LEN) == 0) {
+            pasted.resize(pasted.size() - END_LEN);
+            pasting = false;
+            event.action = KEY_PASTE;
+            event.ch = 0;
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif
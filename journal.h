@@ -0,0 +1,362 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+// Write-ahead journal untuk operasi edit.
+//
+// Setiap operasi edit ditulis ke journal SEBELUM diterapkan ke buffer.
+// Record ditampung di memori lalu di-commit bersama (satu write() + satu
+// fdatasync()) paling lambat setiap `syncIntervalMs`, jadi biaya fsync
+// dibagi ke banyak keystroke. Commit berkala berjalan di thread sendiri;
+// kalau write/fdatasync gagal (ENOSPC, EIO) record tidak dibuang, dicoba
+// lagi di commit berikutnya, dan errno-nya terbaca lewat lastError().
+//
+// Format file:
+//   "PKJ1"                                  (magic, 4 byte)
+//   record*: op(u8) len(u32) payload crc(u32)
+//
+// Record pertama selalu J_BASE (file dasar + posisi kursor) atau
+// J_SNAPSHOT (isi buffer lengkap). Recovery berhenti di record pertama yang
+// crc-nya rusak (tulisan terakhir yang terpotong saat crash).
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+enum JournalOp : uint8_t {
+    J_BASE = 1,         // payload: state dasar, isi mengacu ke file tersimpan
+    J_SNAPSHOT,         // payload: state lengkap termasuk semua baris
+    J_INSERT,           // payload: 1 byte karakter
+    J_BACKSPACE,
+    J_NEWLINE,
+    J_DELETE_WORD,
+    J_UNDO,
+    J_REDO,
+    J_MOVE_UP,
+    J_MOVE_DOWN,
+    J_TOGGLE_BOLD,
+    J_TOGGLE_ITALIC,
+    J_TOGGLE_UNDERLINE,
+    J_MOVE_LEFT,        // geser kursor satu grapheme
+    J_MOVE_RIGHT,
+    J_WORD_LEFT,
+    J_WORD_RIGHT,
+    J_HOME,
+    J_END,
+    J_MOVE_TO,          // payload: u32 nomor baris tujuan (PgUp/PgDn)
+    J_DELETE_FORWARD,
+    J_PASTE,            // payload: teks yang di-paste
+    J_JOIN_LINE,
+    J_DELETE_LINE,
+    J_MOVE_LINE_UP,
+    J_MOVE_LINE_DOWN,
+    J_ADD_CURSOR_BELOW, // multi-kursor, lihat Document::addCursorBelow
+    J_ADD_CURSORS_AT_WORD,
+    J_CLEAR_CURSORS,
+    J_SPLICE            // payload: EditOp (textedit.h), edit dari klien kolaborasi
+};
+
+inline uint32_t journalChecksum(const char* data, size_t len, uint32_t h = 2166136261u) {
+    // FNV-1a, cukup untuk mendeteksi record yang terpotong
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (unsigned char)data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+inline void journalPutU32(std::string& out, uint32_t v) {
+    char b[4] = {(char)(v & 0xff), (char)((v >> 8) & 0xff),
+                 (char)((v >> 16) & 0xff), (char)((v >> 24) & 0xff)};
+    out.append(b, 4);
+}
+
+inline uint32_t journalGetU32(const char* p) {
+    const unsigned char* u = (const unsigned char*)p;
+    return (uint32_t)u[0] | ((uint32_t)u[1] << 8) |
+           ((uint32_t)u[2] << 16) | ((uint32_t)u[3] << 24);
+}
+
+class Journal {
+private:
+    std::string path;
+    int fd = -1;
+    std::string pending;            // record yang belum di-commit
+    size_t recordsSinceCheckpoint = 0;
+    std::chrono::steady_clock::time_point firstPending;
+    off_t committedSize = 0;        // panjang file yang sudah durable
+
+    // Group commit berjalan di thread `flusher`: keystroke hanya menyerahkan
+    // buffer, tidak pernah menunggu write()/fdatasync(). Commit yang gagal
+    // mengembalikan recordnya ke `failed` dan dicoba lagi berikutnya.
+    std::thread flusher;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::string inflight;           // sedang ditulis flusher
+    std::string failed;             // commit gagal, lebih tua dari `pending`
+    bool busy = false;
+    bool stopping = false;
+    int error = 0;                  // errno commit terakhir, 0 = berhasil
+
+    static bool writeAll(int fd, const char* data, size_t len) {
+        while (len > 0) {
+            ssize_t n = ::write(fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += n;
+            len -= (size_t)n;
+        }
+        return true;
+    }
+
+    // Tulis `data` dan fdatasync. Kalau gagal, tulisan parsial dipotong lagi
+    // supaya record berikutnya tetap menyambung record utuh terakhir.
+    int writeOut(const std::string& data) {
+        if (writeAll(fd, data.data(), data.size()) && fdatasync(fd) == 0) {
+            committedSize += (off_t)data.size();
+            return 0;
+        }
+        int e = errno ? errno : EIO;
+        if (ftruncate(fd, committedSize) != 0) {
+            // sisa tulisan tetap ada; replay berhenti di crc yang rusak
+        }
+        return e;
+    }
+
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !inflight.empty(); });
+            if (inflight.empty()) return;
+            std::string data;
+            data.swap(inflight);
+            lock.unlock();
+            int e = writeOut(data);
+            lock.lock();
+            if (e == 0) {
+                data.clear();
+                inflight.swap(data); // kapasitas buffer dipakai lagi oleh pending
+            }
+            error = e;
+            if (e == 0)
+                commits++;
+            else
+                failed += data;
+            busy = false;
+            idle.notify_all();
+        }
+    }
+
+    // Dipanggil dengan `mutex` terkunci: record yang gagal kembali ke depan
+    void reclaimFailed() {
+        if (failed.empty()) return;
+        if (pending.empty())
+            firstPending = std::chrono::steady_clock::now();
+        pending.insert(0, failed);
+        failed.clear();
+    }
+
+    void waitIdle(std::unique_lock<std::mutex>& lock) {
+        idle.wait(lock, [this] { return !busy; });
+    }
+
+    void stopFlusher() {
+        if (!flusher.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+        stopping = false;
+    }
+
+public:
+    int syncIntervalMs = 200;       // batas waktu group commit
+    size_t checkpointRecords = 4096; // batas panjang replay saat recovery
+    std::atomic<size_t> commits{0}; // jumlah fdatasync yang sudah berhasil
+
+    ~Journal() {
+        close();
+    }
+
+    bool open(const std::string& journalPath) {
+        path = journalPath;
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) return false;
+        committedSize = lseek(fd, 0, SEEK_END);
+        if (committedSize == 0 && writeAll(fd, "PKJ1", 4))
+            committedSize = 4;
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) {
+            commit();
+            stopFlusher();
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    // errno commit terakhir yang gagal (0 = semua record sudah durable atau
+    // masih menunggu giliran). Record yang gagal tidak dibuang.
+    int lastError() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return error;
+    }
+
+    static void encodeRecord(std::string& out, JournalOp op, const std::string& payload) {
+        size_t start = out.size();
+        out += (char)op;
+        journalPutU32(out, (uint32_t)payload.size());
+        out += payload;
+        journalPutU32(out, journalChecksum(out.data() + start, out.size() - start));
+    }
+
+    void append(JournalOp op, const std::string& payload = "") {
+        if (fd < 0) return;
+        if (pending.empty())
+            firstPending = std::chrono::steady_clock::now();
+        encodeRecord(pending, op, payload);
+        recordsSinceCheckpoint++;
+    }
+
+    // Sisa waktu (ms) sebelum group commit berikutnya jatuh tempo, -1 jika
+    // tidak ada record yang menunggu.
+    int msUntilCommit() const {
+        if (pending.empty()) return -1;
+        auto due = firstPending + std::chrono::milliseconds(syncIntervalMs);
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            due - std::chrono::steady_clock::now()).count();
+        return left > 0 ? (int)left : 0;
+    }
+
+    void maybeCommit() {
+        if (msUntilCommit() == 0)
+            flushAsync();
+    }
+
+    // Serahkan record ke flusher tanpa menunggu. Kalau commit sebelumnya
+    // masih berjalan, record menunggu giliran berikutnya (setengah interval
+    // lagi, supaya timer tidak berputar di 0 ms).
+    void flushAsync() {
+        if (fd < 0) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (busy) {
+            firstPending = std::chrono::steady_clock::now() - std::chrono::milliseconds(syncIntervalMs / 2);
+            return;
+        }
+        reclaimFailed();
+        if (pending.empty()) return;
+        inflight.swap(pending);
+        pending.clear();
+        busy = true;
+        if (!flusher.joinable())
+            flusher = std::thread([this] { flushLoop(); });
+        wake.notify_one();
+    }
+
+    // Commit sinkron (keluar, pindah dokumen, sinyal): tunggu flusher lalu
+    // tulis sisanya. false = gagal, record tetap disimpan untuk dicoba lagi.
+    bool commit() {
+        if (fd < 0) return true;
+        std::unique_lock<std::mutex> lock(mutex);
+        waitIdle(lock);
+        reclaimFailed();
+        if (pending.empty()) return error == 0;
+        error = writeOut(pending);
+        if (error != 0) return false;
+        pending.clear();
+        commits++;
+        return true;
+    }
+
+    bool needsCheckpoint() const {
+        return recordsSinceCheckpoint >= checkpointRecords;
+    }
+
+    // Ganti isi journal dengan satu record awal (J_BASE atau J_SNAPSHOT).
+    // Ditulis ke file sementara lalu di-rename, jadi journal lama tetap utuh
+    // sampai yang baru sudah durable.
+    bool reset(JournalOp op, const std::string& payload) {
+        if (path.empty()) return false; // dokumen tanpa journal (mis. klien kolaborasi)
+        std::unique_lock<std::mutex> lock(mutex);
+        waitIdle(lock);
+        std::string tmpPath = path + ".tmp";
+        int tmp = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (tmp < 0) return false;
+        std::string data = "PKJ1";
+        encodeRecord(data, op, payload);
+        bool ok = writeAll(tmp, data.data(), data.size()) && fdatasync(tmp) == 0;
+        ::close(tmp);
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) return false;
+        pending.clear(); // sudah tercakup record awal yang baru
+        failed.clear();
+        error = 0;
+        if (fd >= 0) ::close(fd);
+        fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        committedSize = (off_t)data.size();
+        recordsSinceCheckpoint = 0;
+        return fd >= 0;
+    }
+
+    void remove() {
+        stopFlusher();
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        pending.clear();
+        failed.clear();
+        unlink(path.c_str());
+    }
+
+    // Baca semua record yang valid dan panggil `apply` untuk masing-masing.
+    // Mengembalikan jumlah record yang di-replay.
+    static size_t replay(const std::string& journalPath,
+                         const std::function<void(JournalOp, const std::string&)>& apply) {
+        FILE* f = fopen(journalPath.c_str(), "rb");
+        if (!f) return 0;
+        std::string data;
+        char buf[65536];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            data.append(buf, n);
+        fclose(f);
+
+        if (data.size() < 4 || data.compare(0, 4, "PKJ1") != 0) return 0;
+        size_t pos = 4, count = 0;
+        std::string payload;
+        while (pos + 9 <= data.size()) {
+            uint32_t len = journalGetU32(data.data() + pos + 1);
+            if (pos + 9 + (size_t)len > data.size()) break;
+            uint32_t crc = journalGetU32(data.data() + pos + 5 + len);
+            if (crc != journalChecksum(data.data() + pos, 5 + (size_t)len)) break;
+            payload.assign(data, pos + 5, len);
+            apply((JournalOp)data[pos], payload);
+            pos += 9 + (size_t)len;
+            count++;
+        }
+        return count;
+    }
+};
+
+#endif
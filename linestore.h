@@ -0,0 +1,1492 @@
+#ifndef LINESTORE_H
+#define LINESTORE_H
+
+// Penyimpanan baris yang padat, pengganti vector<string>.
+//
+// Isi baris ditulis berurutan ke arena blok 64 KB (diambil dari PagePool)
+// sebagai [varint len][bytes]. Tabel baris hanya berisi LineRef 6 byte
+// (nomor blok + offset), jadi overhead per baris = 6 byte ref + 1 byte
+// panjang untuk baris < 128 byte, dibanding 32 byte header std::string plus
+// blok heap. Baris pendek yang sama (mis. "", "}" atau pesan log berulang)
+// di-intern: semua baris menunjuk ke record yang sama.
+//
+// Mengubah baris menulis record baru; record lama jadi sampah yang dibuang
+// oleh compact() begitu sampah sudah sebanyak isi yang hidup. string_view
+// yang dikembalikan hanya valid sampai operasi tulis berikutnya.
+//
+// Tabel LineRef disimpan di LineIndex, B+tree dengan jumlah baris per
+// subtree: akses, sisip dan hapus baris ke-i semuanya O(log n), jadi
+// menyisipkan baris di tengah dokumen 10 juta baris tidak menggeser array.
+// Selain jumlah baris, tiap subtree juga menyimpan LineStats (byte, kata,
+// karakter) yang diperbarui di setiap set/sisip/hapus, jadi statistik
+// seluruh dokumen O(1) dan statistik rentang baris O(log n). Jumlah
+// karakter per atribut format (AttrStats) diagregasi dengan cara yang sama.
+//
+// Dokumen besar yang jarang diedit bisa memakai cold storage: blok selain
+// blok ekor tidak pernah berubah, jadi dikompres LZ sekali, dan halamannya
+// dibebaskan begitu blok itu tidak termasuk HOT_BLOCKS blok yang terakhir
+// dibaca. Membaca baris di blok dingin mendekompres blok itu lagi (~80 us).
+//
+// Blok juga bisa dipinjam dari memori lain yang formatnya sama, yaitu file
+// native yang di-mmap (adopt, native.h): membuka dokumen tidak menyalin teks.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include "bufferpool.h"
+#include "utf8.h"
+#include "lz.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#pragma pack(push, 1)
+struct LineRef {
+    uint32_t block;
+    uint16_t offset;
+};
+#pragma pack(pop)
+
+// Statistik isi baris (tanpa pemisah baris). Kata = rangkaian code point
+// yang bukan pemisah kata; karakter = code point.
+struct LineStats {
+    uint64_t bytes = 0;
+    uint64_t words = 0;
+    uint64_t chars = 0;
+
+    static LineStats of(std::string_view line) {
+        LineStats s;
+        s.bytes = line.size();
+        bool inWord = false;
+        if (isAscii(line)) {
+            s.chars = line.size();
+            for (char c : line) {
+                bool separator = c == ' ' || c == '\t';
+                if (!separator && !inWord) s.words++;
+                inWord = !separator;
+            }
+            return s;
+        }
+        for (size_t pos = 0; pos < line.size();) {
+            size_t length;
+            bool separator = isWordSeparator(decodeUtf8(line, pos, &length));
+            if (!separator && !inWord) s.words++;
+            inWord = !separator;
+            s.chars++;
+            pos += length;
+        }
+        return s;
+    }
+
+    LineStats& operator+=(const LineStats& o) {
+        bytes += o.bytes;
+        words += o.words;
+        chars += o.chars;
+        return *this;
+    }
+
+    LineStats& operator-=(const LineStats& o) {
+        bytes -= o.bytes;
+        words -= o.words;
+        chars -= o.chars;
+        return *this;
+    }
+};
+
+// Jumlah karakter (code point) per atribut format: chars[b] = karakter
+// dengan bit atribut 1 << b (bold, italic, underline; lihat format.h).
+// Karakter dengan beberapa atribut terhitung di masing-masing atribut.
+struct AttrStats {
+    static const int KINDS = 3;
+    uint64_t chars[KINDS] = {};
+
+    bool operator==(const AttrStats& o) const {
+        return memcmp(chars, o.chars, sizeof(chars)) == 0;
+    }
+
+    bool operator!=(const AttrStats& o) const {
+        return !(*this == o);
+    }
+
+    AttrStats& operator+=(const AttrStats& o) {
+        for (int b = 0; b < KINDS; ++b)
+            chars[b] += o.chars[b];
+        return *this;
+    }
+
+    AttrStats& operator-=(const AttrStats& o) {
+        for (int b = 0; b < KINDS; ++b)
+            chars[b] -= o.chars[b];
+        return *this;
+    }
+};
+
+// B+tree LineRef yang diindeks posisi. Daun berisi sampai LEAF_MAX ref dan
+// saling tersambung untuk iterasi berurutan; node dalam menyimpan jumlah
+// baris tiap anak. Daun yang penuh dipecah di dekat posisi sisip, jadi
+// append dan sisipan berurutan menghasilkan daun yang (hampir) penuh.
+//
+// Node dalam juga menyimpan LineStats tiap anak. Daun tidak menyimpan
+// statistik per baris (overhead per baris tetap 6 byte); kalau perlu,
+// statistik satu baris dihitung ulang dari isinya lewat `measure`, yaitu
+// saat daun dipecah dan untuk daun di ujung rentang query.
+//
+// Daun juga boleh membawa cache hash 64-bit per baris untuk diff (0 = belum
+// dihitung). Array-nya baru dialokasikan saat hash pertama kali diminta, dan
+// entri yang berubah hanya dinolkan, jadi diff berikutnya cuma menghitung
+// ulang baris yang disunting.
+//
+// AttrStats tidak bisa dihitung dari isi baris, jadi disimpan per baris di
+// array daun yang juga baru dialokasikan saat baris berformat pertama di daun
+// itu diisi (setAttrs, dari FormatSpans), dan dijumlahkan di node dalam
+// seperti LineStats. Nilainya ikut baris saat disisip, dihapus, dipecah dan
+// digabung; set() tidak mengubahnya.
+//
+// Daun bisa dibagi dengan snapshot (share): selama dibagi, isinya tidak
+// pernah diubah. Edit yang mengenai daun itu menyalinnya dulu (copy-on-write)
+// dan memasang salinannya di pohon; daun lama tinggal milik snapshot dan
+// dibebaskan di unshare terakhir.
+class LineIndex {
+public:
+    static const size_t LEAF_MAX = 512;
+    static const size_t INNER_MAX = 64;
+
+    using Measure = LineStats (*)(const void* context, LineRef ref);
+
+    struct Node {
+        bool leaf;
+        uint16_t n = 0;
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+    };
+
+    struct Leaf : Node {
+        Leaf* next = nullptr;
+        Leaf* prev = nullptr;
+        uint64_t* hashes = nullptr; // cache hash per baris, nullptr = belum pernah diminta
+        AttrStats* attrs = nullptr; // karakter berformat per baris, nullptr = semua polos
+        uint32_t shares = 0;        // jumlah snapshot yang membaca daun ini
+        bool orphan = false;        // sudah keluar dari pohon, tinggal dipegang snapshot
+        LineRef refs[LEAF_MAX];
+        Leaf() : Node(true) {}
+    };
+
+    struct Inner : Node {
+        size_t counts[INNER_MAX];
+        LineStats sums[INNER_MAX];
+        AttrStats attrSums[INNER_MAX];
+        Node* child[INNER_MAX];
+        Inner() : Node(false) {}
+    };
+
+    LineIndex() {
+        reset();
+    }
+
+    LineIndex(const LineIndex&) = delete;
+    LineIndex& operator=(const LineIndex&) = delete;
+
+    ~LineIndex() {
+        destroy(root);
+    }
+
+    void setMeasure(Measure m, const void* context) {
+        measure = m;
+        measureContext = context;
+    }
+
+    size_t size() const {
+        return total;
+    }
+
+    const LineStats& stats() const {
+        return totals;
+    }
+
+    const AttrStats& attrStats() const {
+        return attrTotals;
+    }
+
+    // Baris yang memuat offset `pos` di teks gabungan (setiap baris diikuti
+    // '\n'); pos diubah jadi offset di dalam baris itu. Offset di luar teks
+    // mengembalikan size().
+    size_t lineAtOffset(uint64_t& pos) const {
+        size_t line = 0;
+        const Node* node = root;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            uint16_t k = 0;
+            while (k + 1 < inner->n && pos >= inner->sums[k].bytes + inner->counts[k]) {
+                pos -= inner->sums[k].bytes + inner->counts[k];
+                line += inner->counts[k];
+                k++;
+            }
+            node = inner->child[k];
+        }
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        for (uint16_t j = 0; j < leaf->n; ++j, ++line) {
+            uint64_t length = measure(measureContext, leaf->refs[j]).bytes + 1;
+            if (pos < length) return line;
+            pos -= length;
+        }
+        return line;
+    }
+
+    // Statistik baris [0, i)
+    LineStats statsBefore(size_t i) const {
+        LineStats s;
+        const Node* node = root;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            uint16_t k = 0;
+            while (k + 1 < inner->n && i >= inner->counts[k]) {
+                i -= inner->counts[k];
+                s += inner->sums[k];
+                k++;
+            }
+            node = inner->child[k];
+        }
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        for (size_t j = 0; j < i && j < leaf->n; ++j)
+            s += measure(measureContext, leaf->refs[j]);
+        return s;
+    }
+
+    // AttrStats baris [0, i)
+    AttrStats attrStatsBefore(size_t i) const {
+        AttrStats s;
+        const Node* node = root;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            uint16_t k = 0;
+            while (k + 1 < inner->n && i >= inner->counts[k]) {
+                i -= inner->counts[k];
+                s += inner->attrSums[k];
+                k++;
+            }
+            node = inner->child[k];
+        }
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        if (leaf->attrs)
+            for (size_t j = 0; j < i && j < leaf->n; ++j)
+                s += leaf->attrs[j];
+        return s;
+    }
+
+    AttrStats attrsAt(size_t i) const {
+        const Leaf* leaf = findLeaf(i);
+        return leaf->attrs ? leaf->attrs[i] : AttrStats();
+    }
+
+    // Ganti AttrStats baris ke-i; baris polos di daun tanpa array tidak
+    // mengalokasikan apa-apa
+    void setAttrs(size_t i, const AttrStats& attrs) {
+        AttrStats before = attrsAt(i);
+        if (before == attrs) return;
+        Node* node = root;
+        Inner* parent = nullptr;
+        uint16_t slot = 0;
+        while (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            uint16_t k = 0;
+            while (i >= inner->counts[k]) {
+                i -= inner->counts[k];
+                k++;
+            }
+            inner->attrSums[k] -= before;
+            inner->attrSums[k] += attrs;
+            parent = inner;
+            slot = k;
+            node = inner->child[k];
+        }
+        Leaf* leaf = own(parent, slot);
+        if (!leaf->attrs) addAttrs(leaf);
+        leaf->attrs[i] = attrs;
+        attrTotals -= before;
+        attrTotals += attrs;
+    }
+
+    // Semua baris jadi polos, O(node)
+    void clearAttrs() {
+        clearAttrs(root);
+        attrTotals = AttrStats();
+    }
+
+    LineRef get(size_t i) const {
+        size_t pos = i;
+        return findLeaf(pos)->refs[pos];
+    }
+
+    // `before`/`after` = statistik baris lama dan baru
+    void set(size_t i, LineRef ref, const LineStats& before, const LineStats& after) {
+        Node* node = root;
+        Inner* parent = nullptr;
+        uint16_t slot = 0;
+        while (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            uint16_t k = 0;
+            while (i >= inner->counts[k]) {
+                i -= inner->counts[k];
+                k++;
+            }
+            inner->sums[k] -= before;
+            inner->sums[k] += after;
+            parent = inner;
+            slot = k;
+            node = inner->child[k];
+        }
+        Leaf* leaf = own(parent, slot);
+        leaf->refs[i] = ref;
+        if (leaf->hashes) leaf->hashes[i] = 0;
+        totals -= before;
+        totals += after;
+    }
+
+    void insert(size_t i, LineRef ref, const LineStats& stats) {
+        if (root->leaf) own(nullptr, 0);
+        Node* right = insertAt(root, total, i, ref, stats);
+        if (right) {
+            Inner* top = newInner();
+            top->n = 2;
+            top->child[0] = root;
+            top->child[1] = right;
+            top->counts[0] = countOf(root);
+            top->counts[1] = countOf(right);
+            top->sums[0] = statsOf(root);
+            top->sums[1] = statsOf(right);
+            top->attrSums[0] = attrsOf(root);
+            top->attrSums[1] = attrsOf(right);
+            root = top;
+        }
+        total++;
+        totals += stats;
+    }
+
+    void erase(size_t i, const LineStats& stats) {
+        if (root->leaf) own(nullptr, 0);
+        AttrStats attrs = attrsAt(i);
+        eraseAt(root, i, stats, attrs);
+        total--;
+        totals -= stats;
+        attrTotals -= attrs;
+        while (!root->leaf && root->n == 1) { // akar dengan satu anak dibuang
+            Inner* old = static_cast<Inner*>(root);
+            root = old->child[0];
+            delete old;
+            inners--;
+        }
+    }
+
+    void clear() {
+        destroy(root);
+        reset();
+    }
+
+    // Ganti isi dengan `n` ref berurutan sekaligus: daun diisi penuh, lalu
+    // node dalam disusun dari bawah ke atas, O(n) tanpa pencarian posisi.
+    // `groupStats[g]` = statistik baris [g * LEAF_MAX, (g + 1) * LEAF_MAX);
+    // nullptr = dihitung lewat measure.
+    void build(const LineRef* refs, size_t n, const LineStats* groupStats) {
+        clear();
+        std::vector<Node*> level;
+        std::vector<size_t> counts;
+        std::vector<LineStats> sums;
+        Leaf* prev = nullptr;
+        for (size_t at = 0, g = 0; at < n; at += LEAF_MAX, ++g) {
+            Leaf* leaf = prev ? newLeaf() : first;
+            if (prev) prev->next = leaf;
+            leaf->prev = prev;
+            leaf->n = (uint16_t)(n - at < LEAF_MAX ? n - at : LEAF_MAX);
+            memcpy(leaf->refs, refs + at, leaf->n * sizeof(LineRef));
+            level.push_back(leaf);
+            counts.push_back(leaf->n);
+            sums.push_back(groupStats ? groupStats[g] : statsOf(leaf));
+            totals += sums.back();
+            prev = leaf;
+        }
+        total = n;
+        while (level.size() > 1) {
+            std::vector<Node*> up;
+            std::vector<size_t> upCounts;
+            std::vector<LineStats> upSums;
+            for (size_t at = 0; at < level.size(); at += INNER_MAX) {
+                Inner* inner = newInner();
+                size_t count = 0;
+                LineStats sum;
+                for (size_t k = at; k < level.size() && k < at + INNER_MAX; ++k) {
+                    inner->child[inner->n] = level[k];
+                    inner->counts[inner->n] = counts[k];
+                    inner->sums[inner->n] = sums[k];
+                    inner->n++;
+                    count += counts[k];
+                    sum += sums[k];
+                }
+                up.push_back(inner);
+                upCounts.push_back(count);
+                upSums.push_back(sum);
+            }
+            level.swap(up);
+            counts.swap(upCounts);
+            sums.swap(upSums);
+        }
+        if (!level.empty()) root = level[0];
+    }
+
+    const Leaf* firstLeaf() const {
+        return first;
+    }
+
+    // Bagi semua daun (berurutan) dengan snapshot; masing-masing dilepas lagi
+    // dengan unshare
+    void share(std::vector<const Leaf*>& out) {
+        out.clear();
+        out.reserve(leaves);
+        for (Leaf* leaf = first; leaf; leaf = leaf->next) {
+            leaf->shares++;
+            out.push_back(leaf);
+        }
+    }
+
+    static void unshare(const Leaf* shared) {
+        Leaf* leaf = const_cast<Leaf*>(shared);
+        if (--leaf->shares == 0 && leaf->orphan)
+            delete leaf;
+    }
+
+    // Kunjungi semua ref berurutan, boleh diubah di tempat (untuk compact;
+    // tidak dipanggil selama ada snapshot)
+    template<typename F>
+    void forEach(F f) {
+        for (Leaf* leaf = first; leaf; leaf = leaf->next)
+            for (uint16_t j = 0; j < leaf->n; ++j)
+                f(leaf->refs[j]);
+    }
+
+    // Hash semua baris berurutan ke `out`; hash yang belum ada dihitung
+    // dengan hashOf(ref) dan disimpan di daun
+    template<typename H>
+    void hashes(H hashOf, std::vector<uint64_t>& out) {
+        out.clear();
+        out.reserve(total);
+        for (Leaf* leaf = first; leaf; leaf = leaf->next) {
+            if (!leaf->hashes) addHashes(leaf);
+            for (uint16_t j = 0; j < leaf->n; ++j) {
+                uint64_t& h = leaf->hashes[j];
+                if (h == 0) {
+                    h = hashOf(leaf->refs[j]);
+                    if (h == 0) h = 1;
+                }
+                out.push_back(h);
+            }
+        }
+    }
+
+    size_t memoryBytes() const {
+        return leaves * sizeof(Leaf) + inners * sizeof(Inner) + hashedLeaves * LEAF_MAX * sizeof(uint64_t) +
+               attrLeaves * LEAF_MAX * sizeof(AttrStats);
+    }
+
+private:
+    Node* root = nullptr;
+    Leaf* first = nullptr; // daun paling kiri; merge selalu ke kiri jadi tidak pernah dihapus (own bisa menggantinya)
+    size_t total = 0;
+    LineStats totals;
+    AttrStats attrTotals;
+    Measure measure = nullptr;
+    const void* measureContext = nullptr;
+    size_t leaves = 0;
+    size_t inners = 0;
+    size_t hashedLeaves = 0;
+    size_t attrLeaves = 0;
+
+    void reset() {
+        leaves = 0;
+        inners = 0;
+        hashedLeaves = 0;
+        attrLeaves = 0;
+        first = newLeaf();
+        root = first;
+        total = 0;
+        totals = LineStats();
+        attrTotals = AttrStats();
+    }
+
+    Leaf* newLeaf() {
+        leaves++;
+        return new Leaf();
+    }
+
+    Inner* newInner() {
+        inners++;
+        return new Inner();
+    }
+
+    void addHashes(Leaf* leaf) {
+        leaf->hashes = new uint64_t[LEAF_MAX]();
+        hashedLeaves++;
+    }
+
+    void addAttrs(Leaf* leaf) {
+        leaf->attrs = new AttrStats[LEAF_MAX]();
+        attrLeaves++;
+    }
+
+    void clearAttrs(Node* node) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            if (leaf->attrs) attrLeaves--;
+            delete[] leaf->attrs;
+            leaf->attrs = nullptr;
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        for (uint16_t k = 0; k < inner->n; ++k) {
+            inner->attrSums[k] = AttrStats();
+            clearAttrs(inner->child[k]);
+        }
+    }
+
+    // Daun keluar dari pohon; yang masih dibagi ditinggal untuk snapshot
+    void deleteLeaf(Leaf* leaf) {
+        if (leaf->hashes) hashedLeaves--;
+        if (leaf->attrs) attrLeaves--;
+        leaves--;
+        freeLeaf(leaf);
+    }
+
+    static void freeLeaf(Leaf* leaf) {
+        delete[] leaf->hashes;
+        leaf->hashes = nullptr;
+        delete[] leaf->attrs;
+        leaf->attrs = nullptr;
+        if (leaf->shares)
+            leaf->orphan = true;
+        else
+            delete leaf;
+    }
+
+    // Daun anak ke-k dari `parent` (nullptr = akar) yang boleh diubah: daun
+    // yang sedang dibagi diganti salinannya, di induk dan di rantai daun.
+    // Cache hash dan AttrStats pindah ke salinan (snapshot tidak memakainya).
+    Leaf* own(Inner* parent, uint16_t k) {
+        Leaf* leaf = static_cast<Leaf*>(parent ? parent->child[k] : root);
+        if (!leaf->shares) return leaf;
+        Leaf* copy = newLeaf();
+        copy->n = leaf->n;
+        memcpy(copy->refs, leaf->refs, leaf->n * sizeof(LineRef));
+        copy->hashes = leaf->hashes;
+        leaf->hashes = nullptr;
+        copy->attrs = leaf->attrs;
+        leaf->attrs = nullptr;
+        copy->prev = leaf->prev;
+        copy->next = leaf->next;
+        if (copy->prev) copy->prev->next = copy;
+        else first = copy;
+        if (copy->next) copy->next->prev = copy;
+        if (parent) parent->child[k] = copy;
+        else root = copy;
+        leaves--;
+        freeLeaf(leaf);
+        return copy;
+    }
+
+    void destroy(Node* node) {
+        if (!node) return;
+        if (node->leaf) {
+            freeLeaf(static_cast<Leaf*>(node));
+        } else {
+            Inner* inner = static_cast<Inner*>(node);
+            for (uint16_t k = 0; k < inner->n; ++k)
+                destroy(inner->child[k]);
+            delete inner;
+        }
+    }
+
+    static size_t countOf(const Node* node) {
+        if (node->leaf) return node->n;
+        const Inner* inner = static_cast<const Inner*>(node);
+        size_t sum = 0;
+        for (uint16_t k = 0; k < inner->n; ++k)
+            sum += inner->counts[k];
+        return sum;
+    }
+
+    LineStats statsOf(const Node* node) const {
+        LineStats s;
+        if (node->leaf) {
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            for (uint16_t j = 0; j < leaf->n; ++j)
+                s += measure(measureContext, leaf->refs[j]);
+            return s;
+        }
+        const Inner* inner = static_cast<const Inner*>(node);
+        for (uint16_t k = 0; k < inner->n; ++k)
+            s += inner->sums[k];
+        return s;
+    }
+
+    static AttrStats attrsOf(const Node* node) {
+        AttrStats s;
+        if (node->leaf) {
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            if (leaf->attrs)
+                for (uint16_t j = 0; j < leaf->n; ++j)
+                    s += leaf->attrs[j];
+            return s;
+        }
+        const Inner* inner = static_cast<const Inner*>(node);
+        for (uint16_t k = 0; k < inner->n; ++k)
+            s += inner->attrSums[k];
+        return s;
+    }
+
+    // Turun ke daun yang memuat baris ke-pos; pos diubah jadi indeks di daun
+    Leaf* findLeaf(size_t& pos) const {
+        Node* node = root;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            uint16_t k = 0;
+            while (pos >= inner->counts[k]) {
+                pos -= inner->counts[k];
+                k++;
+            }
+            node = inner->child[k];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    // Sisipkan ke subtree berisi `size` baris; kembalikan saudara kanan baru
+    // kalau node dipecah
+    Node* insertAt(Node* node, size_t size, size_t i, LineRef ref, const LineStats& stats) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            if (leaf->n < LEAF_MAX) {
+                memmove(leaf->refs + i + 1, leaf->refs + i, (leaf->n - i) * sizeof(LineRef));
+                leaf->refs[i] = ref;
+                if (leaf->hashes) {
+                    memmove(leaf->hashes + i + 1, leaf->hashes + i, (leaf->n - i) * sizeof(uint64_t));
+                    leaf->hashes[i] = 0;
+                }
+                if (leaf->attrs) {
+                    memmove(leaf->attrs + i + 1, leaf->attrs + i, (leaf->n - i) * sizeof(AttrStats));
+                    leaf->attrs[i] = AttrStats();
+                }
+                leaf->n++;
+                return nullptr;
+            }
+            Leaf* right = newLeaf();
+            right->next = leaf->next;
+            right->prev = leaf;
+            if (right->next) right->next->prev = right;
+            leaf->next = right;
+            if (leaf->hashes) addHashes(right);
+            if (leaf->attrs) addAttrs(right);
+            if (i == leaf->n) { // append: daun kiri tetap penuh
+                right->refs[0] = ref;
+                right->n = 1;
+                return right;
+            }
+            size_t split = std::min(std::max(i, LEAF_MAX / 4), LEAF_MAX * 3 / 4);
+            right->n = (uint16_t)(leaf->n - split);
+            memcpy(right->refs, leaf->refs + split, right->n * sizeof(LineRef));
+            if (leaf->hashes) memcpy(right->hashes, leaf->hashes + split, right->n * sizeof(uint64_t));
+            if (leaf->attrs) memcpy(right->attrs, leaf->attrs + split, right->n * sizeof(AttrStats));
+            leaf->n = (uint16_t)split;
+            if (i <= split)
+                insertAt(leaf, split, i, ref, stats);
+            else
+                insertAt(right, right->n, i - split, ref, stats);
+            return right;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        uint16_t k = 0;
+        if (i == size) { // append: langsung ke anak paling kanan
+            k = inner->n - 1;
+            i = inner->counts[k];
+        } else {
+            while (k + 1 < inner->n && i > inner->counts[k]) {
+                i -= inner->counts[k];
+                k++;
+            }
+        }
+        inner->counts[k]++;
+        inner->sums[k] += stats;
+        if (inner->child[k]->leaf) own(inner, k);
+        Node* split = insertAt(inner->child[k], inner->counts[k] - 1, i, ref, stats);
+        if (!split)
+            return nullptr;
+        inner->counts[k] = countOf(inner->child[k]);
+        LineStats splitStats = statsOf(split);
+        inner->sums[k] -= splitStats;
+        AttrStats splitAttrs = attrsOf(split);
+        inner->attrSums[k] -= splitAttrs;
+        size_t splitCount = countOf(split);
+        if (inner->n < INNER_MAX) {
+            insertChild(inner, k + 1, split, splitCount, splitStats, splitAttrs);
+            return nullptr;
+        }
+        Inner* right = newInner();
+        uint16_t half = INNER_MAX / 2;
+        right->n = (uint16_t)(inner->n - half);
+        memcpy(right->child, inner->child + half, right->n * sizeof(Node*));
+        memcpy(right->counts, inner->counts + half, right->n * sizeof(size_t));
+        memcpy(right->sums, inner->sums + half, right->n * sizeof(LineStats));
+        memcpy(right->attrSums, inner->attrSums + half, right->n * sizeof(AttrStats));
+        inner->n = half;
+        if (k + 1 <= half)
+            insertChild(inner, k + 1, split, splitCount, splitStats, splitAttrs);
+        else
+            insertChild(right, k + 1 - half, split, splitCount, splitStats, splitAttrs);
+        return right;
+    }
+
+    static void insertChild(Inner* inner, uint16_t at, Node* child, size_t count, const LineStats& stats,
+                            const AttrStats& attrs) {
+        memmove(inner->child + at + 1, inner->child + at, (inner->n - at) * sizeof(Node*));
+        memmove(inner->counts + at + 1, inner->counts + at, (inner->n - at) * sizeof(size_t));
+        memmove(inner->sums + at + 1, inner->sums + at, (inner->n - at) * sizeof(LineStats));
+        memmove(inner->attrSums + at + 1, inner->attrSums + at, (inner->n - at) * sizeof(AttrStats));
+        inner->child[at] = child;
+        inner->counts[at] = count;
+        inner->sums[at] = stats;
+        inner->attrSums[at] = attrs;
+        inner->n++;
+    }
+
+    void eraseAt(Node* node, size_t i, const LineStats& stats, const AttrStats& attrs) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            std::copy(leaf->refs + i + 1, leaf->refs + leaf->n, leaf->refs + i);
+            if (leaf->hashes) std::copy(leaf->hashes + i + 1, leaf->hashes + leaf->n, leaf->hashes + i);
+            if (leaf->attrs) std::copy(leaf->attrs + i + 1, leaf->attrs + leaf->n, leaf->attrs + i);
+            leaf->n--;
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        uint16_t k = 0;
+        while (i >= inner->counts[k]) {
+            i -= inner->counts[k];
+            k++;
+        }
+        inner->counts[k]--;
+        inner->sums[k] -= stats;
+        inner->attrSums[k] -= attrs;
+        if (inner->child[k]->leaf) own(inner, k);
+        eraseAt(inner->child[k], i, stats, attrs);
+        rebalance(inner, k);
+    }
+
+    // Anak yang tinggal sedikit digabung dengan tetangganya kalau muat
+    void rebalance(Inner* inner, uint16_t k) {
+        Node* child = inner->child[k];
+        size_t limit = child->leaf ? LEAF_MAX : INNER_MAX;
+        if (child->n >= limit / 4 || inner->n < 2)
+            return;
+        uint16_t left = k + 1 < inner->n ? k : k - 1;
+        Node* a = inner->child[left];
+        Node* b = inner->child[left + 1];
+        if (a->n + b->n > limit)
+            return;
+        uint16_t merged = (uint16_t)(a->n + b->n);
+        if (a->leaf) {
+            Leaf* la = own(inner, left);
+            a = la;
+            Leaf* lb = static_cast<Leaf*>(b);
+            memcpy(la->refs + la->n, lb->refs, lb->n * sizeof(LineRef));
+            if (la->hashes || lb->hashes) {
+                if (!la->hashes) addHashes(la);
+                if (lb->hashes) memcpy(la->hashes + la->n, lb->hashes, lb->n * sizeof(uint64_t));
+                else memset(la->hashes + la->n, 0, lb->n * sizeof(uint64_t));
+            }
+            if (la->attrs || lb->attrs) {
+                if (!la->attrs) addAttrs(la);
+                if (lb->attrs) memcpy(la->attrs + la->n, lb->attrs, lb->n * sizeof(AttrStats));
+                else std::fill(la->attrs + la->n, la->attrs + merged, AttrStats());
+            }
+            la->next = lb->next;
+            if (la->next) la->next->prev = la;
+            deleteLeaf(lb);
+        } else {
+            Inner* ia = static_cast<Inner*>(a);
+            Inner* ib = static_cast<Inner*>(b);
+            memcpy(ia->child + ia->n, ib->child, ib->n * sizeof(Node*));
+            memcpy(ia->counts + ia->n, ib->counts, ib->n * sizeof(size_t));
+            memcpy(ia->sums + ia->n, ib->sums, ib->n * sizeof(LineStats));
+            memcpy(ia->attrSums + ia->n, ib->attrSums, ib->n * sizeof(AttrStats));
+            ib->n = 0;
+            delete ib;
+            inners--;
+        }
+        a->n = merged;
+        inner->counts[left] += inner->counts[left + 1];
+        inner->sums[left] += inner->sums[left + 1];
+        inner->attrSums[left] += inner->attrSums[left + 1];
+        memmove(inner->child + left + 1, inner->child + left + 2, (inner->n - left - 2) * sizeof(Node*));
+        memmove(inner->counts + left + 1, inner->counts + left + 2, (inner->n - left - 2) * sizeof(size_t));
+        memmove(inner->sums + left + 1, inner->sums + left + 2, (inner->n - left - 2) * sizeof(LineStats));
+        memmove(inner->attrSums + left + 1, inner->attrSums + left + 2, (inner->n - left - 2) * sizeof(AttrStats));
+        inner->n--;
+    }
+};
+
+// Pecah teks per baris (\n, \r\n atau \r). Hasil menunjuk ke dalam text;
+// selalu ada satu potongan lebih banyak dari jumlah pemisah baris. Pemisah
+// dicari 16 byte sekaligus dengan SSE2.
+inline void splitLines(std::string_view text, std::vector<std::string_view>& out) {
+    const char* p = text.data();
+    size_t n = text.size(), start = 0, i = 0;
+    size_t lastCR = std::string_view::npos;
+    auto onBreak = [&](size_t pos) {
+        if (p[pos] == '\n' && lastCR != std::string_view::npos && lastCR + 1 == pos) {
+            start = pos + 1; // \n dari pasangan \r\n
+            return;
+        }
+        out.push_back(text.substr(start, pos - start));
+        start = pos + 1;
+        if (p[pos] == '\r') lastCR = pos;
+    };
+#if defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    for (; i + 16 <= n; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(p + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, nl), _mm_cmpeq_epi8(chunk, cr)));
+        while (mask) {
+            onBreak(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; ++i)
+        if (p[i] == '\n' || p[i] == '\r')
+            onBreak(i);
+    out.push_back(text.substr(start));
+}
+
+class LineStore {
+public:
+    static const size_t INTERN_MAX_LEN = 64; // hanya baris sependek ini yang di-intern
+    static const size_t HOT_BLOCKS = 32;     // blok terdekompres yang dipertahankan (2 MB)
+    static const size_t COLD_BATCH = 6;      // blok yang dikompres per trimHot()
+    bool internLines = true;
+
+    // Dipanggil setiap kali baris [line, line + removed) diganti `inserted`
+    // baris (mis. untuk cache highlight); compact() tidak mengubah isi
+    std::function<void(size_t line, size_t removed, size_t inserted)> onChange;
+    // Dipanggil sebelum baris [line, line + removed) diganti, selagi isi
+    // lamanya masih bisa dibaca (mis. untuk mencatat edit kolaborasi)
+    std::function<void(size_t line, size_t removed)> onBeforeChange;
+
+    explicit LineStore(PagePool* p = nullptr) : pool(p ? p : &ownPool) {
+        index.setMeasure([](const void* self, LineRef ref) {
+            return LineStats::of(static_cast<const LineStore*>(self)->view(ref));
+        }, this);
+    }
+    LineStore(const LineStore&) = delete;
+    LineStore& operator=(const LineStore&) = delete;
+
+    ~LineStore() {
+        freeBlocks(blocks, blockKind, info);
+    }
+
+    size_t size() const {
+        return index.size();
+    }
+
+    bool empty() const {
+        return index.size() == 0;
+    }
+
+    std::string_view operator[](size_t i) const {
+        return view(index.get(i));
+    }
+
+    void set(size_t i, std::string_view text) {
+        if (onBeforeChange) onBeforeChange(i, 1);
+        LineStats before = LineStats::of((*this)[i]);
+        index.set(i, store(text), before, LineStats::of(text));
+        maybeCompact();
+        if (onChange) onChange(i, 1, 1);
+    }
+
+    void push_back(std::string_view text) {
+        if (onBeforeChange) onBeforeChange(index.size(), 0);
+        index.insert(index.size(), store(text), LineStats::of(text));
+        maybeCompact();
+        if (onChange) onChange(index.size() - 1, 0, 1);
+    }
+
+    void insert(size_t i, std::string_view text) {
+        if (onBeforeChange) onBeforeChange(i, 0);
+        index.insert(i, store(text), LineStats::of(text));
+        maybeCompact();
+        if (onChange) onChange(i, 0, 1);
+    }
+
+    void erase(size_t i) {
+        if (onBeforeChange) onBeforeChange(i, 1);
+        index.erase(i, LineStats::of((*this)[i]));
+        if (onChange) onChange(i, 1, 0);
+    }
+
+    // Ganti baris [first, first + count) dengan `with`; tiap baris O(log n)
+    void replace(size_t first, size_t count, const std::vector<std::string_view>& with) {
+        if (onBeforeChange) onBeforeChange(first, count);
+        std::vector<LineRef> added;
+        added.reserve(with.size());
+        for (std::string_view text : with)
+            added.push_back(store(text));
+        size_t same = std::min(count, added.size());
+        for (size_t i = 0; i < same; ++i)
+            index.set(first + i, added[i], LineStats::of((*this)[first + i]), LineStats::of(with[i]));
+        for (size_t i = same; i < count; ++i)
+            index.erase(first + same, LineStats::of((*this)[first + same]));
+        for (size_t i = same; i < added.size(); ++i)
+            index.insert(first + i, added[i], LineStats::of(with[i]));
+        maybeCompact(); // setelah splice, supaya ref di `added` tidak basi
+        if (onChange) onChange(first, count, with.size());
+    }
+
+    // Ganti isi dengan blok arena yang sudah jadi di memori lain (mis. file
+    // native yang di-mmap, native.h) tanpa menyalin teks: `refs` menunjuk ke
+    // `external`, dengan format record yang sama. Blok itu hanya dibaca;
+    // edit menulis record baru ke blok pool, dan compact() memindahkan
+    // baris yang masih hidup keluar. `keep` menahan memorinya selama masih
+    // ada baris di sana. `groupStats` seperti LineIndex::build.
+    void adopt(std::shared_ptr<const void> keep, const std::vector<const char*>& externalBlocks,
+               const LineRef* refs, size_t count, const LineStats* groupStats) {
+        clear();
+        if (onBeforeChange) onBeforeChange(0, 0);
+        for (const char* block : externalBlocks) {
+            blocks.push_back(const_cast<char*>(block));
+            blockKind.push_back(BLOCK_EXTERNAL);
+            info.push_back(BlockInfo());
+        }
+        external = std::move(keep);
+        index.build(refs, count, groupStats);
+        // Isi yang dipasang dihitung sebagai isi hidup: compact baru jalan
+        // setelah sampah sebanyak itu, bukan menyalin semuanya di edit pertama
+        size_t live = (size_t)index.stats().bytes;
+        compactAt = live > MIN_COMPACT_BYTES ? live : MIN_COMPACT_BYTES;
+        if (onChange) onChange(0, 0, count);
+    }
+
+    // Pertahankan API vector: B+tree tidak punya kapasitas cadangan
+    void reserve(size_t) {}
+    void shrink_to_fit() {}
+
+    void clear() {
+        if (onBeforeChange) onBeforeChange(0, index.size());
+        if (onChange) onChange(0, index.size(), 0);
+        index.clear();
+        freeBlocks(blocks, blockKind, info);
+        external.reset();
+        std::vector<uint64_t>().swap(internTable);
+        internCount = 0;
+        internHits = 0;
+        tailUsed = POOL_PAGE_SIZE;
+        written = 0;
+        compactAt = MIN_COMPACT_BYTES;
+    }
+
+    // Iterasi berurutan lewat rantai daun, O(1) per baris
+    class const_iterator {
+    private:
+        const LineStore* store;
+        const LineIndex::Leaf* leaf;
+        size_t pos;
+        size_t line;
+        void skipEmpty() {
+            while (leaf && pos >= leaf->n) {
+                leaf = leaf->next;
+                pos = 0;
+            }
+        }
+    public:
+        const_iterator(const LineStore* s, const LineIndex::Leaf* l, size_t i)
+            : store(s), leaf(l), pos(0), line(i) { skipEmpty(); }
+        std::string_view operator*() const { return store->view(leaf->refs[pos]); }
+        const_iterator& operator++() { ++pos; ++line; skipEmpty(); return *this; }
+        bool operator!=(const const_iterator& other) const { return line != other.line; }
+    };
+
+    const_iterator begin() const {
+        return const_iterator(this, index.firstLeaf(), 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, nullptr, index.size());
+    }
+
+    // Tulis ulang semua baris yang masih dipakai ke blok baru, buang sampah
+    void compact() {
+        if (pins > 0) return;
+        std::vector<char*> oldBlocks;
+        std::vector<uint8_t> oldKind;
+        std::vector<BlockInfo> oldInfo;
+        oldBlocks.swap(blocks);
+        oldKind.swap(blockKind);
+        oldInfo.swap(info);
+        std::vector<uint64_t>().swap(internTable);
+        internCount = 0;
+        internHits = 0;
+        tailUsed = POOL_PAGE_SIZE;
+        written = 0;
+        char* scratch = nullptr; // blok lama yang dingin didekompres ke sini
+        uint32_t scratchBlock = UINT32_MAX;
+        index.forEach([&](LineRef& ref) {
+            const char* block = oldBlocks[ref.block];
+            if (!block) {
+                if (scratchBlock != ref.block) {
+                    if (!scratch) scratch = pool->allocPage();
+                    unpack(oldInfo[ref.block], scratch);
+                    scratchBlock = ref.block;
+                }
+                block = scratch;
+            }
+            ref = store(decode(block + ref.offset));
+        });
+        if (scratch) pool->freePage(scratch);
+        freeBlocks(oldBlocks, oldKind, oldInfo);
+        external.reset(); // semua baris sudah pindah ke blok pool
+        compactAt = written > MIN_COMPACT_BYTES ? written * 2 : MIN_COMPACT_BYTES;
+    }
+
+    // Total memori: node B+tree + blok arena (panas) + salinan terkompres +
+    // tabel intern
+    size_t memoryBytes() const {
+        size_t bytes = index.memoryBytes() + internTable.capacity() * sizeof(uint64_t);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            if (blockKind[i] == BLOCK_LARGE)
+                bytes += largeSize(blocks[i]);
+            else if (blockKind[i] == BLOCK_EXTERNAL)
+                continue; // milik mapping file, bisa dibuang kernel kapan saja
+            else if (blocks[i])
+                bytes += POOL_PAGE_SIZE;
+            bytes += info[i].packedSize;
+        }
+        return bytes;
+    }
+
+    // Aktifkan cold storage. Interning dimatikan: mencari record yang sama
+    // membaca isi record lama dan akan memanaskan blok dingin.
+    void enableColdStorage() {
+        coldStorage = true;
+        internLines = false;
+        std::vector<uint64_t>().swap(internTable);
+    }
+
+    bool coldStorageEnabled() const {
+        return coldStorage;
+    }
+
+    // Kompres sampai COLD_BATCH blok yang belum punya salinan LZ, lalu
+    // bebaskan halaman blok panas yang paling lama tidak dibaca sampai
+    // tinggal HOT_BLOCKS. string_view ke blok yang dibebaskan jadi tidak
+    // valid, jadi hanya dipanggil di titik aman (mis. setelah frame
+    // digambar) dan tidak selama di-pin. Mengembalikan true jika masih ada
+    // blok yang belum dikompres.
+    bool trimHot() {
+        if (!coldStorage || pins > 0) return false;
+        size_t packedNow = 0;
+        bool more = false;
+        std::vector<std::pair<uint64_t, uint32_t>> hot;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            if (blockKind[b] != BLOCK_POOL || b == tailBlock || !blocks[b]) continue;
+            if (!info[b].packed) {
+                if (packedNow == COLD_BATCH) {
+                    more = true;
+                    continue;
+                }
+                lzCompress(blocks[b], info[b].used, packBuffer, true);
+                info[b].packed = new char[packBuffer.size()];
+                memcpy(info[b].packed, packBuffer.data(), packBuffer.size());
+                info[b].packedSize = (uint32_t)packBuffer.size();
+                packedNow++;
+            }
+            hot.push_back({info[b].lastUse, (uint32_t)b});
+        }
+        if (hot.size() > HOT_BLOCKS) {
+            size_t drop = hot.size() - HOT_BLOCKS;
+            std::nth_element(hot.begin(), hot.begin() + drop, hot.end());
+            for (size_t k = 0; k < drop; ++k) {
+                pool->freePage(blocks[hot[k].second]);
+                blocks[hot[k].second] = nullptr;
+            }
+            pool->trim(HOT_BLOCKS); // halaman yang dilepas kembali ke sistem
+        }
+        return more;
+    }
+
+    size_t coldBlocks() const {
+        size_t n = 0;
+        for (size_t b = 0; b < blocks.size(); ++b)
+            if (!blocks[b]) n++;
+        return n;
+    }
+
+    // Byte blok yang sudah punya salinan LZ, sebelum dan sesudah dikompres
+    size_t packableBytes() const {
+        size_t n = 0;
+        for (size_t b = 0; b < blocks.size(); ++b)
+            if (info[b].packed) n += info[b].used;
+        return n;
+    }
+
+    size_t packedBytes() const {
+        size_t n = 0;
+        for (size_t b = 0; b < blocks.size(); ++b)
+            if (info[b].packed) n += info[b].packedSize;
+        return n;
+    }
+
+    // Byte isi baris (tanpa overhead), untuk menghitung overhead per baris
+    size_t contentBytes() const {
+        return (size_t)index.stats().bytes;
+    }
+
+    // Statistik semua baris, O(1)
+    const LineStats& stats() const {
+        return index.stats();
+    }
+
+    // Statistik baris [first, last), O(log n) ditambah dua daun di ujungnya
+    LineStats stats(size_t first, size_t last) const {
+        LineStats s = index.statsBefore(last);
+        s -= index.statsBefore(first);
+        return s;
+    }
+
+    // Karakter berformat semua baris (O(1)) dan baris [first, last)
+    // (O(log n)). Isinya dipasang FormatSpans lewat setAttrStats.
+    const AttrStats& attrStats() const {
+        return index.attrStats();
+    }
+
+    AttrStats attrStats(size_t first, size_t last) const {
+        AttrStats s = index.attrStatsBefore(last);
+        s -= index.attrStatsBefore(first);
+        return s;
+    }
+
+    void setAttrStats(size_t i, const AttrStats& attrs) {
+        index.setAttrs(i, attrs);
+    }
+
+    void clearAttrStats() {
+        index.clearAttrs();
+    }
+
+    // Baris dan kolom untuk offset byte di teks gabungan, O(log n)
+    size_t lineAtOffset(uint64_t& pos) const {
+        return index.lineAtOffset(pos);
+    }
+
+    // Hash baris untuk diff (tidak pernah 0); sama untuk teks yang sama
+    static uint64_t lineHash(std::string_view text) {
+        uint64_t h = hashText(text);
+        return h ? h : 1;
+    }
+
+    // Hash semua baris berurutan; yang sudah pernah dihitung diambil dari
+    // cache di daun index, jadi hanya baris yang berubah yang di-hash ulang
+    void lineHashes(std::vector<uint64_t>& out) {
+        index.hashes([this](LineRef ref) { return hashText(view(ref)); }, out);
+    }
+
+    size_t internedLines() const {
+        return internHits;
+    }
+
+    // Selama di-pin, compact() ditunda: record tidak pernah ditimpa, jadi
+    // string_view yang diambil sebelumnya tetap valid (mis. dibaca worker
+    // yang sedang menyimpan file) walaupun baris terus diedit. clear()
+    // tetap membebaskan blok, jangan dipanggil selama di-pin.
+    void pin() {
+        pins++;
+    }
+
+    void unpin() {
+        pins--;
+    }
+
+    // Isi store saat snapshot() dipanggil, untuk dibaca thread lain (mis.
+    // worker yang menyimpan file) selagi store terus diedit. Teks dan ref
+    // tidak disalin: daun index dibagi copy-on-write (LineIndex::share) dan
+    // blok arena dibaca langsung, karena store di-pin sampai release().
+    // Blok yang dingin saat snapshot dibuat didekompres ke memori snapshot.
+    class Snapshot {
+    public:
+        size_t size() const {
+            return count;
+        }
+
+        // Semua baris berurutan; boleh dipanggil di thread mana saja
+        void lines(std::vector<std::string_view>& out) {
+            out.clear();
+            out.reserve(count);
+            for (const LineIndex::Leaf* leaf : leaves) {
+                for (uint16_t j = 0; j < leaf->n; ++j) {
+                    LineRef ref = leaf->refs[j];
+                    out.push_back(decode(block(ref.block) + ref.offset));
+                }
+            }
+        }
+
+    private:
+        friend class LineStore;
+
+        struct Block {
+            const char* data;   // nullptr = dingin, isinya di `packed`
+            const char* packed;
+            uint32_t packedSize;
+        };
+
+        std::vector<const LineIndex::Leaf*> leaves;
+        std::vector<Block> blocks;
+        std::vector<std::unique_ptr<char[]>> unpacked; // per blok dingin yang sudah dibaca
+        size_t count = 0;
+        bool released = false;
+
+        const char* block(uint32_t b) {
+            if (blocks[b].data) return blocks[b].data;
+            if (unpacked.empty()) unpacked.resize(blocks.size());
+            if (!unpacked[b]) {
+                unpacked[b].reset(new char[POOL_PAGE_SIZE]);
+                lzDecompress(blocks[b].packed, blocks[b].packedSize, unpacked[b].get(), POOL_PAGE_SIZE);
+            }
+            return unpacked[b].get();
+        }
+    };
+
+    // O(daun + blok), di thread pemilik store; pasangannya release()
+    std::shared_ptr<Snapshot> snapshot() {
+        auto snap = std::make_shared<Snapshot>();
+        pin();
+        index.share(snap->leaves);
+        snap->count = index.size();
+        snap->blocks.reserve(blocks.size());
+        for (size_t b = 0; b < blocks.size(); ++b)
+            snap->blocks.push_back({blocks[b], info[b].packed, info[b].packedSize});
+        return snap;
+    }
+
+    // Lepas daun yang dibagi dan pin snapshot, di thread pemilik store.
+    // string_view dari Snapshot::lines tidak valid lagi sesudahnya.
+    void release(Snapshot& snap) {
+        if (snap.released) return;
+        snap.released = true;
+        for (const LineIndex::Leaf* leaf : snap.leaves)
+            LineIndex::unshare(leaf);
+        snap.leaves.clear();
+        unpin();
+    }
+
+private:
+    static const size_t MIN_COMPACT_BYTES = 16 * POOL_PAGE_SIZE;
+    static const size_t INTERN_PROBE_LINES = 4096; // sampel sebelum menilai rasio duplikat
+
+    enum BlockKind : uint8_t {
+        BLOCK_POOL,     // halaman 64 KB dari PagePool
+        BLOCK_LARGE,    // blok heap khusus untuk baris > 64 KB
+        BLOCK_EXTERNAL  // blok di memori lain (adopt), hanya dibaca
+    };
+
+    // Keterangan per blok untuk cold storage
+    struct BlockInfo {
+        uint32_t used = 0;       // byte terisi
+        uint32_t packedSize = 0;
+        char* packed = nullptr;  // salinan LZ, nullptr jika belum dikompres
+        uint64_t lastUse = 0;    // waktu baca terakhir (useTick)
+    };
+
+    PagePool ownPool;
+    PagePool* pool;
+    LineIndex index;
+    mutable std::vector<char*> blocks; // nullptr = blok dingin, isinya hanya di info[i].packed
+    std::vector<uint8_t> blockKind;  // BlockKind
+    std::shared_ptr<const void> external; // penahan blok BLOCK_EXTERNAL
+    mutable std::vector<BlockInfo> info;
+    mutable uint64_t useTick = 0;
+    bool coldStorage = false;
+    std::string packBuffer;
+    size_t tailBlock = 0;
+    size_t tailUsed = POOL_PAGE_SIZE;
+    size_t written = 0;              // byte yang ditulis sejak compact terakhir
+    size_t compactAt = MIN_COMPACT_BYTES;
+    size_t pins = 0;
+
+    // Slot intern: bit 0-47 = (block << 16 | offset) + 1, bit 48-63 = tag hash
+    std::vector<uint64_t> internTable;
+    size_t internCount = 0; // record unik di tabel
+    size_t internHits = 0;  // baris yang memakai ulang record yang sudah ada
+
+    static size_t varintSize(size_t v) {
+        size_t n = 1;
+        while (v >= 0x80) {
+            v >>= 7;
+            n++;
+        }
+        return n;
+    }
+
+    static size_t largeSize(const char* block) {
+        uint64_t size;
+        memcpy(&size, block - sizeof(uint64_t), sizeof(uint64_t));
+        return (size_t)size;
+    }
+
+    static std::string_view decode(const char* p) {
+        size_t len = 0;
+        int shift = 0;
+        while (true) {
+            unsigned char b = (unsigned char)*p++;
+            len |= (size_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        return std::string_view(p, len);
+    }
+
+    void unpack(const BlockInfo& block, char* page) const {
+        lzDecompress(block.packed, block.packedSize, page, POOL_PAGE_SIZE);
+    }
+
+    std::string_view view(LineRef ref) const {
+        const char* block = blocks[ref.block];
+        if (coldStorage) {
+            if (!block) { // blok dingin: dekompres ke halaman baru
+                char* page = pool->allocPage();
+                unpack(info[ref.block], page);
+                blocks[ref.block] = page;
+                block = page;
+            }
+            info[ref.block].lastUse = ++useTick;
+        }
+        return decode(block + ref.offset);
+    }
+
+    static uint64_t hashText(std::string_view text) {
+        uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : text) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h ^ (h >> 29);
+    }
+
+    static void writeRecord(char* p, std::string_view text) {
+        size_t v = text.size();
+        while (v >= 0x80) {
+            *p++ = (char)(v | 0x80);
+            v >>= 7;
+        }
+        *p++ = (char)v;
+        memcpy(p, text.data(), text.size());
+    }
+
+    void freeBlocks(std::vector<char*>& list, std::vector<uint8_t>& kind, std::vector<BlockInfo>& meta) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (kind[i] == BLOCK_LARGE)
+                delete[] (list[i] - sizeof(uint64_t));
+            else if (kind[i] == BLOCK_POOL && list[i])
+                pool->freePage(list[i]);
+            delete[] meta[i].packed;
+        }
+        list.clear();
+        kind.clear();
+        meta.clear();
+    }
+
+    LineRef append(std::string_view text) {
+        size_t need = varintSize(text.size()) + text.size();
+        written += need;
+        if (need > POOL_PAGE_SIZE) {
+            // Baris raksasa dapat blok sendiri; ukurannya disimpan tepat sebelum blok
+            char* raw = new char[need + sizeof(uint64_t)];
+            uint64_t size = need;
+            memcpy(raw, &size, sizeof(uint64_t));
+            blocks.push_back(raw + sizeof(uint64_t));
+            blockKind.push_back(BLOCK_LARGE);
+            info.push_back(BlockInfo());
+            writeRecord(blocks.back(), text);
+            return LineRef{(uint32_t)(blocks.size() - 1), 0};
+        }
+        if (tailUsed + need > POOL_PAGE_SIZE) {
+            blocks.push_back(pool->allocPage());
+            blockKind.push_back(BLOCK_POOL);
+            info.push_back(BlockInfo());
+            tailBlock = blocks.size() - 1;
+            tailUsed = 0;
+        }
+        LineRef ref{(uint32_t)tailBlock, (uint16_t)tailUsed};
+        writeRecord(blocks[tailBlock] + tailUsed, text);
+        tailUsed += need;
+        info[tailBlock].used = (uint32_t)tailUsed;
+        return ref;
+    }
+
+    LineRef store(std::string_view text) {
+        if (!internLines || text.size() > INTERN_MAX_LEN)
+            return append(text);
+        if (internCount >= INTERN_PROBE_LINES && internHits * 4 < internCount) {
+            // Duplikat < 20%: tabel intern lebih mahal dari yang dihemat
+            internLines = false;
+            std::vector<uint64_t>().swap(internTable);
+            return append(text);
+        }
+
+        if (internCount * 4 >= internTable.size() * 3)
+            growIntern();
+        uint64_t h = hashText(text);
+        uint64_t tag = h >> 48;
+        size_t mask = internTable.size() - 1;
+        for (size_t i = (size_t)h & mask;; i = (i + 1) & mask) {
+            uint64_t slot = internTable[i];
+            if (slot == 0) {
+                LineRef ref = append(text);
+                internTable[i] = (tag << 48) | (((uint64_t)ref.block << 16 | ref.offset) + 1);
+                internCount++;
+                return ref;
+            }
+            if ((slot >> 48) == tag) {
+                uint64_t packed = (slot & 0xffffffffffffull) - 1;
+                LineRef ref{(uint32_t)(packed >> 16), (uint16_t)(packed & 0xffff)};
+                if (view(ref) == text) {
+                    internHits++;
+                    return ref;
+                }
+            }
+        }
+    }
+
+    void growIntern() {
+        std::vector<uint64_t> old;
+        old.swap(internTable);
+        internTable.assign(old.empty() ? 1024 : old.size() * 2, 0);
+        size_t mask = internTable.size() - 1;
+        for (uint64_t slot : old) {
+            if (slot == 0) continue;
+            uint64_t packed = (slot & 0xffffffffffffull) - 1;
+            LineRef ref{(uint32_t)(packed >> 16), (uint16_t)(packed & 0xffff)};
+            uint64_t h = hashText(view(ref));
+            size_t i = (size_t)h & mask;
+            while (internTable[i] != 0)
+                i = (i + 1) & mask;
+            internTable[i] = slot;
+        }
+    }
+
+    void maybeCompact() {
+        if (written >= compactAt)
+            compact();
+    }
+};
+
+#endif
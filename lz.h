@@ -0,0 +1,192 @@
+#ifndef LZ_H
+#define LZ_H
+
+// Kompresi LZ77 cepat untuk blok <= 64 KB (format mirip blok LZ4, tanpa
+// dependensi). Dipakai untuk menyimpan blok baris yang dingin.
+//
+// Isi hasil kompresi adalah deretan sequence:
+//   [token][panjang literal tambahan][literal][offset u16][panjang match tambahan]
+// Token: 4 bit atas = panjang literal, 4 bit bawah = panjang match - 4.
+// Nilai 15 berarti panjang dilanjutkan byte berikutnya (255 = lanjut lagi).
+// Sequence terakhir hanya berisi literal (tanpa offset).
+//
+// Pencarian match memakai tabel hash 16384 entri berisi posisi terakhir
+// setiap 4 byte, dan rantai `prev` per posisi ke kemunculan sebelumnya
+// dengan hash yang sama. Rantai ditelusuri paling banyak MAX_CHAIN langkah
+// dan match terpanjang dipakai: baris log yang mirip tapi tidak identik
+// sering punya match lebih panjang beberapa baris ke belakang. Format
+// keluaran tidak berubah, jadi dekompresi tetap hanya memcpy.
+//
+// Dengan `lazy`, match di posisi berikutnya dicari dulu sebelum match yang
+// ditemukan dipakai; kalau lebih panjang, satu byte jadi literal dan match
+// itu yang diambil. Hasilnya ~2.5% lebih kecil untuk log dengan ~1.4x waktu
+// kompresi, jadi hanya dipakai untuk blok dingin yang dikompres sekali.
+
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+const size_t LZ_MAX_INPUT = 64 * 1024;
+
+namespace lzdetail {
+
+const int HASH_BITS = 14;
+const size_t MIN_MATCH = 4;
+const int MAX_CHAIN = 8;
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+inline void putLength(std::string& out, size_t n) {
+    while (n >= 255) {
+        out += (char)255;
+        n -= 255;
+    }
+    out += (char)n;
+}
+
+// Panjang tambahan (setelah nilai 15 di token); false jika input habis
+inline bool getLength(const unsigned char*& p, const unsigned char* end, size_t& n) {
+    unsigned char b;
+    do {
+        if (p >= end) return false;
+        b = *p++;
+        n += b;
+    } while (b == 255);
+    return true;
+}
+
+inline void putSequence(std::string& out, const unsigned char* literals, size_t literalLen,
+                        size_t offset, size_t matchLen) {
+    size_t m = matchLen ? matchLen - MIN_MATCH : 0;
+    out += (char)((std::min<size_t>(literalLen, 15) << 4) | std::min<size_t>(m, 15));
+    if (literalLen >= 15) putLength(out, literalLen - 15);
+    out.append((const char*)literals, literalLen);
+    if (!matchLen) return;
+    out += (char)(offset & 0xff);
+    out += (char)(offset >> 8);
+    if (m >= 15) putLength(out, m - 15);
+}
+
+} // namespace lzdetail
+
+// Kompres n byte (n <= LZ_MAX_INPUT) ke `out` (ditimpa)
+inline void lzCompress(const char* data, size_t n, std::string& out, bool lazy = false) {
+    using namespace lzdetail;
+    out.clear();
+    out.reserve(n / 2 + 16);
+    const unsigned char* src = (const unsigned char*)data;
+    // Per thread (trimHot di thread utama, spill undo di thread writer);
+    // prev tidak perlu dikosongkan karena hanya dibaca lewat posisi yang
+    // sudah dimasukkan
+    thread_local uint16_t table[1 << HASH_BITS];
+    thread_local uint16_t prev[LZ_MAX_INPUT];
+    memset(table, 0, sizeof(table));
+    size_t anchor = 0;   // awal literal yang belum ditulis
+    size_t i = 1;        // posisi 0 tidak pernah jadi kandidat (0 = kosong)
+    size_t inserted = 1; // posisi berikutnya yang belum masuk tabel
+    auto insert = [&](size_t p) {
+        uint32_t h = hash4(read32(src + p));
+        prev[p] = table[h];
+        table[h] = (uint16_t)p;
+    };
+    // Match terpanjang di `at` dari posisi yang sudah masuk tabel
+    auto longest = [&](size_t at, size_t& candidate) {
+        uint32_t v = read32(src + at);
+        size_t len = 0;
+        size_t c = table[hash4(v)];
+        for (int step = 0; step < MAX_CHAIN && c != 0 && at + len < n; ++step) {
+            // Byte di src[at + len] harus sama dulu agar match ini bisa lebih panjang
+            if ((!len || src[c + len] == src[at + len]) && read32(src + c) == v) {
+                size_t l = MIN_MATCH;
+                while (at + l < n && src[c + l] == src[at + l])
+                    l++;
+                if (l > len) {
+                    len = l;
+                    candidate = c;
+                }
+            }
+            c = prev[c]; // 0 = ujung rantai
+        }
+        return len;
+    };
+    while (i + MIN_MATCH <= n) {
+        for (; inserted < i; ++inserted)
+            insert(inserted);
+        size_t candidate = 0;
+        size_t len = longest(i, candidate);
+        insert(i);
+        inserted = i + 1;
+        if (!len) {
+            i += 1 + ((i - anchor) >> 6); // data acak: lompat makin jauh
+            continue;
+        }
+        while (lazy && i + 1 + MIN_MATCH <= n) {
+            size_t next = 0;
+            size_t nextLen = longest(i + 1, next);
+            insert(i + 1);
+            inserted = i + 2;
+            if (nextLen <= len) break;
+            i++;
+            len = nextLen;
+            candidate = next;
+        }
+        // Perpanjang ke belakang selama byte sebelumnya juga sama
+        while (i > anchor && candidate > 0 && src[i - 1] == src[candidate - 1]) {
+            i--;
+            candidate--;
+            len++;
+        }
+        putSequence(out, src + anchor, i - anchor, i - candidate, len);
+        i += len;
+        anchor = i;
+    }
+    putSequence(out, src + anchor, n - anchor, 0, 0);
+}
+
+// Dekompres ke dst (kapasitas cap); kembalikan jumlah byte, atau -1 jika
+// data rusak
+inline long lzDecompress(const char* data, size_t n, char* dst, size_t cap) {
+    using namespace lzdetail;
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* end = p + n;
+    unsigned char* out = (unsigned char*)dst;
+    size_t pos = 0;
+    while (p < end) {
+        unsigned char token = *p++;
+        size_t literalLen = token >> 4;
+        if (literalLen == 15 && !getLength(p, end, literalLen)) return -1;
+        if (literalLen > (size_t)(end - p) || literalLen > cap - pos) return -1;
+        memcpy(out + pos, p, literalLen);
+        p += literalLen;
+        pos += literalLen;
+        if (p == end) break; // sequence terakhir: hanya literal
+        if (end - p < 2) return -1;
+        size_t offset = p[0] | (p[1] << 8);
+        p += 2;
+        size_t matchLen = (token & 15);
+        if (matchLen == 15 && !getLength(p, end, matchLen)) return -1;
+        matchLen += MIN_MATCH;
+        if (offset == 0 || offset > pos || matchLen > cap - pos) return -1;
+        unsigned char* to = out + pos;
+        const unsigned char* from = to - offset;
+        if (offset >= matchLen) {
+            memcpy(to, from, matchLen);
+        } else {
+            for (size_t k = 0; k < matchLen; ++k) // match tumpang tindih (pola berulang)
+                to[k] = from[k];
+        }
+        pos += matchLen;
+    }
+    return (long)pos;
+}
+
+#endif
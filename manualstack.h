@@ -0,0 +1,491 @@
+#ifndef MANUALSTACK_H
+#define MANUALSTACK_H
+
+// Stack untuk riwayat undo/redo, disimpan sebagai ring buffer: entri
+// terlama di `head`, entri teratas di head + count - 1 (modulo jumlah slot).
+//
+// Ring mulai dari STACK_MIN_SLOTS dan slotnya digandakan seperti vector
+// saat penuh (push O(1) amortized), jadi dokumen yang riwayatnya pendek
+// hanya memakai ring kecil. Dengan setBudget(bytes) penggandaan berhenti di
+// budget / STACK_SLOT_BYTES slot. Begitu slot itu penuh atau byte entri
+// (StackTraits<T>::bytes) melebihi budget, entri terlama dikeluarkan dari
+// ring:
+//  - tipe yang bisa di-serialize (StackTraits<T>::spillable) di-encode ke
+//    batch STACK_SPILL_BATCH byte; batch yang penuh diserahkan ke thread
+//    `writer` yang mengompres (LZ) dan menulisnya ke file spill anonim,
+//    jadi push tidak pernah menunggu kompresi atau pwrite(). Saat ring habis
+//    di-pop, batch terbaru dibaca kembali (di situ pop boleh menunggu
+//    writer dan membaca file)
+//  - tipe lain dibuang, undo tidak bisa mundur sejauh itu lagi
+// Entri yang di-spill selalu lebih tua dari semua entri di ring. Batch yang
+// gagal ditulis tetap di antrean memori; spill berikutnya lalu membuang
+// semua entri yang lebih tua supaya riwayat tidak bolong di tengah. Begitu
+// juga kalau file spill gagal dibaca. Entri yang dibuang (juga oleh clear()
+// dan release()) diserahkan ke `onDrop`, supaya sumber daya milik entri
+// (mis. node WordList) bisa dikembalikan.
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+#include "lz.h"
+
+// Ukuran entri (termasuk sizeof(T)) untuk budget, dan serialisasi untuk
+// spill. Bawaan: sizeof(T), tidak bisa di-spill. Spesialisasi yang
+// spillable menyediakan juga
+//   static void encode(std::string& out, const T& value)
+//   static bool decode(const char*& p, const char* end, T& value)
+template<typename T>
+struct StackTraits {
+    static const bool spillable = false;
+
+    static size_t bytes(const T&) {
+        return sizeof(T);
+    }
+};
+
+const size_t STACK_MIN_SLOTS = 64;
+const size_t STACK_SLOT_BYTES = 128; // perkiraan byte per entri untuk jumlah slot ber-budget
+const size_t STACK_SPILL_BATCH = 32 * 1024;
+
+// Manual stack class
+template<typename T>
+class ManualStack {
+private:
+    using Traits = StackTraits<T>;
+
+    struct SpillBatch {
+        off_t offset;
+        uint32_t packedSize; // sama dengan rawSize: disimpan tanpa kompresi
+        uint32_t rawSize;
+        uint32_t count;
+    };
+
+    struct QueuedBatch {
+        std::string raw;
+        size_t count;
+    };
+
+    std::vector<T> ring;  // ukurannya selalu pangkat dua (atau kosong)
+    size_t head = 0;
+    size_t count = 0;
+    size_t bytes = 0;     // StackTraits<T>::bytes semua entri di ring
+    size_t budget = 0;    // 0 = tanpa batas
+    size_t maxSlots = 0;  // batas ring.size() dari budget, 0 = tanpa batas
+    T missing;            // dikembalikan top() kalau tidak ada entri sama sekali
+
+    // Entri yang sudah keluar dari ring, terlama dulu: batch di file spill,
+    // batch di `queued` (belum ditulis writer), lalu `pending` (batch
+    // terbaru yang belum penuh). `batches`, `queued`, `spillEnd` dan `busy`
+    // dijaga `mutex`; pending dan hitungan entri hanya dipakai thread pemilik.
+    std::vector<SpillBatch> batches;
+    std::deque<QueuedBatch> queued;
+    std::string pending;
+    size_t pendingCount = 0;
+    size_t spilledCount = 0;
+    int spillFd = -1;     // -2 = gagal dibuat, entri lama dibuang
+    off_t spillEnd = 0;
+
+    std::thread writer;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    mutable std::condition_variable idle;
+    bool busy = false;    // writer sedang menulis batch yang sudah keluar dari `queued`
+    bool stopping = false;
+    std::atomic<bool> writeFailed{false}; // batch terdepan di `queued` gagal ditulis
+
+    T& slot(size_t i) {
+        return ring[(head + i) & (ring.size() - 1)];
+    }
+
+    const T& slot(size_t i) const {
+        return ring[(head + i) & (ring.size() - 1)];
+    }
+
+    // Pindahkan entri ke ring baru berukuran `slots` (>= count)
+    void relayout(size_t slots) {
+        std::vector<T> next(slots);
+        for (size_t i = 0; i < count; ++i)
+            next[i] = std::move(slot(i));
+        ring.swap(next);
+        head = 0;
+    }
+
+    void evictOldest() {
+        T& oldest = ring[head];
+        bytes -= Traits::bytes(oldest);
+        spillEntry(oldest);
+        oldest = T();
+        head = (head + 1) & (ring.size() - 1);
+        count--;
+    }
+
+    void trim() {
+        while (budget && bytes > budget && count > 1)
+            evictOldest();
+    }
+
+    int spillHandle() {
+        if (spillFd == -1) {
+            char path[] = "/tmp/editor-undo-XXXXXX";
+            spillFd = mkstemp(path);
+            if (spillFd >= 0)
+                unlink(path);
+            else
+                spillFd = -2;
+        }
+        return spillFd;
+    }
+
+    void spillEntry(const T& value) {
+        if constexpr (Traits::spillable) {
+            if (writeFailed)
+                dropSpill();
+            if (spillHandle() >= 0) {
+                if (pending.capacity() < STACK_SPILL_BATCH)
+                    pending.reserve(STACK_SPILL_BATCH + STACK_SLOT_BYTES);
+                Traits::encode(pending, value);
+                pendingCount++;
+                spilledCount++;
+                if (pending.size() >= STACK_SPILL_BATCH)
+                    queuePending();
+                return;
+            }
+        }
+        if (onDrop) onDrop(value);
+        dropSpill(); // entri lebih tua dari yang dibuang tidak berguna lagi
+    }
+
+    // Serahkan `pending` yang penuh ke writer (dijalankan saat pertama dipakai)
+    void queuePending() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued.push_back(QueuedBatch{std::move(pending), pendingCount});
+            if (!writer.joinable())
+                writer = std::thread(&ManualStack::writeLoop, this);
+        }
+        wake.notify_one();
+        pending = std::string();
+        pendingCount = 0;
+    }
+
+    void writeLoop() {
+        std::string packed;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return stopping || (!queued.empty() && !writeFailed); });
+            if (stopping) break;
+            QueuedBatch item = std::move(queued.front());
+            queued.pop_front();
+            busy = true;
+            SpillBatch batch;
+            batch.offset = spillEnd;
+            lock.unlock();
+            bool ok = writeBatch(item.raw, packed, batch);
+            batch.count = (uint32_t)item.count;
+            lock.lock();
+            busy = false;
+            if (ok) {
+                spillEnd = batch.offset + (off_t)batch.packedSize;
+                batches.push_back(batch);
+            } else {
+                // Tetap di memori (urutannya paling tua di antrean); pemilik
+                // membuangnya bersama entri yang lebih tua di spill berikutnya
+                queued.push_front(std::move(item));
+                writeFailed = true;
+            }
+            idle.notify_all();
+        }
+    }
+
+    bool writeBatch(const std::string& raw, std::string& packed, SpillBatch& batch) const {
+        const std::string* data = &raw;
+        if (raw.size() <= LZ_MAX_INPUT) {
+            lzCompress(raw.data(), raw.size(), packed);
+            if (packed.size() < raw.size())
+                data = &packed;
+        }
+        batch.packedSize = (uint32_t)data->size();
+        batch.rawSize = (uint32_t)raw.size();
+        return pwrite(spillFd, data->data(), data->size(), batch.offset) == (ssize_t)data->size();
+    }
+
+    void stopWriter() {
+        if (!writer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    bool readBatch(const SpillBatch& batch, std::string& raw) const {
+        std::string packed(batch.packedSize, '\0');
+        if (pread(spillFd, &packed[0], packed.size(), batch.offset) != (ssize_t)packed.size())
+            return false;
+        if (batch.packedSize == batch.rawSize) {
+            raw.swap(packed);
+            return true;
+        }
+        raw.resize(batch.rawSize);
+        return lzDecompress(packed.data(), packed.size(), &raw[0], raw.size()) == (long)batch.rawSize;
+    }
+
+    template<typename F>
+    static void decodeAll(const std::string& raw, size_t n, F f) {
+        const char* p = raw.data();
+        const char* end = p + raw.size();
+        for (size_t i = 0; i < n; ++i) {
+            T value;
+            if (!Traits::decode(p, end, value)) break;
+            f(std::move(value));
+        }
+    }
+
+    // Ring kosong: muat kembali entri spill terbaru (pending, atau batch
+    // terakhir di file). Entri yang tidak muat di ring dikembalikan ke pending.
+    bool refill() {
+        if constexpr (Traits::spillable) {
+            if (spilledCount == 0) return false;
+            std::string raw;
+            size_t n;
+            if (pendingCount) {
+                raw.swap(pending);
+                n = pendingCount;
+                pendingCount = 0;
+            } else {
+                // Batch terbaru masih di antrean, atau sedang/sudah ditulis
+                std::unique_lock<std::mutex> lock(mutex);
+                idle.wait(lock, [&] { return !busy || !queued.empty(); });
+                if (!queued.empty()) {
+                    raw.swap(queued.back().raw);
+                    n = queued.back().count;
+                    queued.pop_back();
+                    if (queued.empty())
+                        writeFailed = false; // batch yang gagal sudah kembali ke ring
+                } else {
+                    SpillBatch batch = batches.back();
+                    batches.pop_back();
+                    spillEnd = batch.offset;
+                    n = batch.count;
+                    lock.unlock();
+                    if (!readBatch(batch, raw)) {
+                        dropSpill();
+                        return false;
+                    }
+                }
+            }
+            spilledCount -= n;
+            std::vector<T> values;
+            values.reserve(n);
+            decodeAll(raw, n, [&](T&& value) { values.push_back(std::move(value)); });
+            // Ring (kosong) diperbesar sampai batch muat atau sampai maxSlots
+            size_t slots = std::max(STACK_MIN_SLOTS, ring.size());
+            while (slots < values.size() && (!maxSlots || slots < maxSlots))
+                slots *= 2;
+            if (slots != ring.size())
+                relayout(slots);
+            size_t keep = std::min(values.size(), ring.size());
+            size_t back = values.size() - keep;
+            for (size_t i = 0; i < back; ++i)
+                Traits::encode(pending, values[i]);
+            pendingCount = back;
+            spilledCount += back;
+            head = 0;
+            for (size_t i = back; i < values.size(); ++i) {
+                bytes += Traits::bytes(values[i]);
+                ring[count++] = std::move(values[i]);
+            }
+            return count > 0;
+        }
+        return false;
+    }
+
+    void dropSpill() {
+        if (spilledCount == 0 && !writeFailed) {
+            std::string().swap(pending);
+            pendingCount = 0;
+            return;
+        }
+        spilledCount = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        std::deque<QueuedBatch> dropped;
+        dropped.swap(queued); // writer tidak mengambil batch baru lagi
+        idle.wait(lock, [&] { return !busy; });
+        if constexpr (Traits::spillable) {
+            if (onDrop) {
+                // Batch yang baru gagal ditulis kembali ke `queued` selama ditunggu
+                for (QueuedBatch& batch : queued)
+                    dropped.push_back(std::move(batch));
+                auto drop = [&](T&& value) { onDrop(value); };
+                std::string raw;
+                for (const SpillBatch& batch : batches)
+                    if (readBatch(batch, raw)) decodeAll(raw, batch.count, drop);
+                for (const QueuedBatch& batch : dropped)
+                    decodeAll(batch.raw, batch.count, drop);
+                decodeAll(pending, pendingCount, drop);
+            }
+        }
+        queued.clear();
+        std::string().swap(pending);
+        pendingCount = 0;
+        batches.clear();
+        writeFailed = false;
+        if (spillEnd > 0 && ftruncate(spillFd, 0) == 0)
+            spillEnd = 0;
+    }
+
+public:
+    // Dipanggil di thread pemilik untuk setiap entri yang dibuang tanpa
+    // di-pop; kosong = entri dibuang begitu saja
+    std::function<void(const T&)> onDrop;
+
+    ManualStack() = default;
+    ManualStack(const ManualStack&) = delete;
+    ManualStack& operator=(const ManualStack&) = delete;
+
+    ~ManualStack() {
+        stopWriter();
+        if (spillFd >= 0)
+            ::close(spillFd);
+    }
+
+    // Batasi byte entri yang tinggal di memori (0 = tanpa batas). `slots`:
+    // batas jumlah slot ring (dibulatkan ke pangkat dua), 0 = dari budget.
+    // Ring tidak dialokasikan di sini; push menggandakannya sampai batas itu.
+    void setBudget(size_t maxBytes, size_t slots = 0) {
+        budget = maxBytes;
+        if (budget == 0) {
+            maxSlots = 0;
+            return;
+        }
+        size_t limit = slots ? slots : budget / STACK_SLOT_BYTES;
+        maxSlots = STACK_MIN_SLOTS;
+        while (maxSlots * 2 <= limit)
+            maxSlots *= 2;
+        while (count > maxSlots)
+            evictOldest();
+        if (ring.size() > maxSlots)
+            relayout(maxSlots);
+        trim();
+    }
+
+    void push(const T& value) {
+        push(T(value));
+    }
+
+    void push(T&& value) {
+        if (count == ring.size()) {
+            if (maxSlots && ring.size() >= maxSlots)
+                evictOldest();
+            else
+                relayout(std::max(STACK_MIN_SLOTS, ring.size() * 2));
+        }
+        count++;
+        T& top = slot(count - 1);
+        top = std::move(value);
+        bytes += Traits::bytes(top);
+        trim();
+    }
+
+    void pop() {
+        if (count == 0 && !refill()) return;
+        T& top = slot(count - 1);
+        bytes -= Traits::bytes(top);
+        top = T();
+        count--;
+    }
+
+    // Stack kosong (atau file spill gagal dibaca): entri kosong T()
+    T& top() {
+        if (count == 0 && !refill()) {
+            missing = T();
+            return missing;
+        }
+        return slot(count - 1);
+    }
+
+    bool empty() const {
+        return count == 0 && spilledCount == 0;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < count; ++i) {
+            if (onDrop) onDrop(slot(i));
+            slot(i) = T();
+        }
+        head = 0;
+        count = 0;
+        bytes = 0;
+        dropSpill();
+    }
+
+    // Jumlah entri, termasuk yang di-spill
+    size_t size() const {
+        return count + spilledCount;
+    }
+
+    size_t spilled() const {
+        return spilledCount;
+    }
+
+    // Tunggu writer menulis semua batch di antrean (atau gagal menulis)
+    void waitForWriter() const {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [&] { return !busy && (queued.empty() || writeFailed); });
+    }
+
+    // Kunjungi semua entri dari yang terlama; entri spill dibaca sementara
+    template<typename F>
+    void forEach(F f) const {
+        if constexpr (Traits::spillable) {
+            std::string raw;
+            std::unique_lock<std::mutex> lock(mutex);
+            idle.wait(lock, [&] { return !busy; });
+            for (const SpillBatch& batch : batches) {
+                if (readBatch(batch, raw))
+                    decodeAll(raw, batch.count, [&](T&& value) { f((const T&)value); });
+            }
+            for (const QueuedBatch& batch : queued)
+                decodeAll(batch.raw, batch.count, [&](T&& value) { f((const T&)value); });
+            lock.unlock();
+            decodeAll(pending, pendingCount, [&](T&& value) { f((const T&)value); });
+        }
+        for (size_t i = 0; i < count; ++i)
+            f(slot(i));
+    }
+
+    size_t memoryBytes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t waiting = 0;
+        for (const QueuedBatch& batch : queued)
+            waiting += batch.raw.capacity();
+        return (ring.size() - count) * sizeof(T) + bytes + pending.capacity() + waiting +
+               batches.capacity() * sizeof(SpillBatch);
+    }
+
+    // Seperti clear(), tapi slot ring ikut dikembalikan; push berikutnya
+    // mengalokasikan ring lagi
+    void release() {
+        if (onDrop)
+            for (size_t i = 0; i < count; ++i)
+                onDrop(slot(i));
+        std::vector<T>().swap(ring);
+        head = 0;
+        count = 0;
+        bytes = 0;
+        dropSpill();
+    }
+};
+
+#endif
@@ -0,0 +1,338 @@
+#ifndef NATIVE_H
+#define NATIVE_H
+
+// Format dokumen native (.pkd): teks, atribut format (format.h) dan kalau
+// diminta riwayat undo dalam satu file, supaya bold/italic/underline tidak
+// hilang saat disimpan.
+//
+// Blob teks disusun persis seperti arena LineStore: blok sampai 64 KB berisi
+// record [varint len][bytes], baris > 64 KB di blok sendiri yang didahului
+// u64 ukurannya. Index baris berisi LineRef (nomor blok + offset) dan
+// statistik tiap LineIndex::LEAF_MAX baris ikut disimpan, jadi membuka file
+// cukup mmap, mengubah tabel blok jadi pointer, lalu menyalin ref ke daun
+// B+tree. Blob teks tidak dibaca sama sekali saat membuka; halamannya dimuat
+// kernel saat barisnya ditampilkan atau diedit.
+//
+// Layout (little-endian, setiap bagian mulai di offset kelipatan 8):
+//   NativeHeader
+//   index baris    LineRef[lineCount]
+//   statistik      LineStats[ceil(lineCount / leafLines)]
+//   tabel blok     NativeBlock[blockCount]
+//   blob teks
+//   atribut        FormatSpans::encode (run-length per baris berformat)
+//   riwayat undo   layout Document::packHistory, kosong = tidak disimpan
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "linestore.h"
+#include "export.h"
+
+const char NATIVE_MAGIC[8] = {'P', 'K', 'D', 'O', 'C', '\r', '\n', '\x1a'};
+const uint32_t NATIVE_VERSION = 1;
+
+struct NativeHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t leafLines;    // LEAF_MAX saat ditulis; beda = statistik dihitung ulang
+    uint64_t lineCount;
+    uint64_t blockCount;
+    uint64_t indexOffset;
+    uint64_t statsOffset;
+    uint64_t blocksOffset;
+    uint64_t textOffset;
+    uint64_t attrOffset;
+    uint64_t attrBytes;
+    uint64_t historyOffset;
+    uint64_t historyBytes;
+    uint64_t fileBytes;    // ukuran file utuh, untuk mengenali file terpotong
+};
+
+struct NativeBlock {
+    uint64_t offset;       // dari awal file
+    uint32_t used;         // byte record di blok
+    uint32_t large;        // 1 = satu baris > 64 KB, u64 ukurannya tepat sebelum blok
+};
+
+static_assert(sizeof(LineRef) == 6, "index baris native memakai LineRef 6 byte");
+static_assert(sizeof(LineStats) == 24, "statistik native memakai 3 x u64");
+
+// Dokumen baru dengan ekstensi ini disimpan dalam format native; file yang
+// sudah ada dikenali dari magic-nya, apa pun ekstensinya
+inline bool isNativePath(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    return dot != std::string::npos && path.compare(dot, std::string::npos, ".pkd") == 0;
+}
+
+inline void nativeAlign(ChunkWriter& out) {
+    static const char zeros[8] = {};
+    out.append(zeros, (8 - out.bytesWritten() % 8) % 8);
+}
+
+inline size_t nativeVarint(char* out, size_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (char)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (char)v;
+    return n;
+}
+
+// Tulis dokumen ke `target` lewat file sementara + rename, jadi mapping
+// file lama (yang mungkin masih dipakai LineStore) tidak pernah terpotong.
+// `attrs` = FormatSpans::encode, `history` boleh kosong.
+inline bool writeNative(const std::string& target, const std::vector<std::string_view>& lines,
+                        const std::string& attrs, const std::string& history) {
+    std::string temp = target + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    NativeHeader header = {};
+    memcpy(header.magic, NATIVE_MAGIC, sizeof(NATIVE_MAGIC));
+    header.version = NATIVE_VERSION;
+    header.leafLines = LineIndex::LEAF_MAX;
+    header.lineCount = lines.size();
+    bool ok;
+    {
+        ChunkWriter out(fd);
+        out.append(std::string(sizeof(NativeHeader), '\0')); // header ditulis terakhir
+
+        // Lintasan 1: bagi record ke blok dengan aturan LineStore::append,
+        // tulis ref; blok di file bersambung tanpa celah, jadi offset blok
+        // cukup dihitung dari panjang record
+        header.indexOffset = out.bytesWritten();
+        std::vector<NativeBlock> blocks;
+        std::vector<LineStats> groups;
+        uint64_t text = 0;
+        size_t tailUsed = POOL_PAGE_SIZE;
+        char varint[10];
+        for (size_t i = 0; i < lines.size(); ++i) {
+            size_t need = nativeVarint(varint, lines[i].size()) + lines[i].size();
+            LineRef ref;
+            if (need > POOL_PAGE_SIZE) {
+                text += sizeof(uint64_t);
+                blocks.push_back({text, (uint32_t)need, 1});
+                ref = LineRef{(uint32_t)(blocks.size() - 1), 0};
+                tailUsed = POOL_PAGE_SIZE; // baris berikutnya mulai di blok baru
+            } else {
+                if (tailUsed + need > POOL_PAGE_SIZE) {
+                    blocks.push_back({text, 0, 0});
+                    tailUsed = 0;
+                }
+                ref = LineRef{(uint32_t)(blocks.size() - 1), (uint16_t)tailUsed};
+                tailUsed += need;
+                blocks.back().used = (uint32_t)tailUsed;
+            }
+            text += need;
+            out.append(reinterpret_cast<const char*>(&ref), sizeof(ref));
+            if (i % LineIndex::LEAF_MAX == 0) groups.emplace_back();
+            groups.back() += LineStats::of(lines[i]);
+        }
+        nativeAlign(out);
+        header.statsOffset = out.bytesWritten();
+        out.append(reinterpret_cast<const char*>(groups.data()), groups.size() * sizeof(LineStats));
+        nativeAlign(out);
+        header.blocksOffset = out.bytesWritten();
+        header.blockCount = blocks.size();
+        header.textOffset = header.blocksOffset + blocks.size() * sizeof(NativeBlock);
+        for (NativeBlock& b : blocks)
+            b.offset += header.textOffset;
+        out.append(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(NativeBlock));
+
+        // Lintasan 2: record berurutan, baris besar didahului ukurannya
+        for (std::string_view line : lines) {
+            size_t n = nativeVarint(varint, line.size());
+            if (n + line.size() > POOL_PAGE_SIZE) {
+                uint64_t size = n + line.size();
+                out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            }
+            out.append(varint, n);
+            out.append(line);
+        }
+        nativeAlign(out);
+        header.attrOffset = out.bytesWritten();
+        header.attrBytes = attrs.size();
+        out.append(attrs);
+        nativeAlign(out);
+        header.historyOffset = out.bytesWritten();
+        header.historyBytes = history.size();
+        out.append(history);
+        header.fileBytes = out.bytesWritten();
+        ok = out.flush();
+    }
+    ok = ok && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+    ok = fsync(fd) == 0 && ok;
+    ok = ::close(fd) == 0 && ok;
+    if (ok && rename(temp.c_str(), target.c_str()) == 0)
+        return true;
+    unlink(temp.c_str());
+    return false;
+}
+
+// File native yang di-mmap. open() hanya memeriksa header, batas bagian dan
+// index baris; teks dibaca saat diminta.
+class NativeFile {
+public:
+    // true kalau `path` file native yang utuh. File yang diawali magic tapi
+    // rusak atau terpotong membuat corrupt() true.
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        char magic[sizeof(NATIVE_MAGIC)];
+        if (fstat(fd, &st) != 0 || pread(fd, magic, sizeof(magic), 0) != (ssize_t)sizeof(magic) ||
+            memcmp(magic, NATIVE_MAGIC, sizeof(magic)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        broken = true;
+        size_t size = (size_t)st.st_size;
+        void* base = size >= sizeof(NativeHeader) ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (base == MAP_FAILED) return false;
+        map = std::make_shared<Mapping>(base, size);
+        if (!validate()) {
+            close();
+            return false;
+        }
+        broken = false;
+        return true;
+    }
+
+    void close() {
+        map.reset();
+        header = nullptr;
+        blocks.clear();
+        broken = false;
+    }
+
+    bool corrupt() const {
+        return broken;
+    }
+
+    // false: belum dibuka, gagal dibuka atau bukan file native; semua
+    // accessor di bawah lalu mengembalikan isi kosong
+    bool isOpen() const {
+        return header != nullptr;
+    }
+
+    size_t lineCount() const {
+        return header ? (size_t)header->lineCount : 0;
+    }
+
+    std::string_view line(size_t i) const {
+        if (!header || i >= header->lineCount) return {};
+        LineRef ref;
+        memcpy(&ref, base() + header->indexOffset + i * sizeof(LineRef), sizeof(ref));
+        const char* p = blocks[ref.block] + ref.offset;
+        size_t len = 0;
+        int shift = 0;
+        while (true) {
+            unsigned char b = (unsigned char)*p++;
+            len |= (size_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        return std::string_view(p, len);
+    }
+
+    std::string_view attrs() const {
+        if (!header) return {};
+        return std::string_view(base() + header->attrOffset, header->attrBytes);
+    }
+
+    std::string_view history() const {
+        if (!header) return {};
+        return std::string_view(base() + header->historyOffset, header->historyBytes);
+    }
+
+    // Pasang seluruh baris ke `store` tanpa menyalin teks; mapping tetap
+    // hidup selama store masih memakai bloknya
+    void loadInto(LineStore& store) const {
+        if (!header) return;
+        const LineStats* stats = header->leafLines == LineIndex::LEAF_MAX
+            ? reinterpret_cast<const LineStats*>(base() + header->statsOffset) : nullptr;
+        store.adopt(map, blocks, reinterpret_cast<const LineRef*>(base() + header->indexOffset),
+                    (size_t)header->lineCount, stats);
+    }
+
+private:
+    struct Mapping {
+        void* base;
+        size_t size;
+        Mapping(void* b, size_t n) : base(b), size(n) {}
+        ~Mapping() {
+            munmap(base, size);
+        }
+    };
+
+    std::shared_ptr<Mapping> map;
+    const NativeHeader* header = nullptr;
+    std::vector<const char*> blocks; // tabel blok yang sudah jadi pointer
+    bool broken = false;
+
+    const char* base() const {
+        return static_cast<const char*>(map->base);
+    }
+
+    static bool within(uint64_t offset, uint64_t count, uint64_t unit, uint64_t size) {
+        return offset <= size && count <= (size - offset) / unit;
+    }
+
+    bool validate() {
+        size_t size = map->size;
+        const NativeHeader* h = reinterpret_cast<const NativeHeader*>(base());
+        if (h->version != NATIVE_VERSION || h->fileBytes != size || h->leafLines == 0 ||
+            !within(h->indexOffset, h->lineCount, sizeof(LineRef), size) ||
+            !within(h->statsOffset, (h->lineCount + h->leafLines - 1) / h->leafLines, sizeof(LineStats), size) ||
+            h->statsOffset % 8 != 0 || h->blocksOffset % 8 != 0 ||
+            !within(h->blocksOffset, h->blockCount, sizeof(NativeBlock), size) ||
+            !within(h->attrOffset, h->attrBytes, 1, size) || !within(h->historyOffset, h->historyBytes, 1, size) ||
+            h->textOffset > h->attrOffset)
+            return false;
+
+        // Fixup: tabel blok jadi pointer ke dalam mapping
+        const NativeBlock* table = reinterpret_cast<const NativeBlock*>(base() + h->blocksOffset);
+        std::vector<uint32_t> used(h->blockCount);
+        blocks.resize(h->blockCount);
+        for (size_t b = 0; b < h->blockCount; ++b) {
+            const NativeBlock& block = table[b];
+            if (block.offset < h->textOffset || block.offset > h->attrOffset ||
+                block.used > h->attrOffset - block.offset || (!block.large && block.used > POOL_PAGE_SIZE))
+                return false;
+            if (block.large) {
+                uint64_t stored;
+                memcpy(&stored, base() + block.offset - sizeof(uint64_t), sizeof(stored));
+                if (block.offset < h->textOffset + sizeof(uint64_t) || stored != block.used)
+                    return false;
+            }
+            blocks[b] = base() + block.offset;
+            used[b] = block.used;
+        }
+
+        // Index dibaca berurutan sekali di sini dan sekali lagi saat disalin
+        // ke B+tree; minta kernel membacanya lebih dulu
+        uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+        uintptr_t from = ((uintptr_t)base() + h->indexOffset) & ~(page - 1);
+        madvise((void*)from, (uintptr_t)base() + h->blocksOffset - from, MADV_WILLNEED);
+        const char* refs = base() + h->indexOffset;
+        for (size_t i = 0; i < h->lineCount; ++i) {
+            LineRef ref;
+            memcpy(&ref, refs + i * sizeof(LineRef), sizeof(ref));
+            if (ref.block >= h->blockCount || ref.offset >= used[ref.block])
+                return false;
+        }
+        header = h;
+        return true;
+    }
+};
+
+#endif
@@ -1,284 +1,740 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
 #include <fstream>
+#include <chrono>
+#include <memory>
 #include <termios.h>
 #include <unistd.h>
-#include <ctime>
+#include <csignal>
+#include <sys/ioctl.h>
+#include "terminal.h"
+#include "session.h"
+#include "input.h"
+#include "eventloop.h"
+#include "termout.h"
+#include "filewatch.h"
+#include "collab.h"
 
 using namespace std;
 
-// Manual stack class
-template<typename T>
-class ManualStack {
-private:
-    vector<T> data;
-public:
-    void push(const T& value) {
-        data.push_back(value);
+const string savedPath = "saved_text.txt";
+const int HEADER_ROWS = 26; // baris yang dipakai judul, daftar perintah dan tab dokumen
+const int BUDGET_CHECK_EDITS = 256; // RSS dicek ulang setiap sekian edit
+const int STATUS_MS = 3000;         // lama pesan status ditampilkan
+const int COOL_STEP_MS = 1;         // jeda antar batch kompresi blok dingin
+
+enum TimerId {
+    TIMER_JOURNAL = 1, // group commit journal
+    TIMER_IDLE,        // padatkan / spill dokumen idle
+    TIMER_ESC,         // ESC sendirian atau sequence terputus
+    TIMER_STATUS,      // pesan status kedaluwarsa
+    TIMER_AUTOSAVE,
+    TIMER_COOL         // kompres blok baris yang dingin
+};
+
+Session session;
+EventLoop loop;
+TermWriter screen;
+InputDecoder decoder;
+FileWatch fileWatch; // file yang dibuka dari disk, untuk append/reload dari luar
+string statusMessage;
+bool redrawPending = false;
+bool exiting = false;
+bool terminated = false; // keluar karena SIGTERM/SIGHUP/SIGINT
+int editsSinceBudgetCheck = 0;
+size_t utf8Pending = 0;  // sisa byte karakter UTF-8 yang sedang diketik
+int autosaveMs = 0;      // 0 = tanpa autosave
+size_t unsavedOnExit = 0; // dokumen yang gagal disimpan saat keluar (journal dipertahankan)
+// Kolaborasi (--serve=SOCKET / --connect=SOCKET); setelah session dan loop
+// supaya dihancurkan lebih dulu
+unique_ptr<CollabServer> collabServer;
+unique_ptr<CollabClient> collabClient;
+Document* sharedDoc = nullptr; // dokumen yang dibagi / diterima dari server
+
+int terminalRows() {
+    winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0)
+        return ws.ws_row;
+    return 24;
+}
+
+// Dokumen milik server kolaborasi disimpan oleh server, bukan di sini
+bool saveRemotely(Document& doc) {
+    if (!collabClient || &doc != sharedDoc) return false;
+    collabClient->requestSave();
+    return true;
+}
+
+// true jika tersimpan (atau diserahkan ke server kolaborasi)
+bool handleSave() {
+    Document& doc = session.current();
+    if (saveRemotely(doc)) {
+        cout << "\r\n[" << doc.name() << " disimpan oleh server]\n" << flush;
+        return true;
+    }
+    if (!doc.save()) {
+        int error = errno;
+        cout << "\r\n[Gagal menyimpan " << doc.path << ": " << strerror(error) << "]\n" << flush;
+        session.log.write("Save failed: " + doc.path + ": " + strerror(error));
+        return false;
     }
+    cout << "\r\n[Saved to " << doc.path << "]\n" << flush;
+    return true;
+}
+
+// Pesan di bawah daftar baris, hilang sendiri setelah STATUS_MS
+void setStatus(const string& message) {
+    statusMessage = message;
+    redrawPending = true;
+    loop.setTimer(TIMER_STATUS, STATUS_MS, [] {
+        statusMessage.clear();
+        redrawPending = true;
+    });
+}
 
-    void pop() {
-        if (!data.empty())
-            data.pop_back();
+// Ctrl+S: tulis + fsync di worker, status muncul saat selesai
+void saveInBackground() {
+    Document& doc = session.current();
+    if (saveRemotely(doc)) {
+        setStatus("[Minta server menyimpan " + doc.name() + "]");
+        return;
     }
+    string path = doc.path;
+    doc.saveAsync(session.workers, [path](bool ok) {
+        setStatus(ok ? "[Saved to " + path + "]" : "[Gagal menyimpan " + path + "]");
+    });
+}
+
+void autosave() {
+    Document& doc = session.current();
+    if (doc.modified && !doc.saving)
+        saveInBackground();
+    loop.setTimer(TIMER_AUTOSAVE, autosaveMs, autosave);
+}
 
-    T& top() {
-        return data.back();
+// Journal hanya dihapus untuk dokumen yang tersimpan, tidak berubah, atau
+// yang perubahannya memang dibuang (jawaban n). Dokumen yang gagal disimpan
+// mempertahankan journal-nya dan dipulihkan saat dibuka lagi.
+void promptExit() {
+    // Simpan background yang masih jalan (dan yang diantrekan di belakangnya)
+    // harus selesai dulu, supaya tidak menimpa hasil simpan di bawah
+    session.waitForSaves();
+    disableRawMode(true);
+    cout << "\r\nApakah kamu ingin menyimpan sebelum keluar? (y/n):";
+    char choice;
+    cin >> choice;
+    bool saveAll = choice == 'y' || choice == 'Y';
+    if (!saveAll) cout << "[Keluar tanpa menyimpan]\n";
+    size_t original = session.active;
+    for (size_t i = 0; i < session.docs.size(); ++i) {
+        Document& doc = *session.docs[i];
+        // Dokumen aktif selalu disimpan, dokumen lain hanya yang berubah
+        if (saveAll && (i == original || doc.modified)) {
+            session.switchTo(i);
+            doc.syncCurrentLine();
+            if (!handleSave()) {
+                doc.journal.commit();
+                cout << "[Perubahan " << doc.name() << " tetap ada di " << doc.journalPath()
+                     << ", dipulihkan saat file dibuka lagi]\n";
+                unsavedOnExit++;
+                continue;
+            }
+        }
+        doc.finish();
     }
+}
 
-    bool empty() const {
-        return data.empty();
+// Baca satu baris teks dalam raw mode (untuk nama file)
+string promptLine(const string& prompt) {
+    cout << "\r\n" << prompt << flush;
+    string text;
+    char ch;
+    while (read(STDIN_FILENO, &ch, 1) == 1 && ch != '\n') {
+        if (ch == 127) {
+            if (!text.empty()) {
+                text.pop_back();
+                cout << "\b \b" << flush;
+            }
+        } else {
+            text += ch;
+            cout << ch << flush;
+        }
     }
+    return text;
+}
+
+// Kursor ke baris terakhir (lewat journal, supaya recovery tetap konsisten);
+// layar selalu memuat baris kursor, jadi ikut ke akhir file
+void followTail(Document& doc) {
+    string payload;
+    journalPutU32(payload, (uint32_t)(doc.lineCount() - 1));
+    doc.recordOp(J_MOVE_TO, payload);
+}
 
-    void clear() {
-        data.clear();
+// Samakan dokumen dengan file-nya setelah diubah program lain
+void syncDocument(Document& doc) {
+    switch (doc.syncWithDisk()) {
+    case DISK_APPENDED:
+        if (doc.follow) followTail(doc);
+        redrawPending = true;
+        break;
+    case DISK_RELOADED:
+        if (doc.follow) followTail(doc);
+        setStatus("[" + doc.name() + " dibaca ulang dari disk]");
+        break;
+    case DISK_CONFLICT:
+        setStatus("[" + doc.name() + " berubah di disk, Ctrl+S akan menimpanya]");
+        break;
+    case DISK_NONE:
+        break;
     }
-};
+}
+
+void onFileChanged(const string& path) {
+    for (auto& d : session.docs)
+        if (d->path == path)
+            syncDocument(*d);
+}
+
+// Dokumen yang isinya dari disk dipantau; saved_text.txt baru tidak
+void openFile(const string& path, size_t* recovered = nullptr) {
+    session.open(path, true, recovered);
+    fileWatch.add(path);
+}
 
-ManualStack<string> undoStack;
-ManualStack<string> redoStack;
-string currentLine = "";
-string fullText = "";
-bool isBold = false;
-bool isItalic = false;
-bool isUnderline = false;
-bool underlineActive = false;
-int currentLineIndex = 0;
-vector<string> lines;
-ofstream logFile;
-
-void logAction(const string& action) {
-    if (logFile.is_open()) {
-        time_t now = time(0);
-        struct tm* timeinfo = localtime(&now);
-        char timestamp[20];
-        strftime(timestamp, sizeof(timestamp), "%d-%m-%Y[%H:%M:%S]", timeinfo);
-        logFile << "[" << timestamp << "] - " << action << endl;
+void handleOpen() {
+    string path = promptLine("Buka file: ");
+    if (!path.empty())
+        openFile(path);
+}
+
+// Laporan memori; \n diganti \r\n karena terminal dalam raw mode
+void showMemoryReport() {
+    string report = session.memoryReport() + screen.stats();
+    screen.control("\r\n");
+    for (char c : report) {
+        if (c == '\n') screen << '\r';
+        screen << c;
     }
+    screen.flush();
 }
 
-void enableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag &= ~(ICANON | ECHO);
-    term.c_iflag &= ~(IXON);
-    tcsetattr(0, TCSANOW, &term);
+// Alt+E: ekspor dokumen aktif beserta format teksnya; format dipilih dari
+// ekstensi file
+void handleExport() {
+    string path = promptLine("Ekspor ke (.html/.md/.ans): ");
+    if (path.empty()) return;
+    ExportFormat format;
+    if (!exportFormatFor(path, format)) {
+        setStatus("[Ekstensi tidak dikenal: " + path + "]");
+        return;
+    }
+    session.current().exportAsync(session.workers, path, format, [path](bool ok) {
+        setStatus(ok ? "[Diekspor ke " + path + "]" : "[Gagal mengekspor " + path + "]");
+    });
 }
 
-void disableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag |= (ICANON | ECHO);
-    tcsetattr(0, TCSANOW, &term);
+// Diff buffer terhadap file tersimpan, sebanyak yang muat satu layar: baris
+// lama (dari file) merah, baris baru (buffer) hijau
+void showDiff() {
+    Document& doc = session.current();
+    auto start = chrono::steady_clock::now();
+    vector<DiffHunk> hunks = doc.diffWithSaved();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    size_t added = 0, removed = 0;
+    for (const DiffHunk& h : hunks) {
+        added += h.newCount;
+        removed += h.oldCount;
+    }
+    char took[32];
+    snprintf(took, sizeof(took), "%.1f ms", ms);
+    screen.control("\033[2J\033[H");
+    screen.resetTerminal();
+    screen << "[Diff] " << doc.path << " -> buffer: " << hunks.size() << " hunk, +" << added
+           << " -" << removed << " baris (" << took << ")\r\n";
+
+    // Hunk dipotong supaya muat; baris lama dibaca dari file hanya untuk ini
+    int rows = max(3, terminalRows() - 3);
+    vector<DiffHunk> shown;
+    for (const DiffHunk& h : hunks) {
+        if (rows < 2) break;
+        DiffHunk part = h;
+        rows--;
+        part.oldCount = min<uint32_t>(h.oldCount, (uint32_t)rows);
+        rows -= (int)part.oldCount;
+        part.newCount = min<uint32_t>(h.newCount, (uint32_t)rows);
+        rows -= (int)part.newCount;
+        shown.push_back(part);
+    }
+    vector<string> oldLines = doc.savedLinesOf(shown);
+    size_t next = 0;
+    for (size_t k = 0; k < shown.size(); ++k) {
+        const DiffHunk& h = hunks[k];
+        screen.color(36);
+        screen << "@@ -" << (size_t)h.oldStart + 1 << ',' << (size_t)h.oldCount << " +" << (size_t)h.newStart + 1
+               << ',' << (size_t)h.newCount << " @@";
+        screen.color(39);
+        screen << "\r\n";
+        screen.color(31);
+        for (uint32_t j = 0; j < shown[k].oldCount && next < oldLines.size(); ++j)
+            screen << '-' << oldLines[next++] << "\r\n";
+        screen.color(32);
+        for (uint32_t j = 0; j < shown[k].newCount; ++j)
+            screen << '+' << doc.lineAt(h.newStart + j) << "\r\n";
+        screen.color(39);
+    }
+    if (shown.size() < hunks.size())
+        screen << "... " << hunks.size() - shown.size() << " hunk lagi\r\n";
+    screen.resetStyle();
+    screen.flush();
 }
 
-void pushToUndo() {
-    if (undoStack.empty() || undoStack.top() != currentLine) {
-        undoStack.push(currentLine);
-        redoStack.clear();
-        logAction("Push to undo: " + currentLine);
+// Cetak line[from, to) dengan warna token highlight
+void printSpan(string_view line, const vector<Token>& tokens, size_t from, size_t to) {
+    size_t pos = from;
+    for (const Token& t : tokens) {
+        if (t.start >= to) break;
+        size_t start = max<size_t>(t.start, pos);
+        size_t end = min<size_t>(t.start + t.length, to);
+        if (end <= start) continue;
+        screen << line.substr(pos, start - pos);
+        screen.color(tokenColor(t.kind));
+        screen << line.substr(start, end - start);
+        screen.color(39);
+        pos = end;
     }
+    screen << line.substr(pos, to - pos);
+}
+
+void applyAttr(uint8_t attr) {
+    screen.bold(attr & ATTR_BOLD);
+    screen.italic(attr & ATTR_ITALIC);
+    screen.underline(attr & ATTR_UNDERLINE);
 }
 
-void handleUndo() {
-    if (!undoStack.empty()) {
-        redoStack.push(currentLine);
-        currentLine = undoStack.top();
-        undoStack.pop();
-        logAction("Undo: " + currentLine);
+// Seperti printSpan, ditambah atribut format (bold/italic/underline) baris itu
+void printStyled(string_view line, const LineAttrs* attrs, const vector<Token>& tokens, size_t from, size_t to) {
+    size_t pos = 0;
+    if (attrs) {
+        for (const AttrRun& run : *attrs) {
+            size_t end = min<size_t>(pos + run.length, to);
+            if (end > from && pos < to) {
+                applyAttr(run.attr);
+                printSpan(line, tokens, max(pos, from), end);
+            }
+            pos += run.length;
+            if (pos >= to) break;
+        }
     }
+    applyAttr(0);
+    if (pos < to)
+        printSpan(line, tokens, max(pos, from), to);
 }
 
-void handleRedo() {
-    if (!redoStack.empty()) {
-        undoStack.push(currentLine);
-        currentLine = redoStack.top();
-        redoStack.pop();
-        logAction("Redo: " + currentLine);
+// Baris dengan kursor tambahan: grapheme di posisi kursor ditampilkan
+// reverse video (spasi jika kursor di akhir baris)
+void printLineWithCursors(const Document& doc, size_t index, const vector<Token>& tokens) {
+    string_view line = doc.lineAt(index);
+    const LineAttrs* attrs = doc.lineAttrs(index);
+    auto range = doc.cursorsOnLine(index);
+    size_t pos = 0;
+    for (const Cursor* c = range.first; c != range.second; ++c) {
+        if (c->offset < pos || c->offset > line.size()) continue;
+        size_t end = c->offset < line.size() ? nextGrapheme(line, c->offset) : c->offset;
+        printStyled(line, attrs, tokens, pos, c->offset);
+        screen.reverse(true);
+        if (end > c->offset)
+            printStyled(line, attrs, tokens, c->offset, end);
+        else
+            screen << ' ';
+        screen.reverse(false);
+        pos = end;
     }
+    printStyled(line, attrs, tokens, pos, line.size());
 }
 
-void handleDeleteLastWord() {
-    pushToUndo();
-    size_t pos = currentLine.find_last_of(' ');
-    if (pos != string::npos)
-        currentLine = currentLine.substr(0, pos);
-    else
-        currentLine.clear();
-    logAction("Delete last word: " + currentLine);
+// Judul dan daftar perintah, sama di layar awal dan setiap frame
+void printHeader() {
+    screen << "=== Simple Text Editor ===\n";
+    screen << "Commands:\n";
+    screen << "  Ctrl+S : Save\n";
+    screen << "  Ctrl+U : Undo\n";
+    screen << "  Ctrl+Y : Redo\n";
+    screen << "  Ctrl+D : Delete Last Word\n";
+    screen << "  Ctrl+X : Exit (dengan konfirmasi)\n";
+    screen << "  Ctrl+B : Toggle Bold\n";
+    screen << "  Ctrl+K : Toggle Italic\n";
+    screen << "  Ctrl+T : Toggle Underline\n";
+    screen << "  Ctrl+Q : Move Up Line\n";
+    screen << "  Ctrl+A : Move Down Line\n";
+    screen << "  Ctrl+L : Cursor Left, Ctrl+R : Cursor Right\n";
+    screen << "  Arrows, Home/End, PgUp/PgDn, Alt+B/F : Navigate\n";
+    screen << "  Alt+Up/Down : Move Line, Alt+K : Delete Line, Alt+J : Join Line\n";
+    screen << "  Alt+C : Add Cursor Below, Alt+W : Cursors at Word, Esc : Single Cursor\n";
+    screen << "  Ctrl+O : Open File, Alt+T : Follow End of File (tail -f)\n";
+    screen << "  Ctrl+N : Next Document\n";
+    screen << "  Ctrl+P : Previous Document\n";
+    screen << "  Ctrl+G : Memory Usage, Alt+V : Diff vs Saved File, Alt+E : Export\n";
+    screen << "  Enter  : Newline\n\n";
 }
 
-void handleSave() {
-    fullText.clear();
-    for (const string& line : lines) {
-        fullText += line + "\n";
+// Seluruh layar jadi satu frame: dikumpulkan di screen lalu satu write()
+void displayText() { // menampilkan currentLine di terminal
+    Document& doc = session.current();
+    screen.control("\033[2J\033[H"); // Clear screen dan pindah kursor ke posisi awal
+    screen.resetTerminal();           // dan reset format
+    printHeader();
+
+    // Tab dokumen, yang aktif ditampilkan reverse video, * = belum disimpan
+    for (size_t i = 0; i < session.docs.size(); ++i) {
+        const Document& d = *session.docs[i];
+        screen.reverse(i == session.active);
+        screen << ' ' << i + 1 << ':' << d.name() << (d.modified ? "*" : "") << (d.saving ? " (menyimpan)" : "")
+               << ' ';
+        screen.reverse(false);
     }
-    ofstream file("saved_text.txt");
-    file << fullText;
-    file.close();
-    logAction("Save to saved_text.txt");
-    cout << "\r\n[Saved to saved_text.txt]\n";
-    sleep(5);
-    cout << "> " << flush;
+    if (doc.multiCursor())
+        screen << "  [" << doc.extraCursors.size() + 1 << " kursor]";
+    LineStats stats = doc.textStats();
+    screen << "  " << doc.lineCount() << " baris, " << (size_t)stats.words << " kata, " << (size_t)stats.chars
+           << " karakter";
+    const AttrStats& attrs = doc.attrStats();
+    if (attrs != AttrStats())
+        screen << " (" << (size_t)attrs.chars[0] << " bold, " << (size_t)attrs.chars[1] << " italic, "
+               << (size_t)attrs.chars[2] << " underline)";
+    screen << "\n\n";
+
+    // Hanya baris di sekitar kursor yang dirender
+    int rows = max(3, terminalRows() - HEADER_ROWS);
+    int first = max(0, doc.currentLineIndex - rows + 1);
+    int last = min((int)doc.lines.size(), first + rows);
+    doc.refreshHighlight(max(last, doc.currentLineIndex + 1));
+    vector<Token> tokens;
+    for (int i = first; i < last; ++i) {
+        screen << '[' << i + 1 << "] > ";
+        doc.highlightLine(i, tokens);
+        printLineWithCursors(doc, i, tokens);
+        screen.resetStyle();
+        screen << '\n';
+    }
+    screen << statusMessage << '\n';
+    // Prompt memakai atribut ketik yang aktif, teksnya memakai atribut tersimpan
+    applyAttr(doc.typingAttr());
+    screen << "\r[" << doc.currentLineIndex + 1 << "] > ";
+    doc.highlightLine(doc.currentLineIndex, tokens);
+    printStyled(doc.currentLine, doc.lineAttrs(doc.currentLineIndex), tokens, 0, doc.currentLine.size());
+    screen.control("\033[K");
+    // Kursor terminal mundur sejauh lebar tampilan teks setelah kursor
+    screen.cursorLeft(displayWidth(string_view(doc.currentLine).substr(doc.cursor)));
+    screen.resetStyle(); // Reset format
+    screen.commitStyle();
+    screen.flush();
 }
 
-void promptExit() {
-    disableRawMode();
-    cout << "\r\nApakah kamu ingin menyimpan sebelum keluar? (y/n):";
-    char choice;
-    cin >> choice;
-    if (choice == 'y' || choice == 'Y') {
-        lines.push_back(currentLine);
-        fullText += currentLine + "\n";
-        handleSave();
-    } else {
-        cout << "[Keluar tanpa menyimpan]\n";
+// Satu tombol hasil decoder ke operasi dokumen
+void handleKey(const KeyEvent& key) {
+    Document& doc = session.current();
+    if (key.action != KEY_FOLLOW && key.action != KEY_MEMORY && key.action != KEY_DIFF &&
+        key.action != KEY_NEXT_DOC && key.action != KEY_PREV_DOC)
+        doc.follow = false; // seperti less +F: tombol lain menghentikan follow
+    switch (key.action) {
+    case KEY_EXIT:
+        promptExit();
+        exiting = true;
+        loop.stop();
+        break;
+    case KEY_UNDO: doc.recordOp(J_UNDO); break;
+    case KEY_REDO: doc.recordOp(J_REDO); break;
+    case KEY_DELETE_WORD: doc.recordOp(J_DELETE_WORD); break;
+    case KEY_SAVE: saveInBackground(); break;
+    case KEY_BOLD: doc.recordOp(J_TOGGLE_BOLD); break;
+    case KEY_ITALIC: doc.recordOp(J_TOGGLE_ITALIC); break;
+    case KEY_UNDERLINE: doc.recordOp(J_TOGGLE_UNDERLINE); break;
+    case KEY_UP: doc.recordOp(J_MOVE_UP); break;
+    case KEY_DOWN: doc.recordOp(J_MOVE_DOWN); break;
+    case KEY_LEFT: doc.recordOp(J_MOVE_LEFT); break;
+    case KEY_RIGHT: doc.recordOp(J_MOVE_RIGHT); break;
+    case KEY_WORD_LEFT: doc.recordOp(J_WORD_LEFT); break;
+    case KEY_WORD_RIGHT: doc.recordOp(J_WORD_RIGHT); break;
+    case KEY_HOME: doc.recordOp(J_HOME); break;
+    case KEY_END: doc.recordOp(J_END); break;
+    case KEY_PAGE_UP:
+    case KEY_PAGE_DOWN: {
+        int page = max(3, terminalRows() - HEADER_ROWS);
+        int target = doc.currentLineIndex + (key.action == KEY_PAGE_UP ? -page : page);
+        string payload;
+        journalPutU32(payload, (uint32_t)max(0, target));
+        doc.recordOp(J_MOVE_TO, payload);
+        break;
+    }
+    case KEY_DELETE: doc.recordOp(J_DELETE_FORWARD); break;
+    case KEY_OPEN: handleOpen(); break;
+    case KEY_EXPORT: handleExport(); break;
+    case KEY_NEXT_DOC:
+        session.next();
+        syncDocument(session.current()); // dokumen yang tadinya dipadatkan belum dicek
+        break;
+    case KEY_PREV_DOC:
+        session.prev();
+        syncDocument(session.current());
+        break;
+    case KEY_FOLLOW:
+        doc.follow = !doc.follow;
+        if (doc.follow) followTail(doc);
+        setStatus(doc.follow ? "[Follow: layar mengikuti akhir file]" : "[Follow berhenti]");
+        break;
+    case KEY_MEMORY:
+        showMemoryReport();
+        redrawPending = false; // laporan tetap terlihat sampai event berikutnya
+        break;
+    case KEY_DIFF:
+        showDiff();
+        redrawPending = false;
+        break;
+    case KEY_NEWLINE: doc.recordOp(J_NEWLINE); break;
+    case KEY_BACKSPACE: doc.recordOp(J_BACKSPACE); break;
+    case KEY_PASTE: doc.recordOp(J_PASTE, decoder.pasted); break;
+    case KEY_JOIN_LINE: doc.recordOp(J_JOIN_LINE); break;
+    case KEY_DELETE_LINE: doc.recordOp(J_DELETE_LINE); break;
+    case KEY_MOVE_LINE_UP: doc.recordOp(J_MOVE_LINE_UP); break;
+    case KEY_MOVE_LINE_DOWN: doc.recordOp(J_MOVE_LINE_DOWN); break;
+    case KEY_ADD_CURSOR: doc.recordOp(J_ADD_CURSOR_BELOW); break;
+    case KEY_CURSORS_AT_WORD: doc.recordOp(J_ADD_CURSORS_AT_WORD); break;
+    case KEY_INSERT: {
+        doc.recordOp(J_INSERT, key.ch);
+        unsigned char byte = (unsigned char)key.ch;
+        if (byte >= 0xc0)
+            utf8Pending = utf8ExpectedLength(byte) - 1;
+        else if (byte >= 0x80 && utf8Pending > 0)
+            utf8Pending--;
+        else
+            utf8Pending = 0;
+        break;
+    }
+    default:
+        break;
     }
 }
 
-void toggleBold() {
-    isBold = !isBold;
-    cout << (isBold ? "\033[1m" : "\033[22m");
+// Group commit semua dokumen, bukan hanya yang aktif: dokumen lain juga
+// menerima record (edit kolaborasi ke dokumen yang dibagi)
+void commitJournals() {
+    for (auto& d : session.docs) {
+        d->journal.maybeCommit();
+        if (int error = d->journal.lastError()) // record tetap disimpan dan dicoba lagi
+            setStatus("[Journal " + d->name() + " gagal ditulis: " + strerror(error) + "]");
+    }
 }
 
-void toggleItalic() {
-    isItalic = !isItalic;
-    cout << (isItalic ? "\033[3m" : "\033[23m");
+// Jatuh tempo group commit paling awal di semua dokumen, -1 = tidak ada
+int msUntilJournalCommit() {
+    int due = -1;
+    for (auto& d : session.docs) {
+        int ms = d->journal.msUntilCommit();
+        if (ms >= 0 && (due < 0 || ms < due)) due = ms;
+    }
+    return due;
 }
 
-void toggleUnderline() {
-    underlineActive = !underlineActive;
-    cout << (underlineActive ? "\033[4m" : "\033[24m");
+// stdin readable: semua byte yang sudah tersedia diproses dulu, layar
+// digambar sekali di scheduleTimers()
+void onInput() {
+    char buf[4096];
+    ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+    if (n <= 0) {
+        loop.stop();
+        return;
+    }
+    for (ssize_t i = 0; i < n && !exiting; ++i) {
+        KeyEvent key;
+        if (!decoder.feed(buf[i], key))
+            continue;
+        redrawPending = true;
+        handleKey(key);
+        if (++editsSinceBudgetCheck >= BUDGET_CHECK_EDITS) {
+            editsSinceBudgetCheck = 0;
+            session.enforceBudget();
+        }
+    }
+    if (!exiting)
+        commitJournals();
 }
 
-void moveUp() {
-    if (currentLineIndex > 0) {
-        lines[currentLineIndex] = currentLine;
-        currentLineIndex--;
-        currentLine = lines[currentLineIndex];
-        logAction("Moved up to line: " + currentLine);
+// ESC sendirian atau sequence terputus
+void onEscTimeout() {
+    KeyEvent key;
+    if (decoder.flush(key) && session.current().multiCursor()) {
+        session.current().recordOp(J_CLEAR_CURSORS); // Esc: kembali ke satu kursor
+        redrawPending = true;
     }
 }
 
-void moveDown() {
-    if (currentLineIndex < (int)lines.size() - 1) {
-        lines[currentLineIndex] = currentLine;
-        currentLineIndex++;
-        currentLine = lines[currentLineIndex];
-        logAction("Moved down to line: " + currentLine);
+void onSignal(int sig) {
+    if (sig == SIGWINCH) {
+        redrawPending = true; // ukuran viewport ikut terminal baru
+        return;
     }
+    // SIGTERM/SIGHUP/SIGINT: jangan finish(), journal dipakai untuk pemulihan
+    for (auto& d : session.docs)
+        d->journal.commit();
+    session.log.write(string("Dihentikan oleh sinyal ") + strsignal(sig));
+    terminated = true;
+    loop.stop();
 }
 
-void displayText() { // menampilkan currentLine di terminal
-    cout << "\033[2J\033[H\033[0m"; // Clear screen dan pindah kursor ke posisi awal dan reset format
-    cout << "=== Simple Text Editor ===\n";
-    cout << "Commands:\n";
-    cout << "  Ctrl+S : Save\n";
-    cout << "  Ctrl+U : Undo\n";
-    cout << "  Ctrl+Y : Redo\n";
-    cout << "  Ctrl+D : Delete Last Word\n";
-    cout << "  Ctrl+X : Exit (dengan konfirmasi)\n";
-    cout << "  Ctrl+B : Toggle Bold\n";
-    cout << "  Ctrl+K : Toggle Italic\n";
-    cout << "  Ctrl+T : Toggle Underline\n";
-    cout << "  Ctrl+Q : Move Up Line\n";
-    cout << "  Ctrl+A : Move Down Line\n";
-    cout << "  Enter  : Newline\n\n";
-
-    for (int i = 0; i < lines.size(); ++i) {        
-        cout << "[" << i + 1 << "] > " << lines[i] << "\033[0m\n";
+// Blok baris dingin dikompres per batch kecil supaya input tetap diproses
+void coolStep() {
+    if (session.current().coolLines())
+        loop.setTimer(TIMER_COOL, COOL_STEP_MS, coolStep);
+}
+
+// Setelah setiap batch event: pasang ulang timer sesuai state terbaru lalu
+// gambar layar sekali
+void scheduleTimers() {
+    // Edit frame ini dikirim sekaligus, bukan per tombol
+    if (collabServer) collabServer->flush();
+    if (collabClient) collabClient->flush();
+
+    int journalDue = msUntilJournalCommit();
+    if (journalDue < 0)
+        loop.cancelTimer(TIMER_JOURNAL);
+    else if (!loop.hasTimer(TIMER_JOURNAL))
+        loop.setTimer(TIMER_JOURNAL, journalDue, commitJournals);
+
+    int idleDue = session.msUntilIdleWork();
+    if (idleDue < 0)
+        loop.cancelTimer(TIMER_IDLE);
+    else
+        loop.setTimer(TIMER_IDLE, idleDue, [] { session.compactIdle(); });
+
+    if (!decoder.pending())
+        loop.cancelTimer(TIMER_ESC);
+    else if (!loop.hasTimer(TIMER_ESC))
+        loop.setTimer(TIMER_ESC, InputDecoder::ESC_TIMEOUT_MS, onEscTimeout);
+
+    if (redrawPending && utf8Pending == 0) { // karakter UTF-8 setengah tidak dirender
+        redrawPending = false;
+        displayText();
     }
-    cout << "\n";
-    if (isBold) cout << "\033[1m";
-    if (isItalic) cout << "\033[3m";
-    if (underlineActive) cout << "\033[4m";
-    cout << "\r[" << currentLineIndex + 1 << "] > " << currentLine << "\033[K" << flush;
-    cout << "\033[0m"; // Reset format
+    if (!loop.hasTimer(TIMER_COOL))
+        coolStep(); // view baris frame ini sudah tidak dipakai: aman membuang blok panas
 }
 
-int main() {
-    logFile.open(".log.txt", ios::app);
-    enableRawMode();
+int main(int argc, char* argv[]) {
+    session.log.open(".log.txt");
 
-    // Menampilkan informasi awal
-    cout << "\033[2J\033[H"; // Clear screen and move cursor to home position
-    cout << "=== Simple Text Editor ===\n";
-    cout << "Commands:\n";
-    cout << "  Ctrl+S : Save\n";
-    cout << "  Ctrl+U : Undo\n";
-    cout << "  Ctrl+Y : Redo\n";
-    cout << "  Ctrl+D : Delete Last Word\n";
-    cout << "  Ctrl+X : Exit (dengan konfirmasi)\n";
-    cout << "  Ctrl+B : Toggle Bold\n";
-    cout << "  Ctrl+K : Toggle Italic\n";
-    cout << "  Ctrl+T : Toggle Underline\n";
-    cout << "  Ctrl+Q : Move Up Line\n";
-    cout << "  Ctrl+A : Move Down Line\n";
-    cout << "  Enter  : Newline\n\n\n";
-
-    cout << "[1] > " << flush;
+    // Budget memori: --mem-budget=MB atau EDITOR_MEM_BUDGET_MB
+    // Budget undo per dokumen: --undo-budget=MB atau EDITOR_UNDO_BUDGET_MB
+    // Autosave: --autosave=DETIK atau EDITOR_AUTOSAVE_SEC
+    // Kolaborasi: --serve=SOCKET membagi dokumen pertama, --connect=SOCKET
+    // mengedit dokumen milik editor lain
+    vector<string> files;
+    string serveSocket, connectSocket;
+    if (const char* env = getenv("EDITOR_MEM_BUDGET_MB"))
+        session.memoryBudget = strtoull(env, nullptr, 10) << 20;
+    if (const char* env = getenv("EDITOR_UNDO_BUDGET_MB"))
+        session.undoBudget = strtoull(env, nullptr, 10) << 20;
+    if (const char* env = getenv("EDITOR_AUTOSAVE_SEC"))
+        autosaveMs = atoi(env) * 1000;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--mem-budget=", 0) == 0)
+            session.memoryBudget = strtoull(arg.c_str() + 13, nullptr, 10) << 20;
+        else if (arg.rfind("--undo-budget=", 0) == 0)
+            session.undoBudget = strtoull(arg.c_str() + 14, nullptr, 10) << 20;
+        else if (arg.rfind("--autosave=", 0) == 0)
+            autosaveMs = atoi(arg.c_str() + 11) * 1000;
+        else if (arg.rfind("--serve=", 0) == 0)
+            serveSocket = arg.substr(8);
+        else if (arg.rfind("--connect=", 0) == 0)
+            connectSocket = arg.substr(10);
+        else
+            files.push_back(arg);
+    }
 
-    char ch;
-    bool isStartOfWord = true;
-
-    while (read(STDIN_FILENO, &ch, 1) == 1) {
-        if (ch == 24) { // ESC 
-            promptExit();
-            break;
-        } else if (ch == 21) { // Ctrl+U
-            handleUndo();
-        } else if (ch == 25) { // Ctrl+Y
-            handleRedo();
-        } else if (ch == 4) { // Ctrl+D
-            handleDeleteLastWord();
-        } else if (ch == 19) { // Ctrl+S
-            handleSave();
-        } else if (ch == 2) { // Ctrl+X
-            toggleBold();
-        } else if (ch == 11) { // Ctrl+K
-            toggleItalic();
-        } else if (ch == 20) { // Ctrl+T
-            toggleUnderline();
-        } else if (ch == 17) { // Ctrl+Q
-            moveUp();
-        } else if (ch == 1) { // Ctrl+A
-            moveDown();
-        } else if (ch == '\n') { // Enter key
-            pushToUndo();
-            if (currentLineIndex < lines.size()) { // untuk menyimpan ke dalam baris 
-                lines[currentLineIndex] = currentLine; // menyimpan currentLine ke dalam lines
-            } else {
-                lines.push_back(currentLine); // menambahkan currentLine ke dalam lines
-            }
-            fullText += currentLine + "\n"; 
-            currentLine.clear(); // untuk mengosongkan currentLine setelah menekan Enter
-            currentLineIndex = lines.size(); // pindah ke baris baru
-            lines.push_back(""); // menambahkan baris kosong untuk input berikutnya
-            cout << "\n> " << flush; // menampilkan prompt baru
-            isStartOfWord = true;
-        } else if (ch == 127) {
-            if (!currentLine.empty()) { //ketika currentLine tidak kosong
-                currentLine.pop_back(); // menghapus karakter terakhir dari currentLine
-                if (currentLineIndex < lines.size()) // jika currentLineIndex lebih kecil dari ukuran lines
-                    lines[currentLineIndex] = currentLine; // memperbarui baris yang sesuai di lines
-            }
-        } else {
-            if (isStartOfWord) {
-                pushToUndo(); // menyimpan currentLine ke dalam undoStack
-                isStartOfWord = false; // menandai bahwa kita sudah tidak di awal kata lagi
-            }
-            currentLine += ch; // menambahkan karakter yang dimasukkan ke currentLine
-            if (currentLineIndex < lines.size()) // memperbarui baris yang sesuai di lines
-                lines[currentLineIndex] = currentLine; // memperbarui baris yang sesuai di lines
-            if (ch == ' ') {
-                isStartOfWord = true;
-            }
+    size_t recovered = 0;
+    if (!connectSocket.empty()) {
+        collabClient.reset(new CollabClient(loop));
+        if (!collabClient->connect(connectSocket) || !collabClient->handshake()) {
+            cerr << "Tidak bisa tersambung ke " << connectSocket << "\n";
+            return 1;
+        }
+        sharedDoc = &session.openDetached(collabClient->documentName());
+        collabClient->attach(*sharedDoc);
+        collabClient->onRemoteEdit = [] { redrawPending = true; };
+        collabClient->onDisconnect = [] { setStatus("[Koneksi ke server kolaborasi terputus]"); };
+        for (const string& file : files)
+            openFile(file, nullptr);
+        session.switchTo(0);
+    } else if (!files.empty()) {
+        for (const string& file : files) {
+            size_t count = 0;
+            openFile(file, &count);
+            recovered += count;
         }
-        displayText(); // menampilkan currentLine di terminal
+        session.switchTo(0);
+    } else {
+        session.open(savedPath, false, &recovered);
+    }
+    if (!serveSocket.empty()) {
+        sharedDoc = &session.current();
+        collabServer.reset(new CollabServer(*sharedDoc, loop));
+        if (!collabServer->listen(serveSocket)) {
+            cerr << "Tidak bisa membuka socket " << serveSocket << "\n";
+            return 1;
+        }
+        collabServer->onRemoteEdit = [] { redrawPending = true; };
+        collabServer->onSaveRequest = [] {
+            string path = sharedDoc->path;
+            sharedDoc->expand(); // mungkin sedang dipadatkan kalau bukan dokumen aktif
+            sharedDoc->saveAsync(session.workers, [path](bool ok) {
+                setStatus(ok ? "[Saved to " + path + " (diminta klien)]" : "[Gagal menyimpan " + path + "]");
+            });
+        };
+        collabServer->onClientsChanged = [](size_t count) {
+            setStatus("[" + to_string(count) + " editor lain tersambung]");
+        };
+    }
+    enableRawMode(true); // bracketed paste: paste dikirim sebagai satu blok
+
+    // Menampilkan informasi awal
+    screen.control("\033[2J\033[H"); // Clear screen and move cursor to home position
+    printHeader();
+    screen << '\n';
+
+    if (recovered > 0 || !files.empty() || collabClient) {
+        displayText(); // tampilkan isi file / isi yang dipulihkan dari journal
+    } else {
+        screen << "[1] > ";
+        screen.flush();
+    }
+
+    loop.afterEvents = scheduleTimers;
+    loop.watch(STDIN_FILENO, onInput);
+    loop.watch(session.workers.completionFd(), [] {
+        if (session.workers.runCompletions() > 0) // simpan selesai, highlight siap
+            redrawPending = true;
+    });
+    loop.watch(fileWatch.handle(), [] { fileWatch.readEvents(onFileChanged); });
+    loop.watchSignals({SIGWINCH, SIGTERM, SIGHUP, SIGINT}, onSignal);
+    if (autosaveMs > 0)
+        loop.setTimer(TIMER_AUTOSAVE, autosaveMs, autosave);
+    loop.run();
+
+    if (terminated) {
+        disableRawMode(true);
+        cout << "\n[Dihentikan, perubahan yang belum disimpan ada di journal]\n";
     }
 
+    session.log.write(session.memoryReport() + screen.stats());
+    cout << "\n" << session.memoryReport() << screen.stats();
     cout << "\n[Exiting editor]\n";
-    logFile.close();
-    return 0;
+    if (unsavedOnExit > 0)
+        cout << "[" << unsavedOnExit << " dokumen gagal disimpan, perubahannya ada di journal]\n";
+    session.log.close();
+    return unsavedOnExit > 0 ? 1 : 0;
 }
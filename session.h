@@ -0,0 +1,222 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+// Sesi editor: semua dokumen yang sedang dibuka dalam satu proses.
+// Pindah dokumen hanya mengganti indeks aktif (O(1)); dokumen idle
+// dipadatkan ke PagePool bersama dan, kalau lama tidak dipakai, di-spill
+// ke swap file.
+//
+// Kalau memoryBudget diisi, RSS proses dijaga di bawah budget: dokumen
+// idle dikeluarkan berurutan LRU (yang tidak berubah dibuang dan dibaca
+// ulang dari file, yang berubah di-spill), lalu riwayat undo dokumen aktif.
+//
+// Pekerjaan berat (simpan, highlight awal file besar) dijalankan di
+// `workers`; hasilnya kembali ke thread utama lewat runCompletions().
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <unistd.h>
+#include <malloc.h>
+#include "document.h"
+
+const int COMPACT_IDLE_MS = 2000;   // dokumen idle selama ini dipadatkan
+const int SPILL_IDLE_MS = 60000;    // dan selama ini ditulis ke swap file
+const int IDLE_RETRY_MS = 5000;     // jeda sebelum compact/spill yang gagal dicoba lagi
+
+class Session {
+public:
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    std::vector<std::unique_ptr<Document>> docs;
+    size_t active = 0;
+    size_t memoryBudget = 0; // byte RSS, 0 = tanpa batas
+    size_t undoBudget = 16 << 20; // byte undo/redo di memori per dokumen, 0 = tanpa batas
+    ThreadPool workers;      // setelah docs: worker di-join sebelum dokumen dihapus
+
+    Document& current() {
+        return *docs[active];
+    }
+
+    // Buka file sebagai dokumen baru (atau pindah ke sana kalau sudah terbuka)
+    Document& open(const std::string& path, bool loadFile, size_t* recovered = nullptr) {
+        for (size_t i = 0; i < docs.size(); ++i) {
+            if (docs[i]->path == path) {
+                switchTo(i);
+                return current();
+            }
+        }
+        docs.emplace_back(new Document(path, &pool, &swap, &log));
+        docs.back()->setUndoBudget(undoBudget);
+        size_t count = docs.back()->start(loadFile);
+        if (recovered) *recovered = count;
+        if (loadFile && count == 0)
+            docs.back()->warmHighlight(workers);
+        switchTo(docs.size() - 1);
+        log.write("Open: " + path);
+        return current();
+    }
+
+    // Dokumen tanpa file maupun journal; isinya diisi pemanggil (mis. klien
+    // kolaborasi yang menerima teks dari server)
+    Document& openDetached(const std::string& name) {
+        docs.emplace_back(new Document(name, &pool, &swap, &log));
+        docs.back()->setUndoBudget(undoBudget);
+        docs.back()->shared = true;
+        switchTo(docs.size() - 1);
+        log.write("Open shared: " + name);
+        return current();
+    }
+
+    void switchTo(size_t index) {
+        if (index >= docs.size()) return;
+        if (!docs.empty() && active < docs.size()) {
+            current().journal.commit();
+            current().touch();
+        }
+        active = index;
+        current().expand();
+        current().touch();
+        enforceBudget();
+    }
+
+    // Tunggu semua simpan/ekspor background selesai. Completion simpan bisa
+    // langsung men-submit simpan yang diantrekan (saveQueued), jadi diulang
+    // sampai tidak ada dokumen yang masih menyimpan.
+    void waitForSaves() {
+        while (true) {
+            workers.drain();
+            workers.runCompletions();
+            bool saving = false;
+            for (auto& doc : docs)
+                saving = saving || doc->saving;
+            if (!saving) return;
+        }
+    }
+
+    void next() {
+        switchTo((active + 1) % docs.size());
+    }
+
+    void prev() {
+        switchTo((active + docs.size() - 1) % docs.size());
+    }
+
+    // Padatkan / spill dokumen yang sudah cukup lama tidak aktif
+    void compactIdle() {
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < docs.size(); ++i) {
+            if (i == active) continue;
+            Document& doc = *docs[i];
+            if (now < doc.idleRetry) continue;
+            bool done = true;
+            if (idleMs(doc, now) >= SPILL_IDLE_MS && !doc.spilled) {
+                done = doc.evict() || doc.spill();
+            } else if (idleMs(doc, now) >= COMPACT_IDLE_MS) {
+                doc.compact();
+                done = doc.compacted;
+            }
+            // Tanpa jeda, timer idle langsung jatuh tempo lagi dan loop berputar
+            if (!done)
+                doc.idleRetry = now + std::chrono::milliseconds(IDLE_RETRY_MS);
+        }
+        pool.trim(4); // sisakan sedikit halaman bebas untuk compact berikutnya
+        enforceBudget();
+    }
+
+    // Bebaskan memori berurutan LRU sampai RSS kembali di bawah budget
+    void enforceBudget() {
+        if (memoryBudget == 0 || readRss() <= memoryBudget) return;
+        std::vector<Document*> idle;
+        for (size_t i = 0; i < docs.size(); ++i)
+            if (i != active && !docs[i]->spilled && !docs[i]->evicted)
+                idle.push_back(docs[i].get());
+        std::sort(idle.begin(), idle.end(), [](const Document* a, const Document* b) {
+            return a->lastActive < b->lastActive;
+        });
+        for (Document* doc : idle) {
+            if (!doc->evict())
+                doc->spill();
+            if (releaseMemory() <= memoryBudget) return;
+        }
+        if (current().spillHistory())
+            releaseMemory();
+    }
+
+    // RSS proses dari /proc/self/statm
+    static size_t readRss() {
+        FILE* f = fopen("/proc/self/statm", "r");
+        if (!f) return 0;
+        unsigned long size = 0, resident = 0;
+        if (fscanf(f, "%lu %lu", &size, &resident) != 2)
+            resident = 0;
+        fclose(f);
+        return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+    }
+
+    std::string memoryReport() const {
+        const size_t MB = 1024 * 1024;
+        std::string out = "[Memori] RSS " + std::to_string(readRss() / MB) + " MB";
+        out += memoryBudget ? " / budget " + std::to_string(memoryBudget / MB) + " MB" : " (tanpa budget)";
+        out += ", pool " + std::to_string(pool.pagesInUse()) + "+" + std::to_string(pool.pagesFree()) +
+               " halaman, swap " + std::to_string(swap.live() / 1024) + " KB\n";
+        for (size_t i = 0; i < docs.size(); ++i) {
+            const Document& doc = *docs[i];
+            out += "  " + std::to_string(i + 1) + ":" + doc.name() + " [" + doc.stateName() +
+                   (doc.historySpilled ? ", undo di swap" : "") +
+                   (doc.lines.coldStorageEnabled() ? ", " + std::to_string(doc.lines.coldBlocks()) + " blok LZ" : "") +
+                   "] " +
+                   std::to_string(doc.memoryBytes() / 1024) + " KB";
+            if (!doc.lines.empty()) {
+                // Overhead per baris = memori store dikurangi isi baris itu sendiri
+                double overhead = (double)(doc.lines.memoryBytes() - std::min(doc.lines.memoryBytes(),
+                                  doc.lines.contentBytes())) / doc.lines.size();
+                char buf[64];
+                snprintf(buf, sizeof(buf), ", %zu baris, %.1f B/baris overhead", doc.lines.size(), overhead);
+                out += buf;
+            }
+            out += "\n";
+        }
+        return out;
+    }
+
+    // Waktu (ms) sampai compactIdle() punya pekerjaan, -1 jika tidak ada
+    int msUntilIdleWork() const {
+        auto now = std::chrono::steady_clock::now();
+        long best = -1;
+        for (size_t i = 0; i < docs.size(); ++i) {
+            if (i == active || docs[i]->spilled || docs[i]->evicted) continue;
+            long due = (docs[i]->compacted ? SPILL_IDLE_MS : COMPACT_IDLE_MS) - idleMs(*docs[i], now);
+            long retry = (long)std::chrono::ceil<std::chrono::milliseconds>(docs[i]->idleRetry - now).count();
+            due = std::max(due, retry);
+            if (due < 0) due = 0;
+            if (best < 0 || due < best) best = due;
+        }
+        return (int)best;
+    }
+
+    bool anyModified() const {
+        for (const auto& doc : docs)
+            if (doc->modified) return true;
+        return false;
+    }
+
+private:
+    // Kembalikan halaman bebas ke sistem lalu ukur ulang RSS
+    size_t releaseMemory() {
+        pool.trim();
+        malloc_trim(0);
+        return readRss();
+    }
+
+    static long idleMs(const Document& doc, std::chrono::steady_clock::time_point now) {
+        return (long)std::chrono::duration_cast<std::chrono::milliseconds>(now - doc.lastActive).count();
+    }
+};
+
+#endif
@@ -4,6 +4,9 @@
 #include <fstream>
 #include <termios.h>
 #include <unistd.h>
+#include "terminal.h"
+#include "utf8.h"
+#include "termout.h"
 
 using namespace std;
 
@@ -11,21 +14,7 @@ stack<string> undoStack;
 stack<string> redoStack;
 string currentLine = "";
 string fullText = "";
-
-void enableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag &= ~(ICANON | ECHO); // Non-canonical mode & no echo
-    term.c_iflag &= ~(IXON);          // Disable Ctrl+S (XOFF) & Ctrl+Q (XON)
-    tcsetattr(0, TCSANOW, &term);
-}
-
-void disableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag |= (ICANON | ECHO);
-    tcsetattr(0, TCSANOW, &term);
-}
+TermWriter screen; // satu write() per tombol
 
 void pushToUndo() {
     if (undoStack.empty() || undoStack.top() != currentLine) {
@@ -52,7 +41,7 @@ void handleRedo() {
 
 void handleDeleteLastWord() {
     pushToUndo();
-    size_t pos = currentLine.find_last_of(' ');
+    size_t pos = findLastSeparator(currentLine, currentLine.size());
     if (pos != string::npos)
         currentLine = currentLine.substr(0, pos);
     else
@@ -126,11 +115,11 @@ int main() {
             pushToUndo();
             fullText += currentLine + "\n";
             currentLine.clear();
-            cout << "\n> " << flush;
+            screen << '\n';
             isStartOfWord = true;
         } else if (ch == 127) { // Backspace
             if (!currentLine.empty())
-                currentLine.pop_back();
+                popGrapheme(currentLine);
         } else {
             if (isStartOfWord) {
                 pushToUndo();
@@ -144,7 +133,9 @@ int main() {
             }
         }
 
-        cout << "\r> " << currentLine << "\033[K" << flush;
+        screen << "\r> " << currentLine;
+        screen.control("\033[K");
+        screen.flush();
     }
 
     cout << "\n[Exiting editor]\n";
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <termios.h>
 #include <unistd.h>
+#include "terminal.h"
+#include "utf8.h"
 
 using namespace std;
 
@@ -19,21 +21,6 @@ bool underlineActive = false;
 int currentLineIndex = 0;
 vector<string> lines;
 
-void enableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag &= ~(ICANON | ECHO);
-    term.c_iflag &= ~(IXON);
-    tcsetattr(0, TCSANOW, &term);
-}
-
-void disableRawMode() {
-    termios term;
-    tcgetattr(0, &term);
-    term.c_lflag |= (ICANON | ECHO);
-    tcsetattr(0, TCSANOW, &term);
-}
-
 void pushToUndo() {
     if (undoStack.empty() || undoStack.top() != currentLine) {
         undoStack.push(currentLine);
@@ -59,7 +46,7 @@ void handleRedo() {
 
 void handleDeleteLastWord() {
     pushToUndo();
-    size_t pos = currentLine.find_last_of(' ');
+    size_t pos = findLastSeparator(currentLine, currentLine.size());
     if (pos != string::npos)
         currentLine = currentLine.substr(0, pos);
     else
@@ -184,7 +171,7 @@ int main() {
             isStartOfWord = true;
         } else if (ch == 127) {
             if (!currentLine.empty()) {
-                currentLine.pop_back();
+                popGrapheme(currentLine);
                 if (currentLineIndex < lines.size())
                     lines[currentLineIndex] = currentLine;
             }
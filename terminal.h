@@ -0,0 +1,29 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+// Mode raw terminal yang dipakai semua varian editor: tanpa echo dan tanpa
+// buffering baris, dan Ctrl+S/Ctrl+Q tidak ditelan flow control (IXON).
+// `bracketedPaste`: terminal diminta mengirim paste sebagai satu blok.
+
+#include <iostream>
+#include <termios.h>
+#include <unistd.h>
+
+inline void enableRawMode(bool bracketedPaste = false) {
+    termios term;
+    tcgetattr(0, &term);
+    term.c_lflag &= ~(ICANON | ECHO);
+    term.c_iflag &= ~(IXON);
+    tcsetattr(0, TCSANOW, &term);
+    if (bracketedPaste) std::cout << "\033[?2004h" << std::flush;
+}
+
+inline void disableRawMode(bool bracketedPaste = false) {
+    termios term;
+    tcgetattr(0, &term);
+    term.c_lflag |= (ICANON | ECHO);
+    tcsetattr(0, TCSANOW, &term);
+    if (bracketedPaste) std::cout << "\033[?2004l" << std::flush;
+}
+
+#endif
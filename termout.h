@@ -0,0 +1,194 @@
+#ifndef TERMOUT_H
+#define TERMOUT_H
+
+// Output terminal per frame.
+//
+// Satu frame (seluruh layar atau satu baris edit) dikumpulkan dulu di buffer
+// lalu dikirim dengan satu write(). Buffer dipakai ulang antar frame, jadi
+// setelah frame pertama tidak ada alokasi lagi.
+//
+// Atribut teks (bold, italic, underline, reverse, warna depan) tidak ditulis
+// langsung sebagai escape: pemanggil mengatur atribut yang diinginkan, dan
+// satu SGR gabungan hanya dikeluarkan sebelum teks berikutnya, berisi
+// atribut yang memang berbeda dari yang sedang aktif di terminal. Toggle
+// bolak-balik atau warna yang sama berturut-turut tidak menghasilkan byte.
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <unistd.h>
+
+struct TextStyle {
+    bool bold = false;
+    bool italic = false;
+    bool underline = false;
+    bool reverse = false;
+    uint8_t fg = 39; // kode SGR warna depan, 39 = default
+
+    bool operator==(const TextStyle& other) const {
+        return bold == other.bold && italic == other.italic && underline == other.underline &&
+               reverse == other.reverse && fg == other.fg;
+    }
+    bool operator!=(const TextStyle& other) const { return !(*this == other); }
+};
+
+class TermWriter {
+public:
+    static const size_t INITIAL_CAPACITY = 64 * 1024;
+
+    explicit TermWriter(int fd = STDOUT_FILENO) : fd(fd) {
+        buffer.reserve(INITIAL_CAPACITY);
+    }
+
+    TermWriter(const TermWriter&) = delete;
+    TermWriter& operator=(const TermWriter&) = delete;
+
+    // Teks biasa; atribut yang tertunda dipasang dulu
+    TermWriter& operator<<(std::string_view text) {
+        if (text.empty()) return *this;
+        applyStyle();
+        buffer.append(text.data(), text.size());
+        return *this;
+    }
+
+    TermWriter& operator<<(const char* text) { return *this << std::string_view(text); }
+    TermWriter& operator<<(const std::string& text) { return *this << std::string_view(text); }
+
+    TermWriter& operator<<(char c) {
+        applyStyle();
+        buffer += c;
+        return *this;
+    }
+
+    TermWriter& operator<<(size_t value) {
+        applyStyle();
+        appendNumber(value);
+        return *this;
+    }
+
+    TermWriter& operator<<(int value) {
+        applyStyle();
+        appendNumber(value);
+        return *this;
+    }
+
+    // Escape selain SGR (clear screen, gerak kursor, hapus sampai akhir
+    // baris); tidak memasang atribut tertunda
+    TermWriter& control(std::string_view sequence) {
+        buffer.append(sequence.data(), sequence.size());
+        return *this;
+    }
+
+    // Gerak kursor n kolom ke kiri
+    TermWriter& cursorLeft(size_t n) {
+        if (n == 0) return *this;
+        buffer += "\033[";
+        appendNumber(n);
+        buffer += 'D';
+        return *this;
+    }
+
+    void bold(bool on) { want.bold = on; }
+    void italic(bool on) { want.italic = on; }
+    void underline(bool on) { want.underline = on; }
+    void reverse(bool on) { want.reverse = on; }
+    void color(uint8_t fg) { want.fg = fg; }
+    void style(const TextStyle& s) { want = s; }
+    void resetStyle() { want = TextStyle(); }
+    const TextStyle& currentStyle() const { return want; }
+
+    // Atribut yang tertunda langsung dikeluarkan (mis. di akhir frame, supaya
+    // terminal tidak tertinggal bold setelah program keluar)
+    void commitStyle() { applyStyle(); }
+
+    // State terminal tidak diketahui (awal program, setelah output lewat
+    // cout): kirim reset penuh dan mulai dari atribut default
+    void resetTerminal() {
+        buffer += "\033[0m";
+        have = TextStyle();
+        want = TextStyle();
+    }
+
+    // Kirim isi buffer dengan satu write() (diulang hanya jika ditulis
+    // sebagian); buffer dikosongkan tapi kapasitasnya dipertahankan
+    bool flush() {
+        if (buffer.empty()) return true;
+        frames++;
+        lastFrameBytes = buffer.size();
+        size_t done = 0;
+        bool ok = true;
+        while (done < buffer.size()) {
+            ssize_t n = ::write(fd, buffer.data() + done, buffer.size() - done);
+            writes++;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ok = false;
+                break;
+            }
+            done += (size_t)n;
+        }
+        bytes += done;
+        buffer.clear();
+        return ok;
+    }
+
+    uint64_t frameCount() const { return frames; }
+    uint64_t writeCount() const { return writes; }
+    uint64_t byteCount() const { return bytes; }
+    size_t lastFrameSize() const { return lastFrameBytes; }
+    size_t capacity() const { return buffer.capacity(); }
+
+    // Ringkasan untuk laporan memori
+    std::string stats() const {
+        std::string out = "[Layar] " + std::to_string(frames) + " frame";
+        if (frames > 0) {
+            char buf[96];
+            snprintf(buf, sizeof(buf), ", %.2f write/frame, %llu B/frame (terakhir %zu B)",
+                     (double)writes / frames, (unsigned long long)(bytes / frames), lastFrameBytes);
+            out += buf;
+        }
+        return out + ", buffer " + std::to_string(buffer.capacity() / 1024) + " KB\n";
+    }
+
+private:
+    int fd;
+    std::string buffer;
+    TextStyle have; // atribut yang aktif di terminal
+    TextStyle want; // atribut untuk teks berikutnya
+    uint64_t frames = 0;
+    uint64_t writes = 0;
+    uint64_t bytes = 0;
+    size_t lastFrameBytes = 0;
+
+    template<typename T>
+    void appendNumber(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr - digits);
+    }
+
+    void addParam(bool& first, int code) {
+        if (!first) buffer += ';';
+        first = false;
+        appendNumber(code);
+    }
+
+    // Satu SGR berisi hanya atribut yang berubah
+    void applyStyle() {
+        if (want == have) return;
+        buffer += "\033[";
+        bool first = true;
+        if (want.bold != have.bold) addParam(first, want.bold ? 1 : 22);
+        if (want.italic != have.italic) addParam(first, want.italic ? 3 : 23);
+        if (want.underline != have.underline) addParam(first, want.underline ? 4 : 24);
+        if (want.reverse != have.reverse) addParam(first, want.reverse ? 7 : 27);
+        if (want.fg != have.fg) addParam(first, want.fg);
+        buffer += 'm';
+        have = want;
+    }
+};
+
+#endif
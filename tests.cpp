@@ -0,0 +1,992 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <fstream>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "document.h"
+#include "diff.h"
+#include "textedit.h"
+#include "native.h"
+#include "crdt.h"
+#include "input.h"
+#include "collab.h"
+#include "wordlist.h"
+
+using namespace std;
+
+// Test inti editor, dijalankan lewat ctest. Setiap test membandingkan
+// struktur data dengan model sederhana (vector<string>, std::string) pada
+// operasi acak dengan seed tetap, jadi kegagalan selalu bisa diulang.
+// File sementara dibuat di direktori mkdtemp dan dihapus di akhir.
+
+static int failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            cout << "  GAGAL " << __FILE__ << ":" << __LINE__ << ": " #cond << endl; \
+            failures++;                                                          \
+            return;                                                              \
+        }                                                                        \
+    } while (0)
+
+static string tempDir;
+
+static string tempPath(const string& name) {
+    return tempDir + "/" + name;
+}
+
+static string dumpLines(Document& doc) {
+    string text;
+    for (size_t i = 0; i < doc.lineCount(); ++i) {
+        text += doc.lineAt(i);
+        text += '\n';
+    }
+    return text;
+}
+
+// Record mentah: yang di-commit terbaca lagi utuh dan berurutan, record
+// yang terpotong di akhir file diabaikan
+static void testJournalRecords() {
+    string path = tempPath("raw.journal");
+    vector<pair<JournalOp, string>> written;
+    {
+        Journal journal;
+        CHECK(journal.open(path));
+        CHECK(journal.reset(J_SNAPSHOT, "awal"));
+        written.push_back({J_SNAPSHOT, "awal"});
+        for (int i = 0; i < 500; ++i) {
+            string payload(i % 7, (char)('a' + i % 26));
+            journal.append(J_INSERT, payload);
+            written.push_back({J_INSERT, payload});
+        }
+        CHECK(journal.commit());
+        CHECK(journal.lastError() == 0);
+        journal.close();
+    }
+    vector<pair<JournalOp, string>> read;
+    Journal::replay(path, [&](JournalOp op, const string& payload) { read.push_back({op, payload}); });
+    CHECK(read == written);
+
+    // Potong di tengah record terakhir: record itu hilang, sisanya tetap
+    FILE* f = fopen(path.c_str(), "r+b");
+    CHECK(f);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    CHECK(truncate(path.c_str(), size - 3) == 0);
+    read.clear();
+    Journal::replay(path, [&](JournalOp op, const string& payload) { read.push_back({op, payload}); });
+    written.pop_back();
+    CHECK(read == written);
+    remove(path.c_str());
+}
+
+// Sesi edit acak (termasuk save, undo dan redo) lalu "crash" tanpa
+// finish(): dokumen yang dipulihkan dari journal sama dengan buffer terakhir
+static void testJournalRecovery() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    mt19937 rng(26);
+    string path = tempPath("recover.txt");
+    for (int round = 0; round < 20; ++round) {
+        FILE* f = fopen(path.c_str(), "w");
+        CHECK(f);
+        fputs("baris pertama\nbaris kedua\n", f);
+        fclose(f);
+        string live;
+        {
+            Document doc(path, &pool, &swap, &log);
+            doc.start(true);
+            if (round % 2) doc.journal.checkpointRecords = 50;
+            for (int step = 0; step < 800; ++step) {
+                int r = rng() % 100;
+                if (r < 60) doc.recordOp(J_INSERT, "ab cd"[rng() % 5]);
+                else if (r < 67) doc.recordOp(J_NEWLINE);
+                else if (r < 72) doc.recordOp(J_BACKSPACE);
+                else if (r < 75) doc.recordOp(J_MOVE_UP);
+                else if (r < 78) doc.recordOp(J_DELETE_WORD);
+                else if (r < 84) doc.recordOp(J_UNDO);
+                else if (r < 88) doc.recordOp(J_REDO);
+                else if (r < 91) doc.recordOp(J_MOVE_LEFT);
+                else if (r < 93) doc.recordOp(J_PASTE, "tempel\nbanyak\nbaris");
+                else if (r < 94) CHECK(doc.save());
+                else doc.recordOp(J_END);
+            }
+            live = dumpLines(doc);
+            CHECK(doc.journal.commit());
+        }
+        Document recovered(path, &pool, &swap, &log);
+        recovered.start(true);
+        CHECK(dumpLines(recovered) == live);
+        recovered.finish();
+    }
+    remove(path.c_str());
+}
+
+// LineStore dan LineIndex di bawahnya dibandingkan dengan vector<string>,
+// termasuk statistik byte/kata/karakter dan AttrStats yang dijumlahkan di
+// B+tree (AttrStats ikut barisnya, set() tidak mengubahnya). Snapshot
+// yang diambil di tengah jalan tetap berisi model saat itu walaupun store
+// terus diedit (daun copy-on-write).
+static void testLineStore() {
+    mt19937 rng(33);
+    LineStore store;
+    vector<string> model;
+    vector<AttrStats> attrModel;
+    shared_ptr<LineStore::Snapshot> snapshot;
+    vector<string> snapshotModel;
+    auto checkSnapshot = [&]() {
+        vector<string_view> views;
+        snapshot->lines(views);
+        bool same = views.size() == snapshotModel.size() && snapshot->size() == snapshotModel.size();
+        for (size_t i = 0; same && i < views.size(); ++i)
+            same = views[i] == snapshotModel[i];
+        store.release(*snapshot);
+        snapshot.reset();
+        return same;
+    };
+    auto randomLine = [&]() {
+        static const char* pieces[] = {"kata", " ", "é", "  ", "data", "\t", "日本", ""};
+        string line;
+        size_t n = rng() % 8;
+        for (size_t i = 0; i < n; ++i)
+            line += pieces[rng() % 8];
+        if (rng() % 200 == 0)
+            line += string(70000, 'x'); // baris besar di luar blok arena
+        return line;
+    };
+    for (int step = 0; step < 40000; ++step) {
+        int r = rng() % 100;
+        if (r < 35 || model.empty()) {
+            size_t at = model.empty() ? 0 : rng() % (model.size() + 1);
+            string line = randomLine();
+            store.insert(at, line);
+            model.insert(model.begin() + at, line);
+            attrModel.insert(attrModel.begin() + at, AttrStats());
+        } else if (r < 55) {
+            string line = randomLine();
+            store.push_back(line);
+            model.push_back(line);
+            attrModel.push_back(AttrStats());
+        } else if (r < 65) {
+            size_t at = rng() % model.size();
+            AttrStats attrs;
+            if (rng() % 4)
+                attrs.chars[rng() % AttrStats::KINDS] = rng() % 50;
+            store.setAttrStats(at, attrs);
+            attrModel[at] = attrs;
+        } else if (r < 75) {
+            size_t at = rng() % model.size();
+            string line = randomLine();
+            store.set(at, line);
+            model[at] = line;
+        } else if (r < 93) {
+            size_t at = rng() % model.size();
+            store.erase(at);
+            model.erase(model.begin() + at);
+            attrModel.erase(attrModel.begin() + at);
+        } else {
+            size_t first = rng() % (model.size() + 1);
+            size_t count = min<size_t>(rng() % 600, model.size() - first);
+            vector<string> with(rng() % 600);
+            for (string& line : with)
+                line = randomLine();
+            store.replace(first, count, vector<string_view>(with.begin(), with.end()));
+            model.erase(model.begin() + first, model.begin() + first + count);
+            model.insert(model.begin() + first, with.begin(), with.end());
+            size_t same = min(count, with.size());
+            attrModel.erase(attrModel.begin() + first + same, attrModel.begin() + first + count);
+            attrModel.insert(attrModel.begin() + first + same, with.size() - same, AttrStats());
+        }
+        if (step % 1000 == 999) {
+            size_t first = rng() % (model.size() + 1);
+            size_t last = first + rng() % (model.size() - first + 1);
+            AttrStats expect;
+            for (size_t i = first; i < last; ++i)
+                expect += attrModel[i];
+            CHECK(store.attrStats(first, last) == expect);
+        }
+        if (step % 4000 == 3999)
+            store.compact(); // ditunda selama snapshot masih dipegang
+        if (step % 3000 == 1000) {
+            snapshot = store.snapshot();
+            snapshotModel = model;
+        } else if (step % 3000 == 2500) {
+            CHECK(checkSnapshot());
+        }
+    }
+    if (snapshot)
+        CHECK(checkSnapshot());
+    CHECK(store.size() == model.size());
+    LineStats expect;
+    for (size_t i = 0; i < model.size(); ++i) {
+        CHECK(store[i] == model[i]);
+        expect += LineStats::of(model[i]);
+    }
+    const LineStats& stats = store.stats();
+    CHECK(stats.bytes == expect.bytes);
+    CHECK(stats.words == expect.words);
+    CHECK(stats.chars == expect.chars);
+    AttrStats attrs;
+    for (const AttrStats& a : attrModel)
+        attrs += a;
+    CHECK(store.attrStats() == attrs);
+    store.clearAttrStats();
+    CHECK(store.attrStats() == AttrStats() && store.attrStats(0, store.size()) == AttrStats());
+    size_t i = 0;
+    for (string_view line : store)
+        CHECK(line == model[i++]);
+}
+
+static uint64_t lineHash(const string& line) {
+    return hash<string>()(line) | 1;
+}
+
+// Hunk diffLines diterapkan ke sisi lama menghasilkan sisi baru, dan baris
+// di luar hunk memang sama
+static void testDiff() {
+    mt19937 rng(41);
+    for (int round = 0; round < 200; ++round) {
+        vector<string> oldLines(rng() % 300);
+        for (string& line : oldLines)
+            line = to_string(rng() % 40);
+        vector<string> newLines = oldLines;
+        int edits = round % 3 == 0 ? 200 : (int)(rng() % 12);
+        for (int e = 0; e < edits; ++e) {
+            size_t at = newLines.empty() ? 0 : rng() % (newLines.size() + 1);
+            int r = rng() % 3;
+            if (r == 0 || newLines.empty() || at == newLines.size())
+                newLines.insert(newLines.begin() + at, to_string(rng() % 60));
+            else if (r == 1)
+                newLines.erase(newLines.begin() + at);
+            else
+                newLines[at] = to_string(rng() % 60);
+        }
+        vector<uint64_t> a, b;
+        for (const string& line : oldLines) a.push_back(lineHash(line));
+        for (const string& line : newLines) b.push_back(lineHash(line));
+
+        vector<DiffHunk> hunks = diffLines(a, b);
+        vector<string> patched;
+        size_t oldAt = 0, newAt = 0;
+        for (const DiffHunk& h : hunks) {
+            CHECK(h.oldStart >= oldAt && h.newStart >= newAt);
+            CHECK(h.oldStart - oldAt == h.newStart - newAt);
+            for (; oldAt < h.oldStart; ++oldAt, ++newAt) {
+                CHECK(oldLines[oldAt] == newLines[newAt]);
+                patched.push_back(oldLines[oldAt]);
+            }
+            for (uint32_t k = 0; k < h.newCount; ++k)
+                patched.push_back(newLines[h.newStart + k]);
+            oldAt += h.oldCount;
+            newAt += h.newCount;
+        }
+        CHECK(oldLines.size() - oldAt == newLines.size() - newAt);
+        patched.insert(patched.end(), oldLines.begin() + oldAt, oldLines.end());
+        CHECK(patched == newLines);
+    }
+}
+
+static EditOp randomEdits(mt19937& rng, uint64_t length) {
+    EditOp op;
+    int n = 1 + rng() % 4;
+    for (int i = 0; i < n; ++i) {
+        uint64_t pos = rng() % (length + 1);
+        if (rng() % 2 || length == 0) {
+            string text(1 + rng() % 4, (char)('A' + rng() % 26));
+            op.push_back(TextEdit::insertion(pos, text));
+            length += text.size();
+        } else {
+            uint64_t len = min<uint64_t>(1 + rng() % 5, length - pos);
+            op.push_back(TextEdit::deletion(pos, len));
+            length -= len;
+        }
+    }
+    return op;
+}
+
+// transform(a, b): teks + a + b' == teks + b + a', dan serialisasi EditOp
+// bolak-balik tanpa perubahan
+static void testTransform() {
+    mt19937 rng(43);
+    for (int round = 0; round < 20000; ++round) {
+        string base(rng() % 20, 'x');
+        for (char& c : base)
+            c = (char)('a' + rng() % 26);
+        EditOp a = randomEdits(rng, base.size());
+        EditOp b = randomEdits(rng, base.size());
+
+        string encoded;
+        encodeEdits(encoded, a);
+        EditOp decoded;
+        CHECK(decodeEdits(encoded.data(), encoded.size(), decoded));
+        string viaDecoded = base, viaA = base;
+        applyEdits(viaDecoded, decoded);
+        applyEdits(viaA, a);
+        CHECK(viaDecoded == viaA);
+
+        EditOp a2 = a, b2 = b;
+        transform(a2, b2);
+        string left = base, right = base;
+        applyEdits(left, a);
+        applyEdits(left, b2);
+        applyEdits(right, b);
+        applyEdits(right, a2);
+        CHECK(left == right);
+    }
+}
+
+// writeNative lalu NativeFile::open + loadInto mengembalikan baris, atribut
+// dan riwayat yang sama; file yang bukan native ditolak tanpa crash
+static void testNativeRoundTrip() {
+    mt19937 rng(46);
+    string path = tempPath("dokumen.pkd");
+    for (int round = 0; round < 10; ++round) {
+        vector<string> lines(rng() % 5000);
+        for (string& line : lines) {
+            line.assign(rng() % 40, 'a');
+            for (char& c : line)
+                c = (char)(' ' + rng() % 90);
+        }
+        if (round % 3 == 0)
+            lines.push_back(string(100000 + rng() % 1000, 'z'));
+        string attrs = "atribut" + to_string(round);
+        string history(rng() % 3000, 'h');
+        CHECK(writeNative(path, vector<string_view>(lines.begin(), lines.end()), attrs, history));
+
+        NativeFile file;
+        CHECK(file.open(path));
+        CHECK(!file.corrupt());
+        CHECK(file.lineCount() == lines.size());
+        CHECK(file.attrs() == attrs);
+        CHECK(file.history() == history);
+        LineStore store;
+        file.loadInto(store);
+        file.close(); // mapping tetap hidup lewat store
+        CHECK(store.size() == lines.size());
+        LineStats expect;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            CHECK(store[i] == lines[i]);
+            expect += LineStats::of(lines[i]);
+        }
+        CHECK(store.stats().bytes == expect.bytes);
+        CHECK(store.stats().words == expect.words);
+    }
+
+    FILE* f = fopen(path.c_str(), "w");
+    CHECK(f);
+    fputs("teks biasa, bukan .pkd\n", f);
+    fclose(f);
+    NativeFile plain;
+    CHECK(!plain.open(path));
+    CHECK(!plain.isOpen() && !plain.corrupt());
+    CHECK(plain.lineCount() == 0 && plain.attrs().empty() && plain.history().empty());
+    remove(path.c_str());
+}
+
+// AttrStats di B+tree sama dengan hitungan ulang dari FormatSpans setelah
+// ketik/hapus/pindah baris/undo/redo berformat acak, dan terbaca lagi dari
+// atribut file native
+static void testFormatStats() {
+    mt19937 rng(39);
+    string path = tempPath("format.pkd");
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    auto recount = [](Document& doc) {
+        AttrStats s;
+        for (const FormattedLine& f : doc.formats.lines())
+            s += attrStatsOf(doc.lines[f.line], &f.attrs);
+        return s;
+    };
+    AttrStats saved;
+    {
+        fclose(fopen(path.c_str(), "w")); // .pkd kosong: dibaca sebagai teks, disimpan native
+        Document doc(path, &pool, &swap, &log);
+        doc.start(true);
+        static const JournalOp ops[] = {J_TOGGLE_BOLD, J_TOGGLE_ITALIC, J_TOGGLE_UNDERLINE, J_NEWLINE,
+                                        J_BACKSPACE, J_UNDO, J_REDO, J_MOVE_UP, J_MOVE_LEFT,
+                                        J_MOVE_LINE_UP, J_JOIN_LINE, J_DELETE_LINE};
+        for (int step = 0; step < 3000; ++step) {
+            unsigned r = rng() % 100;
+            if (r < 50)
+                doc.recordOp(J_INSERT, (char)(r % 10 ? 'a' + rng() % 26 : ' '));
+            else if (r < 53)
+                doc.recordOp(J_PASTE, string("é日\nba"));
+            else
+                doc.recordOp(ops[rng() % (sizeof(ops) / sizeof(ops[0]))]);
+            if (step % 50 == 49) {
+                AttrStats expect = recount(doc);
+                CHECK(doc.attrStats() == expect);
+                CHECK(doc.lines.attrStats(0, doc.lines.size()) == expect);
+            }
+        }
+        saved = doc.attrStats();
+        CHECK(saved != AttrStats());
+        CHECK(doc.save());
+        doc.finish();
+    }
+    Document reopened(path, &pool, &swap, &log);
+    reopened.start(true);
+    CHECK(reopened.attrStats() == saved);
+    CHECK(recount(reopened) == saved);
+    reopened.finish();
+    remove(path.c_str());
+}
+
+// lzCompress biasa dan lazy (blok dingin) sama-sama kembali utuh lewat
+// lzDecompress, untuk teks log, byte acak dan pola yang berulang pendek
+static void testLz() {
+    mt19937 rng(40);
+    vector<string> inputs;
+    string log;
+    for (size_t i = 0; log.size() < LZ_MAX_INPUT - 100; ++i)
+        log += "2024-05-01 12:00:" + to_string(i % 60) + " [INFO] request " + to_string(i * 7919) + " done\n";
+    inputs.push_back(log);
+    string noise(LZ_MAX_INPUT, '\0');
+    for (char& c : noise)
+        c = (char)rng();
+    inputs.push_back(noise);
+    inputs.push_back(string(LZ_MAX_INPUT, 'a'));
+    inputs.push_back("abcabcabcabcabcab");
+    inputs.push_back("abc");
+    inputs.push_back("");
+    for (const string& input : inputs) {
+        string packed[2];
+        for (int lazy = 0; lazy < 2; ++lazy) {
+            lzCompress(input.data(), input.size(), packed[lazy], lazy);
+            string back(input.size(), '\0');
+            CHECK(lzDecompress(packed[lazy].data(), packed[lazy].size(), &back[0], back.size()) == (long)input.size());
+            CHECK(back == input);
+        }
+        if (&input == &inputs[0])
+            CHECK(packed[1].size() < packed[0].size());
+    }
+}
+
+// Byte tidak valid diganti U+FFFD saat paste; backspace di deretan bendera
+// panjang tetap menghapus satu bendera (dua regional indicator)
+static void testUtf8() {
+    string text = "ok \xff\xc3 \xe2\x82";
+    CHECK(!validateUtf8(text));
+    CHECK(repairUtf8(text));
+    CHECK(validateUtf8(text));
+    CHECK(text == "ok \xef\xbf\xbd\xef\xbf\xbd \xef\xbf\xbd\xef\xbf\xbd");
+
+    const string flag = "\xf0\x9f\x87\xae\xf0\x9f\x87\xa9"; // ID
+    string flags;
+    for (int i = 0; i < 1000; ++i)
+        flags += flag;
+    size_t pos = flags.size();
+    for (int i = 0; i < 1000; ++i) {
+        size_t prev = prevGrapheme(flags, pos);
+        CHECK(pos - prev == flag.size());
+        pos = prev;
+    }
+    CHECK(pos == 0);
+
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    Document doc(tempPath("paste.txt"), &pool, &swap, &log);
+    doc.start(false);
+    doc.recordOp(J_PASTE, string("a\x80" "b\nc\xf0"));
+    CHECK(doc.lineCount() == 2);
+    CHECK(doc.lineAt(0) == "a\xef\xbf\xbd" "b");
+    CHECK(doc.lineAt(1) == "c\xef\xbf\xbd");
+    doc.finish();
+}
+
+// Dua replika mengetik dan Backspace bersamaan, op dikirim di tengah jalan
+// (antrean keluar dikosongkan), Backspace ketikan yang belum dikirim tidak
+// meninggalkan tombstone, dan kedua replika sampai ke teks yang sama
+static void testCrdt() {
+    CrdtText a(1), b(2);
+    vector<CrdtOp> out;
+    a.insert(0, "abc", out);
+    a.remove(2, 1, out);
+    a.insert(2, "d", out);
+    CHECK(a.text() == "abd");
+    CHECK(a.itemCount() == 1);
+    CHECK(out.size() == 1 && out[0].text == "abd");
+    b.merge(out);
+    CHECK(b.text() == "abd");
+
+    mt19937 rng(7);
+    CrdtText* docs[] = {&a, &b};
+    vector<CrdtOp> queued[2];
+    size_t cursor[2] = {0, 0};
+    for (int round = 0; round < 200; ++round) {
+        for (int d = 0; d < 2; ++d) {
+            CrdtText& doc = *docs[d];
+            for (int k = 0; k < 50; ++k) {
+                unsigned r = rng() % 100;
+                if (r < 5 || cursor[d] > doc.size()) {
+                    cursor[d] = rng() % (doc.size() + 1);
+                } else if (r < 25 && cursor[d] > 0) {
+                    doc.remove(--cursor[d], 1, queued[d]);
+                } else {
+                    doc.insert(cursor[d], string(1, (char)('a' + rng() % 26)), queued[d]);
+                    cursor[d]++;
+                }
+            }
+        }
+        if (rng() % 3 == 0) {
+            a.merge(queued[1]);
+            b.merge(queued[0]);
+            queued[0].clear();
+            queued[1].clear();
+        }
+    }
+    a.merge(queued[1]);
+    b.merge(queued[0]);
+    CHECK(a.text() == b.text());
+    CHECK(a.pendingOps() == 0 && b.pendingOps() == 0);
+}
+
+// Byte dimasukkan satu per satu seperti datang dari read() yang terpotong
+// di mana saja: sequence yang terbelah tetap jadi satu tombol, ESC sendirian
+// baru jadi KEY_ESCAPE lewat flush, CSI tak dikenal dibuang sampai byte
+// penutupnya, dan isi bracketed paste tidak pernah dibaca sebagai tombol
+static void testInputDecoder() {
+    InputDecoder decoder;
+    auto feedAll = [&](const string& bytes) {
+        vector<KeyEvent> events;
+        KeyEvent event;
+        for (char c : bytes)
+            if (decoder.feed(c, event)) events.push_back(event);
+        return events;
+    };
+
+    CHECK(feedAll("\033[1;").empty());
+    CHECK(decoder.pending());
+    vector<KeyEvent> events = feedAll("5C");
+    CHECK(events.size() == 1 && events[0].action == KEY_WORD_RIGHT);
+    CHECK(!decoder.pending());
+
+    CHECK(feedAll("\033").empty());
+    KeyEvent event;
+    CHECK(decoder.flush(event) && event.action == KEY_ESCAPE);
+    CHECK(feedAll("\033[").empty());
+    CHECK(!decoder.flush(event)); // sequence terputus dibuang
+
+    events = feedAll("\033[99;2~x\033\033[A\033OH");
+    CHECK(events.size() == 3);
+    CHECK(events[0].action == KEY_INSERT && events[0].ch == 'x');
+    CHECK(events[1].action == KEY_UP);
+    CHECK(events[2].action == KEY_HOME);
+
+    const string utf8 = "é日";
+    events = feedAll(utf8 + "\x13\x7f");
+    CHECK(events.size() == utf8.size() + 2);
+    for (size_t i = 0; i < utf8.size(); ++i)
+        CHECK(events[i].action == KEY_INSERT && events[i].ch == utf8[i]);
+    CHECK(events[utf8.size()].action == KEY_SAVE && events[utf8.size() + 1].action == KEY_BACKSPACE);
+
+    const string pasted = "baris\n\033[A\x18 \033[201 ~ akhir";
+    events = feedAll("\033[200~" + pasted.substr(0, 9));
+    CHECK(events.empty());
+    events = feedAll(pasted.substr(9) + "\033[201~a");
+    CHECK(events.size() == 2);
+    CHECK(events[0].action == KEY_PASTE && decoder.pasted == pasted);
+    CHECK(events[1].action == KEY_INSERT && events[1].ch == 'a');
+}
+
+// SyntaxCache yang diberi tahu setiap perubahan baris (linesChanged, touch)
+// menghasilkan state yang sama dengan tokenize ulang dari baris 0, untuk
+// baris [0, upTo) yang diminta; edit yang tidak mengubah state akhir baris
+// tidak men-tokenize ulang sisa dokumen
+static void testSyntaxCache() {
+    mt19937 rng(35);
+    static const char* pieces[] = {"int x = 1;", "/* buka", "tutup */", "s = \"/*\";", "// komentar /*", "", "a */ b /* c"};
+    vector<string> lines(400, "int x = 1;");
+    auto lineAt = [&](size_t i) { return string_view(lines[i]); };
+    SyntaxCache cache(&C_HIGHLIGHTER);
+    CHECK(cache.update(lines.size(), lineAt) == lines.size());
+    lines[200] = "int y;";
+    cache.touch(200);
+    CHECK(cache.update(lines.size(), lineAt) == 1);
+    lines[200] = "int z;"; // state lama dilupakan: satu baris sesudahnya ikut dicek
+    cache.linesChanged(200, 1, 1);
+    CHECK(cache.update(lines.size(), lineAt) == 2);
+
+    for (int step = 0; step < 3000; ++step) {
+        unsigned r = rng() % 100;
+        size_t at = rng() % (lines.size() + 1);
+        if (r < 40 && at < lines.size()) {
+            lines[at] = pieces[rng() % 7];
+            if (r < 10)
+                cache.touch(at); // baris aktif Document, jumlah baris tetap
+            else
+                cache.linesChanged(at, 1, 1);
+        } else if (r < 70) {
+            size_t n = 1 + rng() % 3;
+            for (size_t k = 0; k < n; ++k)
+                lines.insert(lines.begin() + at, pieces[rng() % 7]);
+            cache.linesChanged(at, 0, n);
+        } else if (lines.size() > 1) {
+            size_t n = min<size_t>(1 + rng() % 3, lines.size() - min(at, lines.size() - 1));
+            at = min(at, lines.size() - n);
+            lines.erase(lines.begin() + at, lines.begin() + at + n);
+            cache.linesChanged(at, n, 0);
+        }
+        size_t upTo = step % 5 == 0 ? lines.size() : rng() % (lines.size() + 1);
+        cache.update(upTo, lineAt);
+        uint8_t state = 0;
+        for (size_t i = 0; i < upTo; ++i) {
+            CHECK(cache.startState(i) == state);
+            state = C_HIGHLIGHTER.tokenize(lines[i], state, nullptr);
+        }
+    }
+}
+
+// Mengetik di beberapa kursor sekaligus jadi satu grup undo: satu undo
+// membatalkan kata yang diketik di semua baris, satu redo memasangnya lagi
+static void testMultiCursorUndo() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    Document doc(tempPath("multi.txt"), &pool, &swap, &log);
+    doc.start(false);
+    doc.recordOp(J_PASTE, string("foo 1\nfoo 2\nx foo 3\nfoo"));
+    const string before = dumpLines(doc);
+    doc.recordOp(J_ADD_CURSORS_AT_WORD);
+    CHECK(doc.extraCursors.size() == 3);
+    for (char c : string("bar"))
+        doc.recordOp(J_INSERT, c);
+    doc.recordOp(J_BACKSPACE);
+    const string typed = "fooba 1\nfooba 2\nx fooba 3\nfooba\n";
+    CHECK(dumpLines(doc) == typed);
+    doc.recordOp(J_UNDO);
+    CHECK(dumpLines(doc) == before);
+    doc.recordOp(J_REDO);
+    CHECK(dumpLines(doc) == typed);
+    doc.recordOp(J_UNDO);
+    doc.recordOp(J_UNDO); // paste
+    CHECK(dumpLines(doc) == "\n");
+    doc.recordOp(J_REDO);
+    CHECK(dumpLines(doc) == before);
+    doc.finish();
+}
+
+// fd file spill ManualStack yang sedang terbuka (file anonim di /tmp)
+static int spillFd() {
+    for (int fd = 3; fd < 1024; ++fd) {
+        char link[64], target[256];
+        snprintf(link, sizeof(link), "/proc/self/fd/%d", fd);
+        ssize_t n = readlink(link, target, sizeof(target) - 1);
+        if (n <= 0) continue;
+        target[n] = 0;
+        if (strstr(target, "/tmp/editor-undo-")) return fd;
+    }
+    return -1;
+}
+
+// Stack ber-budget: entri lama di-spill dan kembali urut LIFO saat di-pop,
+// memori tetap di sekitar budget, clear() menyerahkan semua entri (termasuk
+// yang di file) ke onDrop, dan file spill yang gagal dibaca membuang entri
+// yang lebih tua tanpa merusak top()
+static void testManualStack() {
+    const size_t BUDGET = 64 * 1024;
+    const uint32_t N = 20000;
+    auto delta = [](uint32_t i) {
+        EditDelta d;
+        d.line = i;
+        d.text.push_back("baris " + to_string(i) + string(i % 50, 'x'));
+        return d;
+    };
+    auto matches = [&](const EditDelta& d, uint32_t i) {
+        return d.line == i && d.text.size() == 1 && d.text[0] == delta(i).text[0];
+    };
+    ManualStack<EditDelta> stack;
+    size_t dropped = 0;
+    stack.onDrop = [&](const EditDelta&) { dropped++; };
+    stack.setBudget(BUDGET);
+    CHECK(stack.memoryBytes() < 1024); // ring belum dialokasikan
+
+    for (uint32_t i = 0; i < N; ++i)
+        stack.push(delta(i));
+    stack.waitForWriter();
+    CHECK(stack.size() == N);
+    CHECK(stack.spilled() > N / 2);
+    CHECK(stack.memoryBytes() < 4 * BUDGET);
+    for (uint32_t i = N; i-- > 0;) {
+        CHECK(matches(stack.top(), i));
+        stack.pop();
+    }
+    CHECK(stack.empty() && stack.size() == 0);
+    CHECK(dropped == 0);
+
+    for (uint32_t i = 0; i < N; ++i)
+        stack.push(delta(i));
+    stack.waitForWriter();
+    stack.clear();
+    CHECK(dropped == N);
+    CHECK(stack.empty());
+
+    for (uint32_t i = 0; i < N; ++i)
+        stack.push(delta(i));
+    stack.waitForWriter();
+    int fd = spillFd();
+    CHECK(fd >= 0);
+    CHECK(ftruncate(fd, 0) == 0);
+    uint32_t next = N;
+    while (!stack.top().text.empty()) {
+        CHECK(next > 0 && matches(stack.top(), --next));
+        stack.pop();
+    }
+    CHECK(next > 0 && next < N); // ring dan pending terbaca, batch di file hilang
+    CHECK(stack.empty());
+    stack.pop(); // stack kosong: tidak apa-apa
+    stack.push(delta(7));
+    CHECK(matches(stack.top(), 7) && stack.size() == 1);
+}
+
+// Node kata yang terlepas dimiliki tepat satu record: jumlah node terpakai
+// selalu = kata di daftar + kata terhapus di undo + input yang di-undo di
+// redo, jadi redo yang dikosongkan tidak membocorkan node
+static void testWordListOwnership() {
+    char cwd[4096];
+    CHECK(getcwd(cwd, sizeof(cwd)) != nullptr);
+    CHECK(chdir(tempDir.c_str()) == 0); // TextEditor menulis .log.txt di direktori kerja
+    mt19937 rng(50);
+    bool owned = true;
+    {
+        TextEditor editor;
+        vector<bool> undoModel, redoModel; // WordEdit::inserted
+        for (int step = 0; step < 20000 && owned; ++step) {
+            unsigned r = rng() % 100;
+            if (r < 30) {
+                size_t n = 1 + rng() % 3;
+                string text;
+                for (size_t k = 0; k < n; ++k)
+                    text += "kata" + to_string(rng() % 100) + " ";
+                editor.addInput(text);
+                undoModel.insert(undoModel.end(), n, true);
+                redoModel.clear();
+            } else if (r < 45) {
+                if (editor.wordList().size()) {
+                    undoModel.push_back(false);
+                    redoModel.clear();
+                }
+                editor.deleteLastWord();
+            } else if (r < 80) {
+                if (!undoModel.empty()) {
+                    redoModel.push_back(undoModel.back());
+                    undoModel.pop_back();
+                }
+                editor.undo();
+            } else {
+                if (!redoModel.empty()) {
+                    undoModel.push_back(redoModel.back());
+                    redoModel.pop_back();
+                }
+                editor.redo();
+            }
+            size_t held = count(undoModel.begin(), undoModel.end(), false) +
+                          count(redoModel.begin(), redoModel.end(), true);
+            owned = editor.wordList().allocated() == editor.wordList().size() + held;
+        }
+    }
+    CHECK(chdir(cwd) == 0);
+    CHECK(owned);
+}
+
+// Ekspor ke file: tag/escape per format persis seperti yang diharapkan, dan
+// dokumen yang lebih besar dari buffer ChunkWriter tetap utuh
+static void testExport() {
+    vector<string> text = {"a <b> & c", "tebal miring", "", "# judul"};
+    vector<string_view> lines(text.begin(), text.end());
+    vector<FormattedLine> spans = {{1, {{5, ATTR_BOLD}, {1, 0}, {6, ATTR_ITALIC}}}};
+    auto readAll = [](const string& path) {
+        ifstream in(path, ios::binary);
+        return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    };
+    string path = tempPath("ekspor.out");
+    CHECK(exportLines(path, EXPORT_HTML, lines, spans, "t&"));
+    CHECK(readAll(path) ==
+          "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>t&amp;</title>\n</head>\n<body>\n<pre>\n"
+          "a &lt;b&gt; &amp; c\n<b>tebal</b> <i>miring</i>\n\n# judul\n</pre>\n</body>\n</html>\n");
+    CHECK(exportLines(path, EXPORT_MARKDOWN, lines, spans));
+    CHECK(readAll(path) == "a \\<b\\> \\& c\\\n**tebal** *miring*\n\n\\# judul\n");
+    CHECK(exportLines(path, EXPORT_ANSI, lines, spans));
+    CHECK(readAll(path) == "a <b> & c\n\033[0;1mtebal\033[0m \033[0;3mmiring\033[0m\n\n# judul\n");
+
+    vector<string> big(200000);
+    string expect;
+    for (size_t i = 0; i < big.size(); ++i) {
+        big[i] = "x&" + to_string(i);
+        expect += "x&amp;" + to_string(i) + "\n";
+    }
+    CHECK(exportLines(path, EXPORT_HTML, vector<string_view>(big.begin(), big.end()), {}));
+    string html = readAll(path);
+    size_t body = html.find("<pre>\n") + 6;
+    CHECK(html.compare(body, expect.size(), expect) == 0);
+    CHECK(html.size() - body - expect.size() == strlen("</pre>\n</body>\n</html>\n"));
+    CHECK(!exportLines(tempPath("tidak/ada.html"), EXPORT_HTML, lines, spans));
+
+    ExportFormat format;
+    CHECK(exportFormatFor("a.md", format) && format == EXPORT_MARKDOWN);
+    CHECK(!exportFormatFor("a.txt", format));
+    remove(path.c_str());
+}
+
+// Server dan dua klien dalam satu EventLoop, lewat Unix socket sungguhan,
+// mengetik bersamaan di posisi acak; setelah semua ack ketiganya sama
+static void testCollab() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    string path = tempPath("bersama.txt");
+    {
+        Document seed(path, &pool, &swap, &log);
+        string text;
+        for (int i = 0; i < 200; ++i)
+            text += "baris " + to_string(i) + " teks bersama\n";
+        seed.insertText(text);
+        CHECK(seed.save());
+    }
+    EventLoop loop;
+    Document host(path, &pool, &swap, &log);
+    host.start(true);
+    CollabServer server(host, loop);
+    CHECK(server.listen(tempPath("bersama.sock")));
+    vector<unique_ptr<Document>> docs;
+    vector<unique_ptr<CollabClient>> clients;
+    loop.afterEvents = [&] {
+        server.flush();
+        for (auto& client : clients)
+            client->flush();
+    };
+    for (int i = 0; i < 2; ++i) {
+        clients.emplace_back(new CollabClient(loop));
+        CHECK(clients.back()->connect(tempPath("bersama.sock")));
+        while (!clients.back()->handshake(false) && clients.back()->connected())
+            loop.poll(10);
+        CHECK(clients.back()->connected());
+        docs.emplace_back(new Document(clients.back()->documentName(), &pool, &swap, &log));
+        docs.back()->shared = true;
+        clients.back()->attach(*docs.back());
+    }
+    CHECK(server.clientCount() == 2);
+
+    mt19937 rng(43);
+    Document* editors[] = {&host, docs[0].get(), docs[1].get()};
+    for (int frame = 0; frame < 300; ++frame) {
+        for (Document* doc : editors) {
+            for (int k = 0; k < 3; ++k) {
+                unsigned r = rng() % 100;
+                if (r < 5)
+                    doc->moveTo(rng() % doc->lines.size());
+                else if (r < 10)
+                    doc->applyOp(J_NEWLINE, "");
+                else if (r < 20)
+                    doc->applyOp(J_BACKSPACE, "");
+                else
+                    doc->applyOp(J_INSERT, string(1, "abcé "[rng() % 4]));
+            }
+        }
+        loop.afterEvents();
+        while (loop.poll(0) > 0) {}
+    }
+    for (int i = 0; i < 1000; ++i) {
+        loop.afterEvents();
+        bool idle = loop.poll(5) == 0;
+        for (auto& client : clients)
+            idle = idle && client->idle();
+        if (idle) break;
+    }
+    host.commitCurrentLine();
+    string expected = collabDocumentText(host);
+    CHECK(server.revision() > 0);
+    for (auto& doc : docs) {
+        doc->commitCurrentLine();
+        CHECK(collabDocumentText(*doc) == expected);
+    }
+    host.finish();
+}
+
+// File yang hanya bertambah dibaca dari offset terakhir (potongan tanpa \n
+// menyambung baris terakhir), file yang dipotong dibaca ulang, dan buffer
+// yang belum disimpan tidak ditimpa
+static void testFollowAppend() {
+    PagePool pool;
+    SwapFile swap;
+    ActionLog log;
+    string path = tempPath("ikuti.log");
+    auto write = [&](const string& text, ios::openmode mode) {
+        ofstream out(path, ios::binary | mode);
+        out << text;
+    };
+    write("a\nb\n", ios::trunc);
+    Document doc(path, &pool, &swap, &log);
+    doc.start(true);
+    CHECK(dumpLines(doc) == "a\nb\n");
+    CHECK(doc.syncWithDisk() == DISK_NONE);
+    write("c\nd", ios::app);
+    CHECK(doc.syncWithDisk() == DISK_APPENDED);
+    CHECK(dumpLines(doc) == "a\nb\nc\nd\n");
+    write("e\nf\n", ios::app);
+    CHECK(doc.syncWithDisk() == DISK_APPENDED);
+    CHECK(dumpLines(doc) == "a\nb\nc\nde\nf\n");
+    CHECK(!doc.modified);
+
+    write("x\n", ios::trunc);
+    CHECK(doc.syncWithDisk() == DISK_RELOADED);
+    CHECK(dumpLines(doc) == "x\n");
+    doc.recordOp(J_INSERT, 'y');
+    write("z\n", ios::app);
+    CHECK(doc.syncWithDisk() == DISK_CONFLICT);
+    CHECK(dumpLines(doc) == "xy\n");
+    doc.finish();
+}
+
+int main() {
+    char dir[] = "/tmp/editor-tests-XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    tempDir = dir;
+
+    struct {
+        const char* name;
+        void (*run)();
+    } tests[] = {
+        {"journal: record", testJournalRecords},
+        {"journal: recovery", testJournalRecovery},
+        {"linestore", testLineStore},
+        {"lz", testLz},
+        {"diff", testDiff},
+        {"transform", testTransform},
+        {"native", testNativeRoundTrip},
+        {"format", testFormatStats},
+        {"utf8", testUtf8},
+        {"crdt", testCrdt},
+        {"input", testInputDecoder},
+        {"syntax cache", testSyntaxCache},
+        {"multi-kursor undo", testMultiCursorUndo},
+        {"manualstack", testManualStack},
+        {"wordlist", testWordListOwnership},
+        {"export", testExport},
+        {"collab", testCollab},
+        {"follow", testFollowAppend},
+    };
+    for (auto& test : tests) {
+        int before = failures;
+        test.run();
+        cout << (failures == before ? "ok    " : "GAGAL ") << test.name << endl;
+    }
+    string cleanup = "rm -rf " + tempDir;
+    if (system(cleanup.c_str()) != 0)
+        cerr << "gagal menghapus " << tempDir << endl;
+    return failures ? 1 : 0;
+}
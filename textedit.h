@@ -0,0 +1,222 @@
+#ifndef TEXTEDIT_H
+#define TEXTEDIT_H
+
+// Edit teks berbasis offset byte, untuk kolaborasi (OT).
+//
+// Teks dokumen = semua baris digabung dengan '\n' (tanpa '\n' di akhir).
+// Satu EditOp adalah deretan primitive sisip/hapus yang diterapkan
+// berurutan; posisi tiap primitive mengacu ke teks setelah primitive
+// sebelumnya. Menggabungkan dua operasi cukup dengan menyambung vector-nya.
+//
+// transform(a, b): a dan b dibuat bersamaan dari teks yang sama. Hasilnya
+// a' dan b' sehingga teks + a + b' == teks + b + a'. Sisipan di posisi yang
+// sama: milik a di depan (server memberi a prioritas karena urutannya lebih
+// dulu). Hapus yang menimpa sisipan dipecah dua supaya sisipannya tetap ada.
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "journal.h"
+
+struct TextEdit {
+    bool insert = false;
+    uint64_t pos = 0;
+    uint64_t len = 0;   // panjang yang dihapus (hapus)
+    std::string text;   // teks yang disisipkan (sisip)
+
+    static TextEdit insertion(uint64_t pos, std::string text) {
+        TextEdit e;
+        e.insert = true;
+        e.pos = pos;
+        e.text = std::move(text);
+        return e;
+    }
+
+    static TextEdit deletion(uint64_t pos, uint64_t len) {
+        TextEdit e;
+        e.pos = pos;
+        e.len = len;
+        return e;
+    }
+
+    bool empty() const {
+        return insert ? text.empty() : len == 0;
+    }
+};
+
+using EditOp = std::vector<TextEdit>;
+
+inline void editPutU64(std::string& out, uint64_t v) {
+    journalPutU32(out, (uint32_t)v);
+    journalPutU32(out, (uint32_t)(v >> 32));
+}
+
+inline uint64_t editGetU64(const char* p) {
+    return journalGetU32(p) | ((uint64_t)journalGetU32(p + 4) << 32);
+}
+
+// Format: count(u32), lalu tiap edit: kind(u8) pos(u64) lalu len(u64) untuk
+// hapus atau panjang(u32) + teks untuk sisip
+inline void encodeEdits(std::string& out, const EditOp& op) {
+    journalPutU32(out, (uint32_t)op.size());
+    for (const TextEdit& e : op) {
+        out += (char)(e.insert ? 1 : 0);
+        editPutU64(out, e.pos);
+        if (e.insert) {
+            journalPutU32(out, (uint32_t)e.text.size());
+            out += e.text;
+        } else {
+            editPutU64(out, e.len);
+        }
+    }
+}
+
+// false jika data terpotong atau rusak
+inline bool decodeEdits(const char* p, size_t n, EditOp& op, size_t* used = nullptr) {
+    const char* start = p;
+    const char* end = p + n;
+    op.clear();
+    if (end - p < 4) return false;
+    uint32_t count = journalGetU32(p);
+    p += 4;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (end - p < 9) return false;
+        TextEdit e;
+        e.insert = p[0] == 1;
+        e.pos = editGetU64(p + 1);
+        p += 9;
+        if (e.insert) {
+            if (end - p < 4) return false;
+            uint32_t len = journalGetU32(p);
+            p += 4;
+            if ((size_t)(end - p) < len) return false;
+            e.text.assign(p, len);
+            p += len;
+        } else {
+            if (end - p < 8) return false;
+            e.len = editGetU64(p);
+            p += 8;
+        }
+        op.push_back(std::move(e));
+    }
+    if (used) *used = p - start;
+    return true;
+}
+
+// Geser posisi (mis. kursor) melewati satu edit. Posisi tepat di titik
+// sisip tetap di depan sisipan.
+inline uint64_t mapPosition(uint64_t pos, const TextEdit& e) {
+    if (e.insert)
+        return pos > e.pos ? pos + e.text.size() : pos;
+    if (pos <= e.pos) return pos;
+    return pos >= e.pos + e.len ? pos - e.len : e.pos;
+}
+
+namespace editdetail {
+
+inline void push(EditOp& out, TextEdit e) {
+    if (!e.empty()) out.push_back(std::move(e));
+}
+
+// Transform dua primitive; a menang kalau sama-sama sisip di posisi sama
+inline void transformOne(const TextEdit& a, const TextEdit& b, EditOp& outA, EditOp& outB) {
+    if (a.insert && b.insert) {
+        if (a.pos <= b.pos) {
+            push(outA, a);
+            push(outB, TextEdit::insertion(b.pos + a.text.size(), b.text));
+        } else {
+            push(outA, TextEdit::insertion(a.pos + b.text.size(), a.text));
+            push(outB, b);
+        }
+    } else if (a.insert) {
+        uint64_t n = a.text.size();
+        if (a.pos <= b.pos) {
+            push(outA, a);
+            push(outB, TextEdit::deletion(b.pos + n, b.len));
+        } else if (a.pos >= b.pos + b.len) {
+            push(outA, TextEdit::insertion(a.pos - b.len, a.text));
+            push(outB, b);
+        } else { // sisip di tengah rentang hapus: hapus dipecah di sekelilingnya
+            push(outA, TextEdit::insertion(b.pos, a.text));
+            push(outB, TextEdit::deletion(b.pos, a.pos - b.pos));
+            push(outB, TextEdit::deletion(b.pos + n, b.pos + b.len - a.pos));
+        }
+    } else if (b.insert) {
+        uint64_t n = b.text.size();
+        if (b.pos <= a.pos) {
+            push(outA, TextEdit::deletion(a.pos + n, a.len));
+            push(outB, b);
+        } else if (b.pos >= a.pos + a.len) {
+            push(outA, a);
+            push(outB, TextEdit::insertion(b.pos - a.len, b.text));
+        } else {
+            push(outA, TextEdit::deletion(a.pos, b.pos - a.pos));
+            push(outA, TextEdit::deletion(a.pos + n, a.pos + a.len - b.pos));
+            push(outB, TextEdit::insertion(a.pos, b.text));
+        }
+    } else { // dua hapus: bagian yang tumpang tindih cukup dihapus sekali
+        if (a.pos + a.len <= b.pos) {
+            push(outA, a);
+            push(outB, TextEdit::deletion(b.pos - a.len, b.len));
+        } else if (b.pos + b.len <= a.pos) {
+            push(outA, TextEdit::deletion(a.pos - b.len, a.len));
+            push(outB, b);
+        } else {
+            uint64_t overlap = std::min(a.pos + a.len, b.pos + b.len) - std::max(a.pos, b.pos);
+            uint64_t start = std::min(a.pos, b.pos);
+            push(outA, TextEdit::deletion(start, a.len - overlap));
+            push(outB, TextEdit::deletion(start, b.len - overlap));
+        }
+    }
+}
+
+// Deretan primitive: a[0] ditransform terhadap seluruh b dulu, sisanya
+// terhadap b yang sudah digeser a[0]
+inline void transformList(const TextEdit* a, size_t na, const TextEdit* b, size_t nb, EditOp& outA, EditOp& outB) {
+    if (na == 0 || nb == 0) {
+        outA.insert(outA.end(), a, a + na);
+        outB.insert(outB.end(), b, b + nb);
+        return;
+    }
+    if (na == 1 && nb == 1) {
+        transformOne(a[0], b[0], outA, outB);
+        return;
+    }
+    EditOp firstA, firstB, restA, restB;
+    if (na > 1) {
+        transformList(a, 1, b, nb, firstA, firstB);
+        transformList(a + 1, na - 1, firstB.data(), firstB.size(), restA, restB);
+        outA.insert(outA.end(), firstA.begin(), firstA.end());
+        outA.insert(outA.end(), restA.begin(), restA.end());
+        outB.insert(outB.end(), restB.begin(), restB.end());
+    } else {
+        transformList(a, 1, b, 1, firstA, firstB);
+        transformList(firstA.data(), firstA.size(), b + 1, nb - 1, restA, restB);
+        outA.insert(outA.end(), restA.begin(), restA.end());
+        outB.insert(outB.end(), firstB.begin(), firstB.end());
+        outB.insert(outB.end(), restB.begin(), restB.end());
+    }
+}
+
+} // namespace editdetail
+
+inline void transform(EditOp& a, EditOp& b) {
+    EditOp outA, outB;
+    editdetail::transformList(a.data(), a.size(), b.data(), b.size(), outA, outB);
+    a.swap(outA);
+    b.swap(outB);
+}
+
+// Terapkan ke std::string (untuk teks kecil dan pengecekan)
+inline void applyEdits(std::string& text, const EditOp& op) {
+    for (const TextEdit& e : op) {
+        uint64_t pos = std::min<uint64_t>(e.pos, text.size());
+        if (e.insert)
+            text.insert(pos, e.text);
+        else
+            text.erase(pos, std::min<uint64_t>(e.len, text.size() - pos));
+    }
+}
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// Thread pool kecil untuk pekerjaan berat editor (simpan + fsync, tokenize
+// highlight seluruh file) supaya loop input tidak pernah menunggu.
+//
+// Setiap worker punya deque sendiri; tugas baru dibagi bergiliran, worker
+// mengambil dari depan deque-nya, dan worker yang menganggur mencuri dari
+// belakang deque worker lain. Tugas bisa dibatalkan lewat CancelToken:
+// tugas yang belum mulai dilewati, tugas yang sedang jalan diharapkan
+// memeriksa cancelled() secara berkala.
+//
+// Hasil tidak pernah menyentuh state editor dari thread worker: worker
+// mengirim closure lewat post() ke antrean MPSC lock-free, lalu thread
+// utama menjalankannya di runCompletions(). eventfd completionFd() jadi
+// readable setiap ada hasil baru, jadi bisa ikut di-poll bersama stdin.
+
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+class CancelToken {
+public:
+    void cancel() {
+        flag.store(true, std::memory_order_relaxed);
+    }
+
+    bool cancelled() const {
+        return flag.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> flag{false};
+};
+
+// Antrean multi-producer single-consumer tanpa lock (Vyukov): push dari
+// thread mana saja, pop hanya dari satu thread
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(new Node), tail(head.load()) {}
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {}
+        delete tail;
+    }
+
+    void push(T value) {
+        Node* node = new Node;
+        node->value = std::move(value);
+        Node* prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    bool pop(T& value) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        value = std::move(next->value);
+        delete tail;
+        tail = next; // next jadi node kosong yang baru
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    std::atomic<Node*> head; // node terakhir yang di-push
+    Node* tail;              // node kosong sebelum elemen pertama
+};
+
+class ThreadPool {
+public:
+    using Job = std::function<void(const CancelToken&)>;
+
+    explicit ThreadPool(size_t threads = defaultThreads()) {
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        for (size_t i = 0; i < threads; ++i)
+            workers.emplace_back(new Worker);
+        for (size_t i = 0; i < threads; ++i)
+            workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Tugas yang sudah masuk antrean tetap diselesaikan (mis. simpan file)
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker->thread.join();
+        if (wakeFd >= 0) ::close(wakeFd);
+    }
+
+    static size_t defaultThreads() {
+        size_t cores = std::thread::hardware_concurrency();
+        return cores > 2 ? std::min<size_t>(cores - 1, 4) : 1;
+    }
+
+    std::shared_ptr<CancelToken> submit(Job job) {
+        auto token = std::make_shared<CancelToken>();
+        Worker& worker = *workers[nextWorker++ % workers.size()];
+        {
+            // Dihitung sebelum masuk deque, supaya queued tidak pernah negatif
+            std::lock_guard<std::mutex> guard(sleepLock);
+            queued++;
+        }
+        {
+            std::lock_guard<std::mutex> guard(worker.lock);
+            worker.tasks.push_back({std::move(job), token});
+        }
+        wake.notify_one();
+        return token;
+    }
+
+    // Dari worker: jalankan `done` di thread utama
+    void post(std::function<void()> done) {
+        completions.push(std::move(done));
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) {}
+    }
+
+    int completionFd() const {
+        return wakeFd;
+    }
+
+    // Jalankan semua hasil yang sudah dikirim worker (thread utama saja)
+    size_t runCompletions() {
+        uint64_t count;
+        if (read(wakeFd, &count, sizeof(count)) < 0) {}
+        size_t ran = 0;
+        std::function<void()> done;
+        while (completions.pop(done)) {
+            done();
+            ran++;
+        }
+        return ran;
+    }
+
+    // Tunggu sampai semua tugas selesai (mis. sebelum simpan sinkron saat keluar)
+    void drain() {
+        std::unique_lock<std::mutex> guard(sleepLock);
+        idle.wait(guard, [this] { return queued == 0 && running == 0; });
+    }
+
+    size_t threadCount() const {
+        return workers.size();
+    }
+
+private:
+    struct Task {
+        Job job;
+        std::shared_ptr<CancelToken> token;
+    };
+
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> nextWorker{0};
+    MpscQueue<std::function<void()>> completions;
+    int wakeFd = -1;
+
+    std::mutex sleepLock;              // menjaga queued, running, stopping
+    std::condition_variable wake;      // ada tugas baru / berhenti
+    std::condition_variable idle;      // semua tugas selesai
+    size_t queued = 0;
+    size_t running = 0;
+    bool stopping = false;
+
+    // Ambil tugas dari deque sendiri, kalau kosong curi dari worker lain
+    bool take(size_t self, Task& task) {
+        for (size_t k = 0; k < workers.size(); ++k) {
+            Worker& worker = *workers[(self + k) % workers.size()];
+            std::lock_guard<std::mutex> guard(worker.lock);
+            if (worker.tasks.empty()) continue;
+            if (k == 0) {
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+            } else {
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void run(size_t self) {
+        // Sinyal selalu ditangani thread utama (signalfd di event loop)
+        sigset_t all;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, nullptr);
+        for (;;) {
+            Task task;
+            if (!take(self, task)) {
+                std::unique_lock<std::mutex> guard(sleepLock);
+                if (stopping && queued == 0) return;
+                wake.wait(guard, [this] { return queued > 0 || stopping; });
+                if (stopping && queued == 0) return;
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                queued--;
+                running++;
+            }
+            if (!task.token->cancelled())
+                task.job(*task.token);
+            task = Task();
+            {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                running--;
+                if (queued == 0 && running == 0)
+                    idle.notify_all();
+            }
+        }
+    }
+};
+
+#endif
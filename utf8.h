@@ -0,0 +1,497 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+// Lapisan UTF-8 untuk kursor dan hapus karakter.
+//
+// - isAscii()/validateUtf8(): cek 16 byte sekaligus dengan SSE2 (fallback
+//   8 byte per word), byte multi-byte baru divalidasi satu per satu.
+//   repairUtf8() dipakai untuk teks yang masuk dari luar (file, paste).
+// - nextGrapheme()/prevGrapheme(): batas grapheme cluster (subset UAX #29:
+//   CR LF, combining mark, ZWJ emoji, bendera regional indicator, Hangul),
+//   jadi "é" yang ditulis e + U+0301 atau emoji keluarga dihapus sekaligus.
+// - displayWidth(): lebar kolom terminal dari tabel dua tingkat (blok 256
+//   code point, 2 bit per code point, blok yang sama dipakai bersama).
+//
+// Semua fungsi punya jalur cepat untuk teks ASCII murni.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+inline bool isAscii(const char* p, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(p + i));
+        if (_mm_movemask_epi8(chunk) != 0)
+            return false;
+    }
+#else
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, 8);
+        if (word & 0x8080808080808080ull)
+            return false;
+    }
+#endif
+    for (; i < n; ++i)
+        if ((unsigned char)p[i] & 0x80)
+            return false;
+    return true;
+}
+
+inline bool isAscii(std::string_view s) {
+    return isAscii(s.data(), s.size());
+}
+
+// Panjang sequence UTF-8 valid di p (1-4), atau 0 jika tidak valid
+inline size_t utf8SequenceLength(const unsigned char* p, size_t avail) {
+    unsigned char c = p[0];
+    if (c < 0x80) return 1;
+    if (c < 0xc2) return 0; // continuation byte atau overlong 2 byte
+    if (c < 0xe0) {
+        return (avail >= 2 && (p[1] & 0xc0) == 0x80) ? 2 : 0;
+    }
+    if (c < 0xf0) {
+        if (avail < 3 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80) return 0;
+        if (c == 0xe0 && p[1] < 0xa0) return 0; // overlong
+        if (c == 0xed && p[1] >= 0xa0) return 0; // surrogate
+        return 3;
+    }
+    if (c < 0xf5) {
+        if (avail < 4 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80 || (p[3] & 0xc0) != 0x80) return 0;
+        if (c == 0xf0 && p[1] < 0x90) return 0; // overlong
+        if (c == 0xf4 && p[1] >= 0x90) return 0; // > U+10FFFF
+        return 4;
+    }
+    return 0;
+}
+
+inline bool validateUtf8(std::string_view s) {
+    const unsigned char* p = (const unsigned char*)s.data();
+    size_t n = s.size(), i = 0;
+    while (i < n) {
+        // Lompati blok ASCII 16 byte sekaligus
+        if (i + 16 <= n && isAscii((const char*)p + i, 16)) {
+            i += 16;
+            continue;
+        }
+        size_t len = utf8SequenceLength(p + i, n - i);
+        if (len == 0) return false;
+        i += len;
+    }
+    return true;
+}
+
+// Ganti tiap byte yang bukan bagian dari sequence valid dengan U+FFFD (sama
+// seperti decodeUtf8 membacanya). true jika ada yang diganti.
+inline bool repairUtf8(std::string& s) {
+    if (validateUtf8(s)) return false;
+    const unsigned char* p = (const unsigned char*)s.data();
+    size_t n = s.size();
+    std::string out;
+    out.reserve(n + 16);
+    for (size_t i = 0; i < n;) {
+        size_t len = utf8SequenceLength(p + i, n - i);
+        if (len == 0) {
+            out += "\xef\xbf\xbd";
+            i++;
+        } else {
+            out.append((const char*)p + i, len);
+            i += len;
+        }
+    }
+    s.swap(out);
+    return true;
+}
+
+// Decode satu code point mulai dari pos; byte tidak valid dibaca sebagai
+// U+FFFD selebar 1 byte supaya kursor tetap bisa melewatinya
+inline uint32_t decodeUtf8(std::string_view s, size_t pos, size_t* length) {
+    const unsigned char* p = (const unsigned char*)s.data() + pos;
+    size_t len = utf8SequenceLength(p, s.size() - pos);
+    if (length) *length = len ? len : 1;
+    switch (len) {
+    case 1: return p[0];
+    case 2: return ((p[0] & 0x1fu) << 6) | (p[1] & 0x3fu);
+    case 3: return ((p[0] & 0x0fu) << 12) | ((p[1] & 0x3fu) << 6) | (p[2] & 0x3fu);
+    case 4: return ((p[0] & 0x07u) << 18) | ((p[1] & 0x3fu) << 12) | ((p[2] & 0x3fu) << 6) | (p[3] & 0x3fu);
+    default: return 0xfffd;
+    }
+}
+
+// Awal code point yang berakhir tepat sebelum pos
+inline size_t utf8PrevStart(std::string_view s, size_t pos) {
+    size_t start = pos - 1;
+    size_t limit = pos >= 4 ? pos - 4 : 0;
+    while (start > limit && ((unsigned char)s[start] & 0xc0) == 0x80)
+        start--;
+    size_t len;
+    decodeUtf8(s, start, &len);
+    return start + len == pos ? start : pos - 1;
+}
+
+struct CodepointRange {
+    uint32_t first;
+    uint32_t last;
+};
+
+inline bool inRanges(uint32_t cp, const CodepointRange* ranges, size_t count) {
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (cp > ranges[mid].last) lo = mid + 1;
+        else if (cp < ranges[mid].first) hi = mid;
+        else return true;
+    }
+    return false;
+}
+
+// Combining mark dan format character: lebar 0, dan menempel ke grapheme sebelumnya
+static const CodepointRange UTF8_COMBINING[] = {
+    {0x0300, 0x036f}, {0x0483, 0x0489}, {0x0591, 0x05bd}, {0x05bf, 0x05bf},
+    {0x05c1, 0x05c2}, {0x05c4, 0x05c5}, {0x05c7, 0x05c7}, {0x0610, 0x061a},
+    {0x064b, 0x065f}, {0x0670, 0x0670}, {0x06d6, 0x06dc}, {0x06df, 0x06e4},
+    {0x06e7, 0x06e8}, {0x06ea, 0x06ed}, {0x0711, 0x0711}, {0x0730, 0x074a},
+    {0x07a6, 0x07b0}, {0x07eb, 0x07f3}, {0x0816, 0x082d}, {0x0859, 0x085b},
+    {0x08d3, 0x08ff}, {0x0900, 0x0902}, {0x093a, 0x093a}, {0x093c, 0x093c},
+    {0x0941, 0x0948}, {0x094d, 0x094d}, {0x0951, 0x0957}, {0x0962, 0x0963},
+    {0x0981, 0x0981}, {0x09bc, 0x09bc}, {0x09c1, 0x09c4}, {0x09cd, 0x09cd},
+    {0x09e2, 0x09e3}, {0x0a01, 0x0a02}, {0x0a3c, 0x0a3c}, {0x0a41, 0x0a51},
+    {0x0a70, 0x0a71}, {0x0a75, 0x0a75}, {0x0a81, 0x0a82}, {0x0abc, 0x0abc},
+    {0x0ac1, 0x0ac8}, {0x0acd, 0x0acd}, {0x0ae2, 0x0ae3}, {0x0b01, 0x0b01},
+    {0x0b3c, 0x0b3c}, {0x0b3f, 0x0b3f}, {0x0b41, 0x0b44}, {0x0b4d, 0x0b4d},
+    {0x0b82, 0x0b82}, {0x0bc0, 0x0bc0}, {0x0bcd, 0x0bcd}, {0x0c3e, 0x0c40},
+    {0x0c46, 0x0c56}, {0x0cbc, 0x0cbc}, {0x0ccc, 0x0ccd}, {0x0d41, 0x0d44},
+    {0x0d4d, 0x0d4d}, {0x0dca, 0x0dca}, {0x0dd2, 0x0dd6}, {0x0e31, 0x0e31},
+    {0x0e34, 0x0e3a}, {0x0e47, 0x0e4e}, {0x0eb1, 0x0eb1}, {0x0eb4, 0x0ebc},
+    {0x0ec8, 0x0ecd}, {0x0f18, 0x0f19}, {0x0f35, 0x0f35}, {0x0f37, 0x0f37},
+    {0x0f39, 0x0f39}, {0x0f71, 0x0f7e}, {0x0f80, 0x0f84}, {0x0f86, 0x0f87},
+    {0x0f8d, 0x0fbc}, {0x102d, 0x1030}, {0x1032, 0x1037}, {0x1039, 0x103a},
+    {0x1160, 0x11ff}, {0x135d, 0x135f}, {0x1712, 0x1714}, {0x17b4, 0x17b5},
+    {0x17b7, 0x17bd}, {0x17c6, 0x17c6}, {0x17c9, 0x17d3}, {0x180b, 0x180d},
+    {0x1a17, 0x1a18}, {0x1ab0, 0x1aff}, {0x1b00, 0x1b03}, {0x1b34, 0x1b34},
+    {0x1b36, 0x1b3a}, {0x1b6b, 0x1b73}, {0x1dc0, 0x1dff}, {0x200b, 0x200f},
+    {0x202a, 0x202e}, {0x2060, 0x2064}, {0x20d0, 0x20f0}, {0x2cef, 0x2cf1},
+    {0x2de0, 0x2dff}, {0x302a, 0x302d}, {0x3099, 0x309a}, {0xa66f, 0xa672},
+    {0xa674, 0xa67d}, {0xa69e, 0xa69f}, {0xa6f0, 0xa6f1}, {0xa8e0, 0xa8f1},
+    {0xd7b0, 0xd7ff}, {0xfb1e, 0xfb1e}, {0xfe00, 0xfe0f}, {0xfe20, 0xfe2f},
+    {0xfeff, 0xfeff}, {0x101fd, 0x101fd}, {0x10a01, 0x10a0f}, {0x10a38, 0x10a3f},
+    {0x11001, 0x11001}, {0x11038, 0x11046}, {0x1d167, 0x1d169}, {0x1d17b, 0x1d182},
+    {0x1d185, 0x1d18b}, {0x1d1aa, 0x1d1ad}, {0x1e8d0, 0x1e8d6}, {0x1f3fb, 0x1f3ff},
+    {0xe0001, 0xe007f}, {0xe0100, 0xe01ef},
+};
+
+// Spacing mark (Mc) yang menempel ke huruf sebelumnya di aksara India dan Thai
+static const CodepointRange UTF8_SPACING_MARK[] = {
+    {0x0903, 0x0903}, {0x093b, 0x093b}, {0x093e, 0x0940}, {0x0949, 0x094c},
+    {0x094e, 0x094f}, {0x0982, 0x0983}, {0x09be, 0x09c0}, {0x09c7, 0x09cc},
+    {0x0a03, 0x0a03}, {0x0a3e, 0x0a40}, {0x0a83, 0x0a83}, {0x0abe, 0x0ac0},
+    {0x0b02, 0x0b03}, {0x0b3e, 0x0b3e}, {0x0b40, 0x0b40}, {0x0b47, 0x0b4c},
+    {0x0bbe, 0x0bbf}, {0x0bc1, 0x0bcc}, {0x0c01, 0x0c03}, {0x0c41, 0x0c44},
+    {0x0c82, 0x0c83}, {0x0cbe, 0x0cc4}, {0x0d02, 0x0d03}, {0x0d3e, 0x0d40},
+    {0x0d46, 0x0d4c}, {0x0d82, 0x0d83}, {0x0dcf, 0x0dd1}, {0x0dd8, 0x0ddf},
+    {0x0e33, 0x0e33}, {0x0eb3, 0x0eb3}, {0x102b, 0x102c}, {0x1031, 0x1031},
+    {0x103b, 0x103c}, {0x17b6, 0x17b6}, {0x17be, 0x17c5},
+};
+
+// East Asian Wide/Fullwidth dan emoji: lebar 2 kolom
+static const CodepointRange UTF8_WIDE[] = {
+    {0x1100, 0x115f}, {0x231a, 0x231b}, {0x2329, 0x232a}, {0x23e9, 0x23ec},
+    {0x23f0, 0x23f0}, {0x23f3, 0x23f3}, {0x25fd, 0x25fe}, {0x2614, 0x2615},
+    {0x2648, 0x2653}, {0x267f, 0x267f}, {0x2693, 0x2693}, {0x26a1, 0x26a1},
+    {0x26aa, 0x26ab}, {0x26bd, 0x26be}, {0x26c4, 0x26c5}, {0x26ce, 0x26ce},
+    {0x26d4, 0x26d4}, {0x26ea, 0x26ea}, {0x26f2, 0x26f3}, {0x26f5, 0x26f5},
+    {0x26fa, 0x26fa}, {0x26fd, 0x26fd}, {0x2705, 0x2705}, {0x270a, 0x270b},
+    {0x2728, 0x2728}, {0x274c, 0x274c}, {0x274e, 0x274e}, {0x2753, 0x2755},
+    {0x2757, 0x2757}, {0x2795, 0x2797}, {0x27b0, 0x27b0}, {0x27bf, 0x27bf},
+    {0x2b1b, 0x2b1c}, {0x2b50, 0x2b50}, {0x2b55, 0x2b55}, {0x2e80, 0x303e},
+    {0x3041, 0x33ff}, {0x3400, 0x4dbf}, {0x4e00, 0x9fff}, {0xa000, 0xa4cf},
+    {0xa960, 0xa97f}, {0xac00, 0xd7a3}, {0xf900, 0xfaff}, {0xfe10, 0xfe19},
+    {0xfe30, 0xfe6f}, {0xff00, 0xff60}, {0xffe0, 0xffe6}, {0x16fe0, 0x16fe4},
+    {0x17000, 0x18aff}, {0x1b000, 0x1b2ff}, {0x1f004, 0x1f004}, {0x1f0cf, 0x1f0cf},
+    {0x1f18e, 0x1f18e}, {0x1f191, 0x1f19a}, {0x1f1e6, 0x1f1ff}, {0x1f200, 0x1f202},
+    {0x1f210, 0x1f23b}, {0x1f240, 0x1f248}, {0x1f250, 0x1f251}, {0x1f260, 0x1f265},
+    {0x1f300, 0x1f320}, {0x1f32d, 0x1f335}, {0x1f337, 0x1f37c}, {0x1f37e, 0x1f393},
+    {0x1f3a0, 0x1f3ca}, {0x1f3cf, 0x1f3d3}, {0x1f3e0, 0x1f3f0}, {0x1f3f4, 0x1f3f4},
+    {0x1f3f8, 0x1f43e}, {0x1f440, 0x1f440}, {0x1f442, 0x1f4fc}, {0x1f4ff, 0x1f53d},
+    {0x1f54b, 0x1f54e}, {0x1f550, 0x1f567}, {0x1f57a, 0x1f57a}, {0x1f595, 0x1f596},
+    {0x1f5a4, 0x1f5a4}, {0x1f5fb, 0x1f64f}, {0x1f680, 0x1f6c5}, {0x1f6cc, 0x1f6cc},
+    {0x1f6d0, 0x1f6d2}, {0x1f6d5, 0x1f6d7}, {0x1f6eb, 0x1f6ec}, {0x1f6f4, 0x1f6fc},
+    {0x1f7e0, 0x1f7eb}, {0x1f90c, 0x1f93a}, {0x1f93c, 0x1f945}, {0x1f947, 0x1f9ff},
+    {0x1fa70, 0x1faff}, {0x20000, 0x2fffd}, {0x30000, 0x3fffd},
+};
+
+// Extended_Pictographic (perkiraan): bagian dari urutan emoji ZWJ
+static const CodepointRange UTF8_PICTOGRAPHIC[] = {
+    {0x00a9, 0x00a9}, {0x00ae, 0x00ae}, {0x203c, 0x203c}, {0x2049, 0x2049},
+    {0x2122, 0x2122}, {0x2139, 0x2139}, {0x2194, 0x21aa}, {0x231a, 0x23ff},
+    {0x24c2, 0x24c2}, {0x25aa, 0x27bf}, {0x2934, 0x2935}, {0x2b05, 0x2b55},
+    {0x3030, 0x3030}, {0x303d, 0x303d}, {0x3297, 0x3297}, {0x3299, 0x3299},
+    {0x1f000, 0x1f1e5}, {0x1f200, 0x1f3fa}, {0x1f400, 0x1faff},
+};
+
+template<size_t N>
+inline bool inTable(uint32_t cp, const CodepointRange (&table)[N]) {
+    return inRanges(cp, table, N);
+}
+
+// Tabel lebar dua tingkat: stage1[cp >> 8] memilih blok 256 code point,
+// tiap blok menyimpan lebar 0/1/2 sebagai 2 bit. Blok yang isinya sama
+// (mis. semua lebar 1, atau semua CJK lebar 2) hanya disimpan sekali.
+class WidthTable {
+private:
+    static const uint32_t MAX_CP = 0x110000;
+    std::vector<uint16_t> stage1;
+    std::vector<uint64_t> stage2; // 4 word = 256 entri x 2 bit per blok
+
+public:
+    WidthTable() {
+        stage1.resize(MAX_CP >> 8);
+        std::vector<uint64_t> block(8);
+        for (uint32_t base = 0; base < MAX_CP; base += 256) {
+            for (uint64_t& word : block) word = 0;
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint64_t width = computeWidth(base + i);
+                block[i / 32] |= width << ((i % 32) * 2);
+            }
+            // Cari blok yang sama yang sudah ada
+            size_t found = stage2.size() / 8;
+            for (size_t b = 0; b * 8 < stage2.size(); ++b) {
+                if (std::equal(block.begin(), block.end(), stage2.begin() + b * 8)) {
+                    found = b;
+                    break;
+                }
+            }
+            if (found * 8 == stage2.size())
+                stage2.insert(stage2.end(), block.begin(), block.end());
+            stage1[base >> 8] = (uint16_t)found;
+        }
+    }
+
+    int width(uint32_t cp) const {
+        if (cp >= MAX_CP) return 1;
+        uint64_t word = stage2[(size_t)stage1[cp >> 8] * 8 + (cp & 0xff) / 32];
+        return (int)((word >> ((cp % 32) * 2)) & 3);
+    }
+
+    size_t bytes() const {
+        return stage1.size() * sizeof(uint16_t) + stage2.size() * sizeof(uint64_t);
+    }
+
+    static int computeWidth(uint32_t cp) {
+        if (cp < 0x20 || (cp >= 0x7f && cp < 0xa0)) return 0;
+        if (inTable(cp, UTF8_COMBINING)) return 0;
+        if (inTable(cp, UTF8_WIDE)) return 2;
+        return 1;
+    }
+};
+
+inline const WidthTable& widthTable() {
+    static const WidthTable table;
+    return table;
+}
+
+inline int codepointWidth(uint32_t cp) {
+    if (cp >= 0x20 && cp < 0x7f) return 1;
+    return widthTable().width(cp);
+}
+
+enum GraphemeClass : uint8_t {
+    GC_OTHER, GC_CR, GC_LF, GC_CONTROL, GC_EXTEND, GC_ZWJ, GC_SPACING_MARK,
+    GC_REGIONAL, GC_L, GC_V, GC_T, GC_LV, GC_LVT, GC_PICTOGRAPHIC
+};
+
+inline GraphemeClass graphemeClass(uint32_t cp) {
+    if (cp < 0x80) {
+        if (cp == '\r') return GC_CR;
+        if (cp == '\n') return GC_LF;
+        if (cp < 0x20 || cp == 0x7f) return GC_CONTROL;
+        return GC_OTHER;
+    }
+    if (cp == 0x200d) return GC_ZWJ;
+    if (cp >= 0x1f1e6 && cp <= 0x1f1ff) return GC_REGIONAL;
+    if ((cp >= 0x1100 && cp <= 0x115f) || (cp >= 0xa960 && cp <= 0xa97c)) return GC_L;
+    if ((cp >= 0x1160 && cp <= 0x11a7) || (cp >= 0xd7b0 && cp <= 0xd7c6)) return GC_V;
+    if ((cp >= 0x11a8 && cp <= 0x11ff) || (cp >= 0xd7cb && cp <= 0xd7fb)) return GC_T;
+    if (cp >= 0xac00 && cp <= 0xd7a3) return (cp - 0xac00) % 28 == 0 ? GC_LV : GC_LVT;
+    if (cp == 0x200b || cp == 0xfeff || (cp >= 0x2028 && cp <= 0x202e)) return GC_CONTROL;
+    if (inTable(cp, UTF8_COMBINING)) return GC_EXTEND;
+    if (inTable(cp, UTF8_SPACING_MARK)) return GC_SPACING_MARK;
+    if (inTable(cp, UTF8_PICTOGRAPHIC)) return GC_PICTOGRAPHIC;
+    return GC_OTHER;
+}
+
+// State yang dibawa saat menyusuri satu grapheme (untuk ZWJ emoji dan bendera)
+struct GraphemeState {
+    GraphemeClass prev = GC_OTHER;
+    bool emojiBase = false;   // sudah ada pictographic, boleh disambung ZWJ
+    int regionalCount = 0;    // regional indicator berturut-turut
+};
+
+// true jika ada batas grapheme di antara prev dan next
+inline bool isGraphemeBreak(GraphemeState& st, GraphemeClass next) {
+    GraphemeClass prev = st.prev;
+    bool brk;
+    if (prev == GC_CR && next == GC_LF) brk = false;
+    else if (prev == GC_CR || prev == GC_LF || prev == GC_CONTROL) brk = true;
+    else if (next == GC_CR || next == GC_LF || next == GC_CONTROL) brk = true;
+    else if (prev == GC_L && (next == GC_L || next == GC_V || next == GC_LV || next == GC_LVT)) brk = false;
+    else if ((prev == GC_LV || prev == GC_V) && (next == GC_V || next == GC_T)) brk = false;
+    else if ((prev == GC_LVT || prev == GC_T) && next == GC_T) brk = false;
+    else if (next == GC_EXTEND || next == GC_ZWJ || next == GC_SPACING_MARK) brk = false;
+    else if (prev == GC_ZWJ && next == GC_PICTOGRAPHIC && st.emojiBase) brk = false;
+    else if (prev == GC_REGIONAL && next == GC_REGIONAL && st.regionalCount % 2 == 1) brk = false;
+    else brk = true;
+
+    if (brk) {
+        st.emojiBase = false;
+        st.regionalCount = 0;
+    }
+    if (next == GC_PICTOGRAPHIC) st.emojiBase = true;
+    else if (next != GC_EXTEND && next != GC_ZWJ) st.emojiBase = false;
+    st.regionalCount = next == GC_REGIONAL ? st.regionalCount + 1 : 0;
+    st.prev = next;
+    return brk;
+}
+
+// Akhir grapheme yang dimulai di pos
+inline size_t nextGrapheme(std::string_view s, size_t pos) {
+    if (pos >= s.size()) return s.size();
+    unsigned char c = (unsigned char)s[pos];
+    // Jalur cepat ASCII: karakter ASCII yang diikuti ASCII selalu 1 grapheme
+    if (c < 0x80 && c != '\r' && (pos + 1 == s.size() || (unsigned char)s[pos + 1] < 0x80))
+        return pos + 1;
+
+    size_t len;
+    GraphemeState st;
+    isGraphemeBreak(st, graphemeClass(decodeUtf8(s, pos, &len)));
+    pos += len;
+    while (pos < s.size()) {
+        uint32_t cp = decodeUtf8(s, pos, &len);
+        if (isGraphemeBreak(st, graphemeClass(cp)))
+            break;
+        pos += len;
+    }
+    return pos;
+}
+
+const size_t GRAPHEME_SCAN_MAX = 128;
+
+// Awal grapheme yang berakhir tepat di pos
+inline size_t prevGrapheme(std::string_view s, size_t pos) {
+    if (pos == 0) return 0;
+    unsigned char c = (unsigned char)s[pos - 1];
+    // Jalur cepat ASCII: code point terakhir ASCII berarti grapheme 1 byte
+    // (kecuali CR LF yang dihitung satu grapheme)
+    if (c < 0x80 && !(c == '\n' && pos >= 2 && s[pos - 2] == '\r'))
+        return pos - 1;
+
+    // Mundur sampai code point yang pasti bisa jadi awal grapheme, lalu
+    // maju dengan nextGrapheme() sampai mencapai pos. Mundurnya dibatasi
+    // GRAPHEME_SCAN_MAX code point, supaya deretan panjang bendera atau ZWJ
+    // tidak membuat backspace berulang O(n^2); batasnya genap, jadi pasangan
+    // regional indicator tetap dihitung dari pos.
+    size_t start = pos;
+    for (size_t steps = 0; start > 0 && steps < GRAPHEME_SCAN_MAX; ++steps) {
+        start = utf8PrevStart(s, start);
+        GraphemeClass gc = graphemeClass(decodeUtf8(s, start, nullptr));
+        bool maybeContinuation = gc == GC_EXTEND || gc == GC_ZWJ || gc == GC_SPACING_MARK ||
+                                 gc == GC_V || gc == GC_T || gc == GC_REGIONAL ||
+                                 gc == GC_PICTOGRAPHIC || gc == GC_LF ||
+                                 gc == GC_LV || gc == GC_LVT;
+        if (!maybeContinuation) break;
+    }
+    size_t boundary = start;
+    while (true) {
+        size_t next = nextGrapheme(s, boundary);
+        if (next >= pos) return boundary;
+        boundary = next;
+    }
+}
+
+// Lebar kolom satu grapheme: lebar code point pertama, atau 2 jika emoji
+// dengan presentasi emoji (VS16)
+inline int graphemeWidth(std::string_view s, size_t start, size_t end) {
+    size_t len;
+    uint32_t cp = decodeUtf8(s, start, &len);
+    int width = codepointWidth(cp);
+    for (size_t pos = start + len; pos < end; pos += len) {
+        cp = decodeUtf8(s, pos, &len);
+        if (cp == 0xfe0f && width == 1) width = 2;
+    }
+    return width;
+}
+
+inline size_t displayWidth(std::string_view s) {
+    if (isAscii(s)) {
+        size_t width = 0;
+        for (unsigned char c : s)
+            width += (c >= 0x20 && c < 0x7f) ? 1 : 0;
+        return width;
+    }
+    size_t width = 0;
+    for (size_t pos = 0; pos < s.size();) {
+        size_t end = nextGrapheme(s, pos);
+        width += graphemeWidth(s, pos, end);
+        pos = end;
+    }
+    return width;
+}
+
+// Offset byte pada kolom tampilan `column` (dibulatkan ke awal grapheme)
+inline size_t offsetAtColumn(std::string_view s, size_t column) {
+    if (isAscii(s)) return std::min(column, s.size());
+    size_t width = 0, pos = 0;
+    while (pos < s.size()) {
+        size_t end = nextGrapheme(s, pos);
+        width += graphemeWidth(s, pos, end);
+        if (width > column) break;
+        pos = end;
+    }
+    return pos;
+}
+
+// Pemisah kata: spasi Unicode dan tanda baca CJK (teks CJK tidak memakai spasi)
+inline bool isWordSeparator(uint32_t cp) {
+    return cp == ' ' || cp == '\t' || cp == 0xa0 || cp == 0x1680 ||
+           (cp >= 0x2000 && cp <= 0x200a) || cp == 0x202f || cp == 0x205f ||
+           cp == 0x3000 || cp == 0x3001 || cp == 0x3002 || cp == 0xff0c || cp == 0xff0e;
+}
+
+// Awal pemisah kata terakhir sebelum pos, atau npos jika tidak ada
+inline size_t findLastSeparator(std::string_view s, size_t pos) {
+    if (isAscii(s.data(), pos)) {
+        size_t found = s.substr(0, pos).find_last_of(" \t");
+        return found;
+    }
+    while (pos > 0) {
+        size_t start = utf8PrevStart(s, pos);
+        if (isWordSeparator(decodeUtf8(s, start, nullptr)))
+            return start;
+        pos = start;
+    }
+    return std::string_view::npos;
+}
+
+// Backspace di akhir baris: buang satu grapheme utuh
+inline void popGrapheme(std::string& s) {
+    if (!s.empty())
+        s.erase(prevGrapheme(s, s.size()));
+}
+
+// Panjang sequence UTF-8 menurut byte pertamanya (untuk input yang datang per byte)
+inline size_t utf8ExpectedLength(unsigned char lead) {
+    if (lead < 0xc0) return 1;
+    if (lead < 0xe0) return 2;
+    if (lead < 0xf0) return 3;
+    return 4;
+}
+
+#endif
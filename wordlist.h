@@ -0,0 +1,268 @@
+#ifndef WORDLIST_H
+#define WORDLIST_H
+
+// Daftar kata varian ets/bismillah1 sebagai linked list di dalam satu
+// tabel: node disimpan berurutan di vector dan saling menunjuk lewat indeks
+// 32-bit, slot yang dibebaskan masuk free list dan dipakai lagi. Traversal
+// membaca memori yang berdekatan, dan kata terakhir langsung dari `tail`.
+//
+// Riwayat undo/redo menyimpan WordEdit (indeks node + jenis edit), bukan
+// pointer. Node yang sedang terlepas dari daftar (kata yang dihapus, atau
+// input yang di-undo) dimiliki tepat satu WordEdit; kalau record itu
+// dibuang (redo dikosongkan, atau undo lama dibuang ManualStack), node
+// dikembalikan ke free list.
+//
+// TextEditor di bawah dipakai bersama oleh ets.cpp dan bismillah1.cpp.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "manualstack.h"
+
+const uint32_t NO_NODE = 0xffffffffu;
+
+struct WordNode {
+    std::string word;
+    std::string format;
+    uint32_t prev = NO_NODE;
+    uint32_t next = NO_NODE; // di slot bebas: slot bebas berikutnya
+};
+
+class WordList {
+private:
+    std::vector<WordNode> nodes;
+    uint32_t head = NO_NODE;
+    uint32_t tail = NO_NODE;
+    uint32_t freeHead = NO_NODE;
+    size_t linked = 0;
+    size_t freeSlots = 0;
+
+public:
+    // Node baru yang belum masuk daftar
+    uint32_t create(const std::string& word, const std::string& format) {
+        uint32_t i;
+        if (freeHead != NO_NODE) {
+            i = freeHead;
+            freeHead = nodes[i].next;
+            freeSlots--;
+        } else {
+            i = (uint32_t)nodes.size();
+            nodes.emplace_back();
+        }
+        WordNode& node = nodes[i];
+        node.word = word;
+        node.format = format;
+        node.prev = NO_NODE;
+        node.next = NO_NODE;
+        return i;
+    }
+
+    // Kembalikan node yang sudah terlepas ke free list
+    void destroy(uint32_t i) {
+        WordNode& node = nodes[i];
+        std::string().swap(node.word);
+        std::string().swap(node.format);
+        node.prev = NO_NODE;
+        node.next = freeHead;
+        freeHead = i;
+        freeSlots++;
+    }
+
+    void pushBack(uint32_t i) {
+        nodes[i].prev = tail;
+        nodes[i].next = NO_NODE;
+        if (tail != NO_NODE)
+            nodes[tail].next = i;
+        else
+            head = i;
+        tail = i;
+        linked++;
+    }
+
+    void unlink(uint32_t i) {
+        WordNode& node = nodes[i];
+        if (node.prev != NO_NODE)
+            nodes[node.prev].next = node.next;
+        else
+            head = node.next;
+        if (node.next != NO_NODE)
+            nodes[node.next].prev = node.prev;
+        else
+            tail = node.prev;
+        node.prev = NO_NODE;
+        node.next = NO_NODE;
+        linked--;
+    }
+
+    uint32_t front() const {
+        return head;
+    }
+
+    uint32_t back() const {
+        return tail;
+    }
+
+    const WordNode& operator[](uint32_t i) const {
+        return nodes[i];
+    }
+
+    // Jumlah kata di daftar (tidak termasuk node yang terlepas)
+    size_t size() const {
+        return linked;
+    }
+
+    // Node yang dipakai: di daftar, atau terlepas tapi masih dimiliki WordEdit
+    size_t allocated() const {
+        return nodes.size() - freeSlots;
+    }
+};
+
+// Satu langkah undo/redo: kata `node` ditambahkan ke akhir daftar
+// (inserted) atau dihapus dari akhir daftar
+struct WordEdit {
+    uint32_t node = NO_NODE;
+    bool inserted = false;
+};
+
+// Record undo kecil dan bisa di-spill, jadi stack ber-budget biasanya tidak
+// membuang record; kalau terpaksa (spill gagal ditulis atau dibaca), node
+// miliknya dikembalikan lewat ManualStack::onDrop
+template<>
+struct StackTraits<WordEdit> {
+    static const bool spillable = true;
+
+    static size_t bytes(const WordEdit&) {
+        return sizeof(WordEdit);
+    }
+
+    static void encode(std::string& out, const WordEdit& edit) {
+        char b[5];
+        memcpy(b, &edit.node, 4);
+        b[4] = edit.inserted ? 1 : 0;
+        out.append(b, 5);
+    }
+
+    static bool decode(const char*& p, const char* end, WordEdit& edit) {
+        if (end - p < 5) return false;
+        memcpy(&edit.node, p, 4);
+        edit.inserted = p[4] != 0;
+        p += 5;
+        return true;
+    }
+};
+
+// Undo tertua di-spill ke disk begitu stack melewati budget ini
+const size_t UNDO_BUDGET = 1 << 20;
+
+// Text Editor Class
+class TextEditor {
+private:
+    WordList words;
+    ManualStack<WordEdit> undoStack;
+    ManualStack<WordEdit> redoStack;
+    std::ofstream logFile;
+    std::string currentFormat;
+
+public:
+    TextEditor() {
+        currentFormat = "";
+        undoStack.setBudget(UNDO_BUDGET);
+        // Record yang dibuang stack tanpa di-pop melepaskan node miliknya:
+        // di undo itu kata yang dihapus, di redo input yang di-undo
+        undoStack.onDrop = [this](const WordEdit& edit) {
+            if (!edit.inserted) words.destroy(edit.node);
+        };
+        redoStack.onDrop = [this](const WordEdit& edit) {
+            if (edit.inserted) words.destroy(edit.node);
+        };
+        logFile.open(".log.txt", std::ios::app); // hidden log
+    }
+
+    ~TextEditor() {
+        logFile.close();
+    }
+
+    const WordList& wordList() const {
+        return words;
+    }
+
+    void toggleFormat(char fmt) {
+        if (fmt == 'B') currentFormat = "[B]";
+        else if (fmt == 'N') currentFormat = "[I]";
+        else if (fmt == 'M') currentFormat = "[U]";
+        else currentFormat = "";
+    }
+
+    void addInput(const std::string& text) {
+        std::string word = "";
+        for (char ch : text + " ") {
+            if (ch == ' ') {
+                if (!word.empty()) {
+                    uint32_t node = words.create(word, currentFormat);
+                    words.pushBack(node);
+                    undoStack.push({node, true});
+                    log("Input: " + word + " " + currentFormat);
+                    word.clear();
+                }
+            } else {
+                word += ch;
+            }
+        }
+        // Clear redo stack karena input baru
+        clearRedo();
+    }
+
+    // Input yang di-undo masih memegang node yang terlepas: dibebaskan onDrop
+    void clearRedo() {
+        redoStack.clear();
+    }
+
+    void deleteLastWord() {
+        uint32_t last = words.back();
+        if (last == NO_NODE) return;
+        words.unlink(last);
+        undoStack.push({last, false}); // node terlepas sekarang milik record ini
+        clearRedo();
+        log("Delete: " + words[last].word);
+    }
+
+    void undo() {
+        if (undoStack.empty()) return;
+        WordEdit edit = undoStack.top(); undoStack.pop();
+        if (edit.node == NO_NODE) return; // file spill gagal dibaca
+        if (edit.inserted) words.unlink(edit.node);
+        else words.pushBack(edit.node);
+        redoStack.push(edit);
+        log("Undo: " + words[edit.node].word);
+    }
+
+    void redo() {
+        if (redoStack.empty()) return;
+        WordEdit edit = redoStack.top(); redoStack.pop();
+        if (edit.inserted) words.pushBack(edit.node);
+        else words.unlink(edit.node);
+        undoStack.push(edit);
+        log("Redo: " + words[edit.node].word);
+    }
+
+    void displayText() {
+        std::cout << "\nCurrent text: ";
+        for (uint32_t i = words.front(); i != NO_NODE; i = words[i].next)
+            std::cout << words[i].format << words[i].word << " ";
+        std::cout << std::endl;
+    }
+
+    void saveToFile() {
+        log("Saved to file.");
+        std::cout << "\n[SAVED TO .log.txt]\n";
+    }
+
+    void log(const std::string& activity) {
+        logFile << activity << std::endl;
+    }
+};
+
+#endif